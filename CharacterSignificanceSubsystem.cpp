@@ -0,0 +1,226 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CharacterSignificanceSubsystem.h"
+#include "SurvivalGame.h"
+#include "SurvivalCharacter.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("Character Significance Tick"), STAT_CharacterSignificanceTick, STATGROUP_SurvivalGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Characters High Significance"), STAT_CharactersHighSignificance, STATGROUP_SurvivalGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Characters Medium Significance"), STAT_CharactersMediumSignificance, STATGROUP_SurvivalGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Characters Low Significance"), STAT_CharactersLowSignificance, STATGROUP_SurvivalGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Characters Hidden"), STAT_CharactersHidden, STATGROUP_SurvivalGame);
+
+static TAutoConsoleVariable<float> CVarCharacterHighDistance(
+	TEXT("Character.Significance.HighDistance"),
+	1500.f,
+	TEXT("Visible characters closer than this to a local player update every frame."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarCharacterMediumDistance(
+	TEXT("Character.Significance.MediumDistance"),
+	5000.f,
+	TEXT("Visible characters closer than this to a local player animate at medium rate, further ones at low rate."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarCharacterSignificanceBudget(
+	TEXT("Character.Significance.Budget"),
+	20.f,
+	TEXT("How many characters worth of full rate updates we do each frame.  Past this, the least significant characters update less often."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarCharacterRecentlyRenderedTime(
+	TEXT("Character.Significance.RecentlyRenderedTime"),
+	0.25f,
+	TEXT("Characters that haven't been rendered for this many seconds are hidden."),
+	ECVF_Default);
+
+void UCharacterSignificanceSubsystem::Deinitialize()
+{
+	Super::Deinitialize();
+
+	Characters.Empty();
+}
+
+void UCharacterSignificanceSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CharacterSignificanceTick);
+
+	//Everyone a local player is looking from.  Dedicated servers have nobody, so their characters always update fully
+	TArray<FViewer> Viewers;
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+
+		if (PC && PC->IsLocalController())
+		{
+			FRotator ViewRotation;
+			FViewer& Viewer = Viewers.AddDefaulted_GetRef();
+			PC->GetPlayerViewPoint(Viewer.Location, ViewRotation);
+			Viewer.Direction = ViewRotation.Vector();
+			Viewer.ViewTarget = PC->GetViewTarget();
+		}
+	}
+
+	if (!Viewers.Num())
+	{
+		return;
+	}
+
+	Characters.RemoveAllSwap([](const FManagedCharacter& ManagedCharacter) { return !ManagedCharacter.Character.IsValid(); });
+
+	TArray<ECharacterSignificance> Significances;
+	Significances.SetNumUninitialized(Characters.Num());
+
+	float TotalCost = 0.f;
+
+	for (int32 i = 0; i < Characters.Num(); ++i)
+	{
+		Significances[i] = ScoreCharacter(Characters[i], Viewers);
+		TotalCost += GetUpdateCost(Significances[i]);
+	}
+
+	//Over budget, so move the least significant characters down until we fit
+	const float Budget = CVarCharacterSignificanceBudget.GetValueOnGameThread();
+
+	if (TotalCost > Budget)
+	{
+		TArray<int32> Ranking;
+		Ranking.Reserve(Characters.Num());
+		for (int32 i = 0; i < Characters.Num(); ++i)
+		{
+			Ranking.Add(i);
+		}
+
+		Ranking.Sort([this](const int32 A, const int32 B) { return Characters[A].Score > Characters[B].Score; });
+
+		for (int32 Rank = Ranking.Num() - 1; Rank >= 0 && TotalCost > Budget; --Rank)
+		{
+			const int32 i = Ranking[Rank];
+
+			if (Characters[i].bAlwaysSignificant)
+			{
+				continue;
+			}
+
+			//Visible characters keep animating, however far down they go
+			while (TotalCost > Budget && Significances[i] < ECharacterSignificance::Low)
+			{
+				const ECharacterSignificance Lower = (ECharacterSignificance)((uint8)Significances[i] + 1);
+				TotalCost -= GetUpdateCost(Significances[i]) - GetUpdateCost(Lower);
+				Significances[i] = Lower;
+			}
+		}
+	}
+
+	for (int32 i = 0; i < Characters.Num(); ++i)
+	{
+		FManagedCharacter& ManagedCharacter = Characters[i];
+
+		if (ManagedCharacter.Significance != Significances[i])
+		{
+			ManagedCharacter.Significance = Significances[i];
+			ManagedCharacter.Character->SetSignificance(Significances[i]);
+		}
+
+		switch (ManagedCharacter.Significance)
+		{
+		case ECharacterSignificance::High: INC_DWORD_STAT(STAT_CharactersHighSignificance); break;
+		case ECharacterSignificance::Medium: INC_DWORD_STAT(STAT_CharactersMediumSignificance); break;
+		case ECharacterSignificance::Low: INC_DWORD_STAT(STAT_CharactersLowSignificance); break;
+		default: INC_DWORD_STAT(STAT_CharactersHidden); break;
+		}
+	}
+}
+
+bool UCharacterSignificanceSubsystem::IsTickable() const
+{
+	return !IsTemplate() && Characters.Num() > 0;
+}
+
+TStatId UCharacterSignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCharacterSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+UWorld* UCharacterSignificanceSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+void UCharacterSignificanceSubsystem::RegisterCharacter(ASurvivalCharacter* Character)
+{
+	if (Character && !Characters.ContainsByPredicate([Character](const FManagedCharacter& ManagedCharacter) { return ManagedCharacter.Character == Character; }))
+	{
+		FManagedCharacter& ManagedCharacter = Characters.AddDefaulted_GetRef();
+		ManagedCharacter.Character = Character;
+	}
+}
+
+void UCharacterSignificanceSubsystem::UnregisterCharacter(ASurvivalCharacter* Character)
+{
+	Characters.RemoveAllSwap([Character](const FManagedCharacter& ManagedCharacter) { return ManagedCharacter.Character == Character; });
+}
+
+const FCharacterUpdateRate& UCharacterSignificanceSubsystem::GetUpdateRate(const ECharacterSignificance Significance)
+{
+	static const FCharacterUpdateRate UpdateRates[] =
+	{
+		{ 0.f, 0, true },		//High
+		{ 0.f, 1, true },		//Medium
+		{ 0.1f, 3, false },		//Low
+		{ 0.5f, 15, false }		//Hidden
+	};
+
+	return UpdateRates[FMath::Min((int32)Significance, (int32)UE_ARRAY_COUNT(UpdateRates) - 1)];
+}
+
+ECharacterSignificance UCharacterSignificanceSubsystem::ScoreCharacter(FManagedCharacter& ManagedCharacter, const TArray<FViewer>& Viewers) const
+{
+	const ASurvivalCharacter* Character = ManagedCharacter.Character.Get();
+
+	ManagedCharacter.bAlwaysSignificant = Character->IsLocallyControlled();
+
+	float ClosestDistance = BIG_NUMBER;
+	bool bInFront = false;
+
+	for (const FViewer& Viewer : Viewers)
+	{
+		ManagedCharacter.bAlwaysSignificant |= Viewer.ViewTarget == Character;
+
+		const FVector ToCharacter = Character->GetActorLocation() - Viewer.Location;
+		ClosestDistance = FMath::Min(ClosestDistance, ToCharacter.Size());
+		bInFront |= (ToCharacter | Viewer.Direction) > 0.f;
+	}
+
+	if (ManagedCharacter.bAlwaysSignificant)
+	{
+		ManagedCharacter.Score = BIG_NUMBER;
+		return ECharacterSignificance::High;
+	}
+
+	const bool bRendered = Character->WasRecentlyRendered(CVarCharacterRecentlyRenderedTime.GetValueOnGameThread());
+
+	ManagedCharacter.Score = (bRendered ? 1.f : 0.25f) * (bInFront ? 1.f : 0.5f) / FMath::Max(ClosestDistance, 1.f);
+
+	if (!bRendered)
+	{
+		return ECharacterSignificance::Hidden;
+	}
+
+	if (ClosestDistance < CVarCharacterHighDistance.GetValueOnGameThread())
+	{
+		return ECharacterSignificance::High;
+	}
+
+	return ClosestDistance < CVarCharacterMediumDistance.GetValueOnGameThread() ? ECharacterSignificance::Medium : ECharacterSignificance::Low;
+}
+
+float UCharacterSignificanceSubsystem::GetUpdateCost(const ECharacterSignificance Significance)
+{
+	//Animation is most of what a character costs, so count the fraction of frames it animates on
+	return 1.f / (GetUpdateRate(Significance).AnimationFrameSkip + 1);
+}
@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "CharacterSignificanceSubsystem.generated.h"
+
+class ASurvivalCharacter;
+
+//How much of the local players attention a character has, from most to least.  Less significant characters update less often
+UENUM(BlueprintType)
+enum class ECharacterSignificance : uint8
+{
+	//Close by, or controlled or viewed by a local player
+	High,
+	Medium,
+	Low,
+	//Not seen by any local player lately
+	Hidden
+};
+
+//How often a character and its meshes update at a significance
+struct FCharacterUpdateRate
+{
+	//Seconds between actor ticks, 0 for every frame
+	float TickInterval;
+
+	//Frames the bodies animation skips between updates, through update rate optimization (URO).  Gear follows the bodies pose
+	int32 AnimationFrameSkip;
+
+	bool bSimulateCloth;
+};
+
+/**
+ * Ranks characters by how significant they are to the local players, and lowers the tick, animation and cloth update rate of the
+ * less significant ones.  Characters are ranked by distance to the closest local viewer, whether they have been rendered lately
+ * and whether they are in front of the viewer.  Characters a local player controls or is viewing always update every frame.
+ *
+ * Character.Significance.Budget caps how many characters worth of full rate updates we do each frame.  If the ranked characters
+ * would cost more, the least significant ones are moved down until they fit.
+ */
+UCLASS()
+class SURVIVALGAME_API UCharacterSignificanceSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	//FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+	/* Start ranking a character.  Characters register when they start play */
+	void RegisterCharacter(ASurvivalCharacter* Character);
+
+	/* Stop ranking a character.  Characters unregister when they end play */
+	void UnregisterCharacter(ASurvivalCharacter* Character);
+
+	static const FCharacterUpdateRate& GetUpdateRate(const ECharacterSignificance Significance);
+
+protected:
+
+	struct FManagedCharacter
+	{
+		TWeakObjectPtr<ASurvivalCharacter> Character;
+
+		ECharacterSignificance Significance = ECharacterSignificance::High;
+
+		//Higher is more significant, only valid during the update
+		float Score = 0.f;
+
+		//Controlled or viewed by a local player, so never moved down for the budget
+		bool bAlwaysSignificant = false;
+	};
+
+	struct FViewer
+	{
+		FVector Location;
+		FVector Direction;
+		const AActor* ViewTarget;
+	};
+
+	/* Rank a character against the local viewers, and pick the significance its distance and visibility alone deserve */
+	ECharacterSignificance ScoreCharacter(FManagedCharacter& ManagedCharacter, const TArray<FViewer>& Viewers) const;
+
+	/* How many full rate character updates a frame a character at this significance costs */
+	static float GetUpdateCost(const ECharacterSignificance Significance);
+
+	TArray<FManagedCharacter> Characters;
+};
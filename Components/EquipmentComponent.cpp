@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EquipmentComponent.h"
+#include "StatsComponent.h"
+#include "../Items/GearItem.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+FEquipmentSlots::FEquipmentSlots()
+{
+	FMemory::Memzero(Items);
+}
+
+void FEquipmentSlots::Set(const EEquippableSlot Slot, class UEquippableItem* Item)
+{
+	Items[(int32)Slot] = Item;
+
+	FEquipmentSlotEntry* Entry = Entries.FindByPredicate([Slot](const FEquipmentSlotEntry& SlotEntry) { return SlotEntry.Slot == Slot; });
+
+	if (!Entry)
+	{
+		Entry = &Entries.AddDefaulted_GetRef();
+		Entry->Slot = Slot;
+	}
+
+	Entry->Item = Item;
+	MarkItemDirty(*Entry);
+}
+
+void FEquipmentSlotEntry::PostReplicatedAdd(const FEquipmentSlots& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnSlotReplicated(Slot, Item);
+	}
+}
+
+void FEquipmentSlotEntry::PostReplicatedChange(const FEquipmentSlots& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnSlotReplicated(Slot, Item);
+	}
+}
+
+UEquipmentComponent::UEquipmentComponent()
+{
+	SetIsReplicatedByDefault(true);
+
+	Slots.Owner = this;
+}
+
+void UEquipmentComponent::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UEquipmentComponent, Slots, Params);
+}
+
+void UEquipmentComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	OwnerStats = GetOwner()->FindComponentByClass<UStatsComponent>();
+}
+
+float UEquipmentComponent::GetDamageDefence() const
+{
+	return OwnerStats ? 1.f - OwnerStats->GetStat(ESurvivalStat::DamageTaken) : 0.f;
+}
+
+bool UEquipmentComponent::EquipItem(class UEquippableItem* Item)
+{
+	//Clients equip items as their equipped state replicates too, but they take their slots from OnRep_Slots alone
+	if (GetOwnerRole() != ROLE_Authority || !Item || GetEquippedItem(Item->Slot) == Item || (int32)Item->Slot >= FEquipmentSlots::NumSlots)
+	{
+		return false;
+	}
+
+	SetSlot(Item->Slot, Item);
+	return true;
+}
+
+bool UEquipmentComponent::UnEquipItem(class UEquippableItem* Item)
+{
+	if (GetOwnerRole() != ROLE_Authority || !Item || GetEquippedItem(Item->Slot) != Item)
+	{
+		return false;
+	}
+
+	SetSlot(Item->Slot, nullptr);
+	return true;
+}
+
+void UEquipmentComponent::SetSlot(const EEquippableSlot Slot, class UEquippableItem* Item)
+{
+	UEquippableItem* OldItem = Slots.Get(Slot);
+	Slots.Set(Slot, Item);
+	MARK_PROPERTY_DIRTY_FROM_NAME(UEquipmentComponent, Slots, this);
+
+	OnSlotChanged(Slot, OldItem, Item);
+}
+
+void UEquipmentComponent::OnSlotReplicated(const EEquippableSlot Slot, class UEquippableItem* NewItem)
+{
+	UEquippableItem* OldItem = Slots.Get(Slot);
+
+	//An entry can replicate again without the item in it changing
+	if ((int32)Slot >= FEquipmentSlots::NumSlots || OldItem == NewItem)
+	{
+		return;
+	}
+
+	Slots.Items[(int32)Slot] = NewItem;
+	OnSlotChanged(Slot, OldItem, NewItem);
+}
+
+void UEquipmentComponent::OnSlotChanged(const EEquippableSlot Slot, class UEquippableItem* OldItem, class UEquippableItem* NewItem)
+{
+	if (OwnerStats)
+	{
+		OwnerStats->RemoveModifiers(OldItem);
+
+		if (const UGearItem* Gear = Cast<UGearItem>(NewItem))
+		{
+			OwnerStats->AddModifier(ESurvivalStat::DamageTaken, Gear, 0.f, 1.f - Gear->DamageDefenceMultiplier);
+			OwnerStats->AddModifier(ESurvivalStat::WeightCapacity, Gear, Gear->CarryCapacityBonus);
+			OwnerStats->AddModifier(ESurvivalStat::SlotCapacity, Gear, Gear->SlotCapacityBonus);
+		}
+	}
+
+	OnEquippedItemChanged.Broadcast(Slot, NewItem);
+}
@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Engine/NetSerialization.h"
+#include "../Items/EquippableItem.h"
+#include "EquipmentComponent.generated.h"
+
+//Called when the item equipped to a slot changes.  Item is null if the slot was emptied
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnEquippedItemChanged, EEquippableSlot, Slot, class UEquippableItem*, Item);
+
+//The item in one equipment slot, replicated on its own so equipping one item doesn't resend the others
+USTRUCT()
+struct FEquipmentSlotEntry : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	EEquippableSlot Slot = EEquippableSlot::EIS_MAX;
+
+	UPROPERTY()
+	class UEquippableItem* Item = nullptr;
+
+	void PostReplicatedAdd(const struct FEquipmentSlots& InArraySerializer);
+	void PostReplicatedChange(const struct FEquipmentSlots& InArraySerializer);
+};
+
+//The item equipped to every slot.  Replicates as a fast array with an entry per slot that has ever been filled, so each connection
+//is only sent the slots that changed since the state it acknowledged
+USTRUCT()
+struct FEquipmentSlots : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	static constexpr int32 NumSlots = (int32)EEquippableSlot::EIS_MAX;
+
+	UPROPERTY()
+	TArray<FEquipmentSlotEntry> Entries;
+
+	//The item in every slot, indexed by slot.  On clients this is what we last applied, so a replicated entry can tell what it replaced
+	UPROPERTY(NotReplicated)
+	class UEquippableItem* Items[(int32)EEquippableSlot::EIS_MAX];
+
+	UPROPERTY(NotReplicated)
+	class UEquipmentComponent* Owner = nullptr;
+
+	FEquipmentSlots();
+
+	FORCEINLINE class UEquippableItem* Get(const EEquippableSlot Slot) const { return (int32)Slot < NumSlots ? Items[(int32)Slot] : nullptr; }
+
+	/* [server] Put an item in a slot and mark its entry for replication */
+	void Set(const EEquippableSlot Slot, class UEquippableItem* Item);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FEquipmentSlotEntry, FEquipmentSlots>(Entries, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FEquipmentSlots> : public TStructOpsTypeTraitsBase2<FEquipmentSlots>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+ * Holds the items a character has equipped, indexed by slot.  Equipped gear modifies the owners stats, so damage and inventory
+ * code read a single cached value from the stats component instead of walking every slot.
+ *
+ * The characters equipped items map stays the source of truth.  Equippable items mirror each change into this component on the
+ * server, and clients only pick changes up from the replicated slots, so every change is applied once.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class SURVIVALGAME_API UEquipmentComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UEquipmentComponent();
+
+	virtual void GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/* [server] Put an item in its slot, replacing whatever was there.  Returns false if the item was already equipped */
+	bool EquipItem(class UEquippableItem* Item);
+
+	/* [server] Take an item out of its slot.  Returns false if it wasn't equipped */
+	bool UnEquipItem(class UEquippableItem* Item);
+
+	UFUNCTION(BlueprintPure, Category = "Equipment")
+	FORCEINLINE class UEquippableItem* GetEquippedItem(const EEquippableSlot Slot) const { return Slots.Get(Slot); }
+
+	/* The fraction of damage the equipped gear blocks, with each piece blocking its share of what the others let through */
+	UFUNCTION(BlueprintPure, Category = "Equipment")
+	float GetDamageDefence() const;
+
+	UPROPERTY(BlueprintAssignable, Category = "Equipment")
+	FOnEquippedItemChanged OnEquippedItemChanged;
+
+protected:
+
+	virtual void OnRegister() override;
+
+	/* Swap the item in a slot, moving the owners stat modifiers over and telling listeners */
+	void SetSlot(const EEquippableSlot Slot, class UEquippableItem* Item);
+
+	/* An item left or entered a slot, so take away or give its stat modifiers */
+	void OnSlotChanged(const EEquippableSlot Slot, class UEquippableItem* OldItem, class UEquippableItem* NewItem);
+
+	friend struct FEquipmentSlotEntry;
+
+	/* [client] A slots entry replicated */
+	void OnSlotReplicated(const EEquippableSlot Slot, class UEquippableItem* NewItem);
+
+	UPROPERTY(Replicated)
+	FEquipmentSlots Slots;
+
+	UPROPERTY(Transient)
+	class UStatsComponent* OwnerStats;
+};
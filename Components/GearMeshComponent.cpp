@@ -0,0 +1,281 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GearMeshComponent.h"
+#include "../SurvivalGame.h"
+#include "Engine/GameInstance.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+#include "SkeletalMeshMerge.h"
+
+DECLARE_CYCLE_STAT(TEXT("Gear Mesh Merge"), STAT_GearMeshMerge, STATGROUP_SurvivalGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Gear Mesh Merges"), STAT_GearMeshMerges, STATGROUP_SurvivalGame);
+
+static TAutoConsoleVariable<int32> CVarGearMaxMergesPerFrame(
+	TEXT("Gear.MaxMergesPerFrame"),
+	1,
+	TEXT("How many sets of gear meshes can be merged in one frame.  Further merges wait for the next frame."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarGearMaxCachedMeshes(
+	TEXT("Gear.MaxCachedMeshes"),
+	256,
+	TEXT("How many merged gear meshes are kept around for reuse.  The least recently used are dropped past this."),
+	ECVF_Default);
+
+UGearMeshComponent::UGearMeshComponent()
+{
+	//Gear follows the bodies pose and shouldn't change the bounds or collide with anything
+	bUseBoundsFromMasterPoseComponent = true;
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetGenerateOverlapEvents(false);
+}
+
+void UGearMeshComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	if (USkinnedMeshComponent* Body = Cast<USkinnedMeshComponent>(GetAttachParent()))
+	{
+		SetMasterPoseComponent(Body);
+	}
+}
+
+void UGearMeshComponent::SetGear(const EEquippableSlot Slot, class USkeletalMesh* Mesh, class UMaterialInterface* Material /*= nullptr*/)
+{
+	if (!Mesh)
+	{
+		ClearGear(Slot);
+		return;
+	}
+
+	FEquippedGearMesh& Gear = EquippedGear.FindOrAdd(Slot);
+	Gear.Mesh = Mesh;
+	Gear.Material = Material;
+
+	UpdateGearMesh();
+}
+
+void UGearMeshComponent::ClearGear(const EEquippableSlot Slot)
+{
+	if (EquippedGear.Remove(Slot))
+	{
+		UpdateGearMesh();
+	}
+}
+
+void UGearMeshComponent::UpdateGearMesh()
+{
+	//Nobody sees the gear on a dedicated server
+	if (GetNetMode() == NM_DedicatedServer)
+	{
+		return;
+	}
+
+	FGearMeshSet MeshSet;
+	for (const auto& Gear : EquippedGear)
+	{
+		MeshSet.Meshes.Add(Gear.Value.Mesh);
+	}
+	MeshSet.Meshes.Sort();
+
+	if (MeshSet == RequestedMeshSet)
+	{
+		//Only the materials changed
+		ApplyGearMesh(SkeletalMesh);
+		return;
+	}
+
+	RequestedMeshSet = MeshSet;
+
+	//A single piece of gear is already a mesh of its own
+	if (MeshSet.Meshes.Num() <= 1)
+	{
+		ApplyGearMesh(MeshSet.Meshes.Num() ? MeshSet.Meshes[0] : nullptr);
+		return;
+	}
+
+	UGameInstance* GameInstance = GetWorld() ? GetWorld()->GetGameInstance() : nullptr;
+	UGearMeshCache* GearMeshCache = GameInstance ? GameInstance->GetSubsystem<UGearMeshCache>() : nullptr;
+
+	if (!GearMeshCache)
+	{
+		return;
+	}
+
+	if (USkeletalMesh* MergedMesh = GearMeshCache->RequestMergedMesh(MeshSet, this))
+	{
+		ApplyGearMesh(MergedMesh);
+	}
+}
+
+void UGearMeshComponent::OnMergedMeshReady(const FGearMeshSet& MeshSet, class USkeletalMesh* MergedMesh)
+{
+	//Our gear changed again while this set was being merged
+	if (MeshSet == RequestedMeshSet)
+	{
+		ApplyGearMesh(MergedMesh);
+	}
+}
+
+void UGearMeshComponent::ApplyGearMesh(class USkeletalMesh* NewMesh)
+{
+	if (NewMesh != SkeletalMesh)
+	{
+		SetSkeletalMesh(NewMesh, false);
+	}
+
+	EmptyOverrideMaterials();
+
+	if (!NewMesh)
+	{
+		return;
+	}
+
+	//The merged mesh has one material slot per distinct material of its pieces, so override the slots that came from gear with a material set
+	for (int32 MaterialIndex = 0; MaterialIndex < NewMesh->Materials.Num(); ++MaterialIndex)
+	{
+		const UMaterialInterface* SlotMaterial = NewMesh->Materials[MaterialIndex].MaterialInterface;
+
+		for (const auto& Gear : EquippedGear)
+		{
+			if (Gear.Value.Material && (Gear.Value.Mesh == NewMesh || Gear.Value.Mesh->Materials.ContainsByPredicate([SlotMaterial](const FSkeletalMaterial& Material) { return Material.MaterialInterface == SlotMaterial; })))
+			{
+				SetMaterial(MaterialIndex, Gear.Value.Material);
+				break;
+			}
+		}
+	}
+}
+
+void UGearMeshCache::Deinitialize()
+{
+	MergedMeshes.Empty();
+	MergedMeshUses.Empty();
+	PendingMerges.Empty();
+	PendingRequesters.Empty();
+
+	Super::Deinitialize();
+}
+
+void UGearMeshCache::Tick(float DeltaTime)
+{
+	const int32 MaxMerges = FMath::Max(CVarGearMaxMergesPerFrame.GetValueOnGameThread(), 1);
+
+	for (int32 i = 0; i < MaxMerges && PendingMerges.Num(); ++i)
+	{
+		const FGearMeshSet MeshSet = PendingMerges[0];
+		PendingMerges.RemoveAt(0);
+
+		TArray<TWeakObjectPtr<UGearMeshComponent>> Requesters;
+		PendingRequesters.RemoveAndCopyValue(MeshSet, Requesters);
+
+		//Nobody is wearing this set anymore
+		Requesters.RemoveAll([&MeshSet](const TWeakObjectPtr<UGearMeshComponent>& Requester) { return !Requester.IsValid() || Requester->RequestedMeshSet != MeshSet; });
+		if (!Requesters.Num())
+		{
+			continue;
+		}
+
+		USkeletalMesh* MergedMesh = MergeMeshes(MeshSet);
+		if (!MergedMesh)
+		{
+			//Show something rather than the previous gear, and remember the failure so the set isn't merged again on every request
+			MergedMesh = GetFallbackMesh(MeshSet);
+			if (!MergedMesh)
+			{
+				continue;
+			}
+		}
+
+		const int32 MaxCachedMeshes = FMath::Max(CVarGearMaxCachedMeshes.GetValueOnGameThread(), 1);
+		while (MergedMeshUses.Num() >= MaxCachedMeshes)
+		{
+			//Components still showing a dropped mesh keep it alive until they change gear
+			MergedMeshes.Remove(MergedMeshUses[0]);
+			MergedMeshUses.RemoveAt(0);
+		}
+
+		MergedMeshes.Add(MeshSet, MergedMesh);
+		MergedMeshUses.Add(MeshSet);
+
+		for (const TWeakObjectPtr<UGearMeshComponent>& Requester : Requesters)
+		{
+			Requester->OnMergedMeshReady(MeshSet, MergedMesh);
+		}
+	}
+}
+
+bool UGearMeshCache::IsTickable() const
+{
+	return PendingMerges.Num() > 0;
+}
+
+TStatId UGearMeshCache::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGearMeshCache, STATGROUP_Tickables);
+}
+
+class USkeletalMesh* UGearMeshCache::RequestMergedMesh(const FGearMeshSet& MeshSet, UGearMeshComponent* Requester)
+{
+	if (USkeletalMesh** MergedMesh = MergedMeshes.Find(MeshSet))
+	{
+		//Move it to the back so the least recently used sets are dropped first
+		MergedMeshUses.RemoveSingle(MeshSet);
+		MergedMeshUses.Add(MeshSet);
+		return *MergedMesh;
+	}
+
+	TArray<TWeakObjectPtr<UGearMeshComponent>>* Requesters = PendingRequesters.Find(MeshSet);
+
+	if (!Requesters)
+	{
+		PendingMerges.Add(MeshSet);
+		Requesters = &PendingRequesters.Add(MeshSet);
+	}
+
+	Requesters->AddUnique(Requester);
+	return nullptr;
+}
+
+class USkeletalMesh* UGearMeshCache::MergeMeshes(const FGearMeshSet& MeshSet) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GearMeshMerge);
+	INC_DWORD_STAT(STAT_GearMeshMerges);
+
+	if (!MeshSet.Meshes.Num() || MeshSet.Meshes.Contains(nullptr))
+	{
+		return nullptr;
+	}
+
+	USkeletalMesh* MergedMesh = NewObject<USkeletalMesh>(this, NAME_None, RF_Transient);
+	MergedMesh->Skeleton = MeshSet.Meshes[0]->Skeleton;
+
+	const TArray<FSkelMeshMergeSectionMapping> SectionMappings;
+	FSkeletalMeshMerge Merger(MergedMesh, MeshSet.Meshes, SectionMappings, 0);
+
+	if (!Merger.DoMerge())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Failed to merge %d gear meshes, starting with %s"), MeshSet.Meshes.Num(), *GetNameSafe(MeshSet.Meshes[0]));
+		return nullptr;
+	}
+
+	return MergedMesh;
+}
+
+class USkeletalMesh* UGearMeshCache::GetFallbackMesh(const FGearMeshSet& MeshSet) const
+{
+	USkeletalMesh* FallbackMesh = nullptr;
+	float FallbackRadius = -1.f;
+
+	for (USkeletalMesh* Mesh : MeshSet.Meshes)
+	{
+		if (Mesh && Mesh->GetImportedBounds().SphereRadius > FallbackRadius)
+		{
+			FallbackMesh = Mesh;
+			FallbackRadius = Mesh->GetImportedBounds().SphereRadius;
+		}
+	}
+
+	return FallbackMesh;
+}
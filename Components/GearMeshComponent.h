@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "../Items/EquippableItem.h"
+#include "GearMeshComponent.generated.h"
+
+//A set of gear meshes that can be merged into one.  Sorted, so the same gear equipped in any order is the same set
+USTRUCT()
+struct FGearMeshSet
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<class USkeletalMesh*> Meshes;
+
+	bool operator==(const FGearMeshSet& Other) const { return Meshes == Other.Meshes; }
+	bool operator!=(const FGearMeshSet& Other) const { return !(*this == Other); }
+
+	friend uint32 GetTypeHash(const FGearMeshSet& MeshSet)
+	{
+		uint32 Hash = 0;
+		for (const class USkeletalMesh* Mesh : MeshSet.Meshes)
+		{
+			Hash = HashCombine(Hash, GetTypeHash(Mesh));
+		}
+		return Hash;
+	}
+};
+
+//A piece of gear equipped to a slot
+USTRUCT()
+struct FEquippedGearMesh
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	class USkeletalMesh* Mesh = nullptr;
+
+	UPROPERTY()
+	class UMaterialInterface* Material = nullptr;
+};
+
+/**
+ * Draws every piece of gear a character has equipped as one skeletal mesh.  Whenever the equipped gear changes, the gear meshes
+ * are merged into a single mesh by the gear mesh cache, so a character costs one extra skinned draw and one bone map no matter
+ * how much gear it wears.  The merge happens a frame or so later, and until then the previous gear stays on.
+ *
+ * Follows the pose of the component it is attached to, which should be the characters body mesh.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class SURVIVALGAME_API UGearMeshComponent : public USkeletalMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UGearMeshComponent();
+
+	/* Show a piece of gear in a slot, replacing whatever was there.  Material overrides every material of the mesh if set */
+	UFUNCTION(BlueprintCallable, Category = "Gear")
+	void SetGear(const EEquippableSlot Slot, class USkeletalMesh* Mesh, class UMaterialInterface* Material = nullptr);
+
+	/* Stop showing the gear in a slot */
+	UFUNCTION(BlueprintCallable, Category = "Gear")
+	void ClearGear(const EEquippableSlot Slot);
+
+	/* Called by the gear mesh cache once a mesh set this component asked for has been merged */
+	void OnMergedMeshReady(const FGearMeshSet& MeshSet, class USkeletalMesh* MergedMesh);
+
+protected:
+
+	virtual void OnRegister() override;
+
+	/* Ask for the merged mesh of the gear we have equipped now */
+	void UpdateGearMesh();
+
+	/* Show a merged (or single) gear mesh, with our gears material overrides */
+	void ApplyGearMesh(class USkeletalMesh* NewMesh);
+
+	UPROPERTY(Transient)
+	TMap<EEquippableSlot, FEquippedGearMesh> EquippedGear;
+
+	//The gear meshes we are showing, or waiting on the merge of
+	UPROPERTY(Transient)
+	FGearMeshSet RequestedMeshSet;
+};
+
+/**
+ * Merges sets of gear meshes into single skeletal meshes, and caches the result for every set so characters wearing the same
+ * gear share one mesh.  Merging is expensive and has to happen on the game thread, so requests are queued and only a few are
+ * merged each frame.
+ */
+UCLASS()
+class SURVIVALGAME_API UGearMeshCache : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	//FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	/* Get the merged mesh for a set of gear meshes.  Returns the cached mesh if the set has been merged before, otherwise
+	queues the merge and calls Requester back with the result once it is done */
+	class USkeletalMesh* RequestMergedMesh(const FGearMeshSet& MeshSet, UGearMeshComponent* Requester);
+
+protected:
+
+	/* Merge a set of gear meshes into a new skeletal mesh, or return null if they can't be merged */
+	class USkeletalMesh* MergeMeshes(const FGearMeshSet& MeshSet) const;
+
+	/* What to show for a set that couldn't be merged: the single piece that covers the most of the character */
+	class USkeletalMesh* GetFallbackMesh(const FGearMeshSet& MeshSet) const;
+
+	//The merged mesh of every set, or its fallback mesh if the merge failed so we don't try it again
+	UPROPERTY(Transient)
+	TMap<FGearMeshSet, class USkeletalMesh*> MergedMeshes;
+
+	//The sets in MergedMeshes, least recently used first
+	TArray<FGearMeshSet> MergedMeshUses;
+
+	//Sets waiting to be merged, oldest first
+	UPROPERTY(Transient)
+	TArray<FGearMeshSet> PendingMerges;
+
+	//The components waiting on each pending set
+	TMap<FGearMeshSet, TArray<TWeakObjectPtr<UGearMeshComponent>>> PendingRequesters;
+};
@@ -0,0 +1,189 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "StatsComponent.h"
+#include "InventoryComponent.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+UStatsComponent::UStatsComponent()
+{
+	//Only ticks to push stats that changed this frame
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+
+	Stats[(int32)ESurvivalStat::DamageTaken].BaseValue = 1.f;
+}
+
+void UStatsComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (const UInventoryComponent* Inventory = GetOwner()->FindComponentByClass<UInventoryComponent>())
+	{
+		Stats[(int32)ESurvivalStat::WeightCapacity].BaseValue = Inventory->GetWeightCapacity();
+		Stats[(int32)ESurvivalStat::SlotCapacity].BaseValue = Inventory->GetCapacity();
+	}
+
+	if (const ACharacter* Character = Cast<ACharacter>(GetOwner()))
+	{
+		Stats[(int32)ESurvivalStat::MoveSpeed].BaseValue = Character->GetCharacterMovement()->MaxWalkSpeed;
+	}
+
+	//Modifiers added before we started play were applied to the old base values
+	for (int32 i = 0; i < (int32)ESurvivalStat::MAX; ++i)
+	{
+		if (Stats[i].Modifiers.Num())
+		{
+			MarkDirty((ESurvivalStat)i);
+		}
+	}
+}
+
+void UStatsComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	for (int32 i = 0; i < (int32)ESurvivalStat::MAX; ++i)
+	{
+		if (Stats[i].bNeedsPush)
+		{
+			Stats[i].bNeedsPush = false;
+			PushStat((ESurvivalStat)i, GetStat((ESurvivalStat)i));
+		}
+	}
+
+	SetComponentTickEnabled(false);
+}
+
+void UStatsComponent::AddModifier(const ESurvivalStat Stat, const UObject* Source, const float Additive, const float Multiplier /*= 1.f*/)
+{
+	if (Stat >= ESurvivalStat::MAX)
+	{
+		return;
+	}
+
+	TArray<FStatModifier>& Modifiers = Stats[(int32)Stat].Modifiers;
+	const int32 ExistingIndex = Modifiers.IndexOfByPredicate([Source](const FStatModifier& Modifier) { return Modifier.Source == Source; });
+
+	//A modifier that does nothing just clears whatever Source had on the stat
+	if (Additive == 0.f && Multiplier == 1.f)
+	{
+		if (ExistingIndex != INDEX_NONE)
+		{
+			Modifiers.RemoveAtSwap(ExistingIndex);
+			MarkDirty(Stat);
+		}
+		return;
+	}
+
+	if (ExistingIndex != INDEX_NONE)
+	{
+		FStatModifier& Modifier = Modifiers[ExistingIndex];
+
+		if (Modifier.Additive == Additive && Modifier.Multiplier == Multiplier)
+		{
+			return;
+		}
+
+		Modifier.Additive = Additive;
+		Modifier.Multiplier = Multiplier;
+	}
+	else
+	{
+		Modifiers.Add({ Source, Additive, Multiplier });
+	}
+
+	MarkDirty(Stat);
+}
+
+void UStatsComponent::RemoveModifiers(const UObject* Source)
+{
+	for (int32 i = 0; i < (int32)ESurvivalStat::MAX; ++i)
+	{
+		if (Stats[i].Modifiers.RemoveAllSwap([Source](const FStatModifier& Modifier) { return Modifier.Source == Source; }))
+		{
+			MarkDirty((ESurvivalStat)i);
+		}
+	}
+}
+
+float UStatsComponent::GetStat(const ESurvivalStat Stat) const
+{
+	if (Stat >= ESurvivalStat::MAX)
+	{
+		return 0.f;
+	}
+
+	const FStat& StatData = Stats[(int32)Stat];
+
+	if (StatData.bDirty)
+	{
+		//Sources that were destroyed without removing their modifiers no longer apply
+		StatData.Modifiers.RemoveAllSwap([](const FStatModifier& Modifier) { return !Modifier.Source.IsValid(); });
+
+		float Additive = 0.f;
+		float Multiplier = 1.f;
+
+		for (const FStatModifier& Modifier : StatData.Modifiers)
+		{
+			Additive += Modifier.Additive;
+			Multiplier *= Modifier.Multiplier;
+		}
+
+		StatData.Value = (StatData.BaseValue + Additive) * Multiplier;
+		StatData.bDirty = false;
+	}
+
+	return StatData.Value;
+}
+
+void UStatsComponent::MarkDirty(const ESurvivalStat Stat)
+{
+	FStat& StatData = Stats[(int32)Stat];
+	StatData.bDirty = true;
+	StatData.bNeedsPush = true;
+
+	//Push at the end of the frame, once every modifier changing this frame has changed
+	if (HasBegunPlay())
+	{
+		SetComponentTickEnabled(true);
+	}
+}
+
+void UStatsComponent::PushStat(const ESurvivalStat Stat, const float Value)
+{
+	switch (Stat)
+	{
+	case ESurvivalStat::WeightCapacity:
+	case ESurvivalStat::SlotCapacity:
+		//Only the server checks inventory limits
+		if (GetOwnerRole() == ROLE_Authority)
+		{
+			if (UInventoryComponent* Inventory = GetOwner()->FindComponentByClass<UInventoryComponent>())
+			{
+				if (Stat == ESurvivalStat::WeightCapacity)
+				{
+					Inventory->SetWeightCapacity(Value);
+				}
+				else
+				{
+					Inventory->SetCapacity(FMath::FloorToInt(Value));
+				}
+			}
+		}
+		break;
+	case ESurvivalStat::MoveSpeed:
+		//Pushed everywhere, so predicted movement matches the server
+		if (ACharacter* Character = Cast<ACharacter>(GetOwner()))
+		{
+			Character->GetCharacterMovement()->MaxWalkSpeed = Value;
+		}
+		break;
+	default:
+		break;
+	}
+
+	OnStatChanged.Broadcast(Stat, Value);
+}
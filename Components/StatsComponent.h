@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "StatsComponent.generated.h"
+
+//The stats of a character that items and effects can modify
+UENUM(BlueprintType)
+enum class ESurvivalStat : uint8
+{
+	//The most weight the characters inventory can hold
+	WeightCapacity,
+	//The most items the characters inventory can hold
+	SlotCapacity,
+	//The fraction of incoming damage the character takes.  Gear lowers it
+	DamageTaken,
+	//The characters max walk speed
+	MoveSpeed,
+	MAX UMETA(Hidden)
+};
+
+//Called when the value of a stat changes
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnStatChanged, ESurvivalStat, Stat, float, NewValue);
+
+/**
+ * Adds up everything that modifies a characters stats.  Items and effects add additive and multiplicative modifiers to a stat
+ * under themselves as the source, and remove them all at once when they stop applying.  A stat is (base + additive) * multipliers.
+ *
+ * Changing a modifier only marks its stat dirty.  Dirty stats are recalculated when they are read, or at the end of the frame
+ * at the latest, when the new values are pushed to the owners inventory and movement.  However many modifiers change in a
+ * frame, each stat is recalculated and pushed once.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class SURVIVALGAME_API UStatsComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UStatsComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/* Modify a stat on behalf of Source.  Replaces any modifier Source already has on the stat, so applying it twice is harmless */
+	void AddModifier(const ESurvivalStat Stat, const UObject* Source, const float Additive, const float Multiplier = 1.f);
+
+	/* Remove every modifier Source has on any stat */
+	void RemoveModifiers(const UObject* Source);
+
+	/* The current value of a stat, with every modifier applied */
+	UFUNCTION(BlueprintPure, Category = "Stats")
+	float GetStat(const ESurvivalStat Stat) const;
+
+	UPROPERTY(BlueprintAssignable, Category = "Stats")
+	FOnStatChanged OnStatChanged;
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	struct FStatModifier
+	{
+		TWeakObjectPtr<const UObject> Source;
+		float Additive;
+		float Multiplier;
+	};
+
+	struct FStat
+	{
+		//The value without modifiers, read from whatever the stat is pushed to when we start play
+		float BaseValue = 0.f;
+
+		//Mutable so modifiers whose source has been destroyed can be dropped when the stat is recalculated
+		mutable TArray<FStatModifier> Modifiers;
+
+		mutable float Value = 0.f;
+		mutable bool bDirty = true;
+
+		//Changed since it was last pushed
+		bool bNeedsPush = false;
+	};
+
+	void MarkDirty(const ESurvivalStat Stat);
+
+	/* Give the owner the new value of a stat */
+	void PushStat(const ESurvivalStat Stat, const float Value);
+
+	FStat Stats[(int32)ESurvivalStat::MAX];
+};
@@ -0,0 +1,176 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SurvivalEffectsComponent.h"
+#include "../SurvivalEffectManager.h"
+#include "Engine/World.h"
+
+USurvivalEffectsComponent::USurvivalEffectsComponent()
+{
+	SetIsReplicatedByDefault(true);
+}
+
+void USurvivalEffectsComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		if (USurvivalEffectManager* EffectManager = GetWorld()->GetSubsystem<USurvivalEffectManager>())
+		{
+			EffectManager->RemoveEffects(this);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void USurvivalEffectsComponent::RemoveAllEffects()
+{
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		return;
+	}
+
+	if (USurvivalEffectManager* EffectManager = GetWorld()->GetSubsystem<USurvivalEffectManager>())
+	{
+		EffectManager->RemoveEffects(this);
+	}
+
+	//Stopping an effect removes it from the array, so take the ids first
+	TArray<uint16, TInlineAllocator<8>> EffectIds;
+	for (const FActiveSurvivalEffect& ActiveEffect : ActiveEffects)
+	{
+		EffectIds.Add(ActiveEffect.Id);
+	}
+
+	for (const uint16 EffectId : EffectIds)
+	{
+		StopEffect(EffectId);
+	}
+}
+
+void USurvivalEffectsComponent::StartEffect(const uint16 Id, UObject* Source, const FSurvivalEffect& Effect)
+{
+	AddEffect(Id, Source, Effect, Effect.Duration);
+	ClientEffectStarted(Id, Source, Effect, Effect.Duration);
+}
+
+void USurvivalEffectsComponent::StopEffect(const uint16 Id)
+{
+	RemoveEffect(Id);
+	ClientEffectStopped(Id);
+}
+
+void USurvivalEffectsComponent::ClientEffectStarted_Implementation(const uint16 Id, UObject* Source, const FSurvivalEffect& Effect, const float RemainingTime)
+{
+	//A listen server's own character already has it
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		AddEffect(Id, Source, Effect, RemainingTime);
+	}
+}
+
+void USurvivalEffectsComponent::ClientEffectStopped_Implementation(const uint16 Id)
+{
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		RemoveEffect(Id);
+	}
+}
+
+float USurvivalEffectsComponent::GetPredictedHealthChange() const
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+	float HealthChange = 0.f;
+
+	for (const FActiveSurvivalEffect& ActiveEffect : ActiveEffects)
+	{
+		HealthChange += ActiveEffect.Effect.HealthPerSecond * FMath::Max(ActiveEffect.EndTime - Now, 0.f);
+	}
+
+	return HealthChange;
+}
+
+void USurvivalEffectsComponent::AddEffect(const uint16 Id, UObject* Source, const FSurvivalEffect& Effect, const float RemainingTime)
+{
+	//Reapplying an effect refreshes it under the same id
+	FActiveSurvivalEffect* ActiveEffect = ActiveEffects.FindByPredicate([Id](const FActiveSurvivalEffect& Existing) { return Existing.Id == Id; });
+
+	if (!ActiveEffect)
+	{
+		ActiveEffect = &ActiveEffects.AddDefaulted_GetRef();
+		ActiveEffect->Id = Id;
+	}
+
+	ActiveEffect->Source = Source;
+	ActiveEffect->Effect = Effect;
+	ActiveEffect->EndTime = GetWorld()->GetTimeSeconds() + RemainingTime;
+
+	if (Effect.bModifiesStat)
+	{
+		UpdateStatModifiers(Source);
+	}
+
+	OnEffectsChanged.Broadcast();
+}
+
+void USurvivalEffectsComponent::RemoveEffect(const uint16 Id)
+{
+	const int32 Index = ActiveEffects.IndexOfByPredicate([Id](const FActiveSurvivalEffect& Existing) { return Existing.Id == Id; });
+
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	const FActiveSurvivalEffect RemovedEffect = ActiveEffects[Index];
+	ActiveEffects.RemoveAtSwap(Index);
+
+	if (RemovedEffect.Effect.bModifiesStat)
+	{
+		UpdateStatModifiers(RemovedEffect.Source.Get());
+	}
+
+	OnEffectsChanged.Broadcast();
+}
+
+void USurvivalEffectsComponent::UpdateStatModifiers(const UObject* Source)
+{
+	UStatsComponent* Stats = GetOwner()->FindComponentByClass<UStatsComponent>();
+
+	if (!Stats || !Source)
+	{
+		return;
+	}
+
+	//The stats component keeps one modifier per source and stat, so combine every effect that source still has running on each
+	//stat into one, the same way the stats component combines modifiers from different sources
+	float Additives[(int32)ESurvivalStat::MAX] = {};
+	float Multipliers[(int32)ESurvivalStat::MAX];
+	bool bModified[(int32)ESurvivalStat::MAX] = {};
+
+	for (int32 i = 0; i < (int32)ESurvivalStat::MAX; ++i)
+	{
+		Multipliers[i] = 1.f;
+	}
+
+	for (const FActiveSurvivalEffect& ActiveEffect : ActiveEffects)
+	{
+		if (ActiveEffect.Source == Source && ActiveEffect.Effect.bModifiesStat)
+		{
+			const int32 StatIndex = (int32)ActiveEffect.Effect.Stat;
+			Additives[StatIndex] += ActiveEffect.Effect.StatAdditive;
+			Multipliers[StatIndex] *= ActiveEffect.Effect.StatMultiplier;
+			bModified[StatIndex] = true;
+		}
+	}
+
+	Stats->RemoveModifiers(Source);
+
+	for (int32 i = 0; i < (int32)ESurvivalStat::MAX; ++i)
+	{
+		if (bModified[i])
+		{
+			Stats->AddModifier((ESurvivalStat)i, Source, Additives[i], Multipliers[i]);
+		}
+	}
+}
@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "StatsComponent.h"
+#include "SurvivalEffectsComponent.generated.h"
+
+//Called when an effect starts or stops on the owner
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnSurvivalEffectsChanged);
+
+//Something that happens to a character for a while, like healing over time, bleeding or a buff
+USTRUCT(BlueprintType)
+struct FSurvivalEffect
+{
+	GENERATED_BODY()
+
+	//How long the effect lasts, in seconds
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Effect", meta = (ClampMin = 0.0))
+	float Duration = 10.f;
+
+	//Health gained every second.  Negative bleeds
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Effect")
+	float HealthPerSecond = 0.f;
+
+	//Whether the effect modifies one of the characters stats while it lasts
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Effect")
+	bool bModifiesStat = false;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Effect", meta = (EditCondition = "bModifiesStat"))
+	ESurvivalStat Stat = ESurvivalStat::MoveSpeed;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Effect", meta = (EditCondition = "bModifiesStat"))
+	float StatAdditive = 0.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Effect", meta = (EditCondition = "bModifiesStat"))
+	float StatMultiplier = 1.f;
+};
+
+//An effect running on a character
+struct FActiveSurvivalEffect
+{
+	uint16 Id;
+
+	//What applied the effect, i.e. the class defaults of a food item.  Stat modifiers are applied under it
+	TWeakObjectPtr<UObject> Source;
+
+	FSurvivalEffect Effect;
+
+	//World time the effect stops, on this machine
+	float EndTime;
+};
+
+/**
+ * The effects running on a character.  Effects are timed and applied by the survival effect manager on the server, so this
+ * component doesn't tick.  It only holds the effects for the UI and applies their stat modifiers.  The owning client is told
+ * when effects start and stop, so it can predict its stats and health without replicating them every update.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class SURVIVALGAME_API USurvivalEffectsComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	USurvivalEffectsComponent();
+
+	/* [server] Called by the effect manager when it starts an effect on us */
+	void StartEffect(const uint16 Id, UObject* Source, const FSurvivalEffect& Effect);
+
+	/* [server] Called by the effect manager when one of our effects stops */
+	void StopEffect(const uint16 Id);
+
+	/* [server] Stop every effect on the owner without applying what is left of them.  Must be called when the owner dies, so
+	healing and bleeding don't carry on on its corpse */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Effects")
+	void RemoveAllEffects();
+
+	/* How much health our effects will give or take before they all stop */
+	UFUNCTION(BlueprintPure, Category = "Effects")
+	float GetPredictedHealthChange() const;
+
+	FORCEINLINE const TArray<FActiveSurvivalEffect>& GetActiveEffects() const { return ActiveEffects; }
+
+	UPROPERTY(BlueprintAssignable, Category = "Effects")
+	FOnSurvivalEffectsChanged OnEffectsChanged;
+
+protected:
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	UFUNCTION(Client, Reliable)
+	void ClientEffectStarted(const uint16 Id, UObject* Source, const FSurvivalEffect& Effect, const float RemainingTime);
+
+	UFUNCTION(Client, Reliable)
+	void ClientEffectStopped(const uint16 Id);
+
+	void AddEffect(const uint16 Id, UObject* Source, const FSurvivalEffect& Effect, const float RemainingTime);
+	void RemoveEffect(const uint16 Id);
+
+	/* Reapply the stat modifiers of every effect from Source, after one of them started or stopped */
+	void UpdateStatModifiers(const UObject* Source);
+
+	TArray<FActiveSurvivalEffect> ActiveEffects;
+};
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SurvivalNeedsComponent.h"
+#include "../SurvivalNeedsSubsystem.h"
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+USurvivalNeedsComponent::USurvivalNeedsComponent()
+{
+	SetIsReplicatedByDefault(true);
+
+	NeedsIndex = INDEX_NONE;
+}
+
+void USurvivalNeedsComponent::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	Params.Condition = COND_OwnerOnly;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(USurvivalNeedsComponent, Needs, Params);
+}
+
+void USurvivalNeedsComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		if (USurvivalNeedsSubsystem* NeedsSubsystem = GetWorld()->GetSubsystem<USurvivalNeedsSubsystem>())
+		{
+			NeedsIndex = NeedsSubsystem->Register(this);
+		}
+	}
+}
+
+void USurvivalNeedsComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (NeedsIndex != INDEX_NONE)
+	{
+		if (USurvivalNeedsSubsystem* NeedsSubsystem = GetWorld()->GetSubsystem<USurvivalNeedsSubsystem>())
+		{
+			NeedsSubsystem->Unregister(NeedsIndex);
+		}
+
+		NeedsIndex = INDEX_NONE;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+float USurvivalNeedsComponent::Consume(const float HungerRestored, const float ThirstRestored)
+{
+	if (NeedsIndex != INDEX_NONE)
+	{
+		if (USurvivalNeedsSubsystem* NeedsSubsystem = GetWorld()->GetSubsystem<USurvivalNeedsSubsystem>())
+		{
+			return NeedsSubsystem->Consume(NeedsIndex, HungerRestored, ThirstRestored);
+		}
+	}
+
+	//Clients only know our rounded needs
+	return FMath::Clamp(HungerRestored, 0.f, 100.f - GetHunger()) + FMath::Clamp(ThirstRestored, 0.f, 100.f - GetThirst());
+}
+
+void USurvivalNeedsComponent::SetEnvironmentTemperature(const float NewEnvironmentTemperature)
+{
+	if (NeedsIndex != INDEX_NONE)
+	{
+		if (USurvivalNeedsSubsystem* NeedsSubsystem = GetWorld()->GetSubsystem<USurvivalNeedsSubsystem>())
+		{
+			NeedsSubsystem->SetEnvironmentTemperature(NeedsIndex, NewEnvironmentTemperature);
+		}
+	}
+}
+
+void USurvivalNeedsComponent::ResetEnvironmentTemperature()
+{
+	if (NeedsIndex != INDEX_NONE)
+	{
+		if (USurvivalNeedsSubsystem* NeedsSubsystem = GetWorld()->GetSubsystem<USurvivalNeedsSubsystem>())
+		{
+			NeedsSubsystem->ResetEnvironmentTemperature(NeedsIndex);
+		}
+	}
+}
+
+void USurvivalNeedsComponent::SetNeeds(const FSurvivalNeeds& NewNeeds)
+{
+	if (NewNeeds.Hunger == Needs.Hunger && NewNeeds.Thirst == Needs.Thirst && NewNeeds.Temperature == Needs.Temperature)
+	{
+		return;
+	}
+
+	Needs = NewNeeds;
+	MARK_PROPERTY_DIRTY_FROM_NAME(USurvivalNeedsComponent, Needs, this);
+
+	OnRep_Needs();
+}
+
+void USurvivalNeedsComponent::OnRep_Needs()
+{
+	OnNeedsChanged.Broadcast();
+}
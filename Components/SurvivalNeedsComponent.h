@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "SurvivalNeedsComponent.generated.h"
+
+//Called on the owner when its needs have changed by a whole point
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnSurvivalNeedsChanged);
+
+//A characters needs, rounded to whole points from 0 to 100
+USTRUCT()
+struct FSurvivalNeeds
+{
+	GENERATED_BODY()
+
+	//100 is full, 0 is starving
+	UPROPERTY()
+	uint8 Hunger = 100;
+
+	//100 is quenched, 0 is dehydrated
+	UPROPERTY()
+	uint8 Thirst = 100;
+
+	//50 is comfortable, 0 is freezing and 100 is overheating
+	UPROPERTY()
+	uint8 Temperature = 50;
+};
+
+/**
+ * A characters hunger, thirst and temperature.  The server simulates every characters needs together in the survival needs
+ * subsystem, so this component doesn't tick.  It only holds the rounded values the owner sees, which replicate when they
+ * change by a whole point.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class SURVIVALGAME_API USurvivalNeedsComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	USurvivalNeedsComponent();
+
+	virtual void GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const override;
+
+	UFUNCTION(BlueprintPure, Category = "Needs")
+	FORCEINLINE float GetHunger() const { return Needs.Hunger; }
+
+	UFUNCTION(BlueprintPure, Category = "Needs")
+	FORCEINLINE float GetThirst() const { return Needs.Thirst; }
+
+	UFUNCTION(BlueprintPure, Category = "Needs")
+	FORCEINLINE float GetTemperature() const { return Needs.Temperature; }
+
+	/* Eat or drink something.  Returns how much hunger and thirst it restored in total, which clients can only estimate */
+	float Consume(const float HungerRestored, const float ThirstRestored);
+
+	/* [server] Set the temperature the owner is exposed to, on the same scale as its own temperature */
+	void SetEnvironmentTemperature(const float NewEnvironmentTemperature);
+
+	/* [server] Go back to the ambient temperature, i.e. after leaving a temperature volume */
+	void ResetEnvironmentTemperature();
+
+	UPROPERTY(BlueprintAssignable, Category = "Needs")
+	FOnSurvivalNeedsChanged OnNeedsChanged;
+
+protected:
+
+	friend class USurvivalNeedsSubsystem;
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/* [server] Called by the needs subsystem when the rounded needs have changed */
+	void SetNeeds(const FSurvivalNeeds& NewNeeds);
+
+	UFUNCTION()
+	void OnRep_Needs();
+
+	UPROPERTY(ReplicatedUsing = OnRep_Needs)
+	FSurvivalNeeds Needs;
+
+	//Where our needs are stored in the needs subsystem, or INDEX_NONE if we aren't registered
+	int32 NeedsIndex;
+};
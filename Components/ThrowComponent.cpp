@@ -0,0 +1,136 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ThrowComponent.h"
+#include "InventoryComponent.h"
+#include "../Items/ThrowableItem.h"
+#include "../Weapons/ProjectileManager.h"
+#include "GameFramework/Character.h"
+#include "Engine/World.h"
+
+// Sets default values for this component's properties
+UThrowComponent::UThrowComponent()
+{
+	SetIsReplicatedByDefault(true);
+
+	MaxThrowOriginDistance = 300.f;
+	LastPredictionKey = 0;
+}
+
+void UThrowComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	//Make sure clients have the replicator before anyone throws, so the first predicted throw can be drawn
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		if (UProjectileManager* ProjectileManager = GetWorld()->GetSubsystem<UProjectileManager>())
+		{
+			ProjectileManager->GetReplicator();
+		}
+	}
+}
+
+void UThrowComponent::Throw(class UThrowableItem* Item, const FVector& Origin, const FVector& Direction)
+{
+	if (!Item || !Item->ThrowableClass)
+	{
+		return;
+	}
+
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		if (CanThrow(Item, Origin))
+		{
+			Item->Throw(GetOwner(), Origin, Direction);
+			MulticastPlayTossAnimation(Item->ThrowableTossAnimation);
+
+			if (Item->OwningInventory)
+			{
+				Item->OwningInventory->ConsumeItem(Item, 1);
+			}
+		}
+		return;
+	}
+
+	//Skip 0 when the key wraps, it means the throw wasn't predicted
+	if (++LastPredictionKey == 0)
+	{
+		++LastPredictionKey;
+	}
+
+	//Simulate from the values the server will receive, so both start the throw from the same place
+	const FVector QuantizedOrigin = Origin.GridSnap(1.f);
+	const FVector NormalizedDirection = Direction.GetSafeNormal();
+
+	if (UProjectileManager* ProjectileManager = GetWorld()->GetSubsystem<UProjectileManager>())
+	{
+		ProjectileManager->SpawnPredictedProjectile(Item->ThrowableClass, QuantizedOrigin, Item->GetThrowVelocity(NormalizedDirection), GetOwner(), LastPredictionKey);
+	}
+
+	PlayTossAnimation(Item->ThrowableTossAnimation);
+
+	ServerThrow(Item, QuantizedOrigin, NormalizedDirection, LastPredictionKey);
+}
+
+void UThrowComponent::ServerThrow_Implementation(class UThrowableItem* Item, const FVector_NetQuantize& Origin, const FVector_NetQuantizeNormal& Direction, const uint16 PredictionKey)
+{
+	if (!CanThrow(Item, Origin))
+	{
+		ClientRejectThrow(PredictionKey);
+		return;
+	}
+
+	Item->Throw(GetOwner(), Origin, Direction, PredictionKey);
+	MulticastPlayTossAnimation(Item->ThrowableTossAnimation);
+	Item->OwningInventory->ConsumeItem(Item, 1);
+}
+
+bool UThrowComponent::ServerThrow_Validate(class UThrowableItem* Item, const FVector_NetQuantize& Origin, const FVector_NetQuantizeNormal& Direction, const uint16 PredictionKey)
+{
+	return PredictionKey != 0;
+}
+
+void UThrowComponent::MulticastPlayTossAnimation_Implementation(class UAnimMontage* TossAnimation)
+{
+	//The owning client played it when it predicted the throw.  A listen server's own throws weren't predicted, so it plays them here
+	const APawn* Pawn = Cast<APawn>(GetOwner());
+	if (Pawn && Pawn->IsLocallyControlled() && GetOwnerRole() != ROLE_Authority)
+	{
+		return;
+	}
+
+	PlayTossAnimation(TossAnimation);
+}
+
+void UThrowComponent::PlayTossAnimation(class UAnimMontage* TossAnimation)
+{
+	ACharacter* Character = Cast<ACharacter>(GetOwner());
+
+	if (Character && TossAnimation)
+	{
+		Character->PlayAnimMontage(TossAnimation);
+	}
+}
+
+void UThrowComponent::ClientRejectThrow_Implementation(const uint16 PredictionKey)
+{
+	if (UProjectileManager* ProjectileManager = GetWorld()->GetSubsystem<UProjectileManager>())
+	{
+		ProjectileManager->RemoveProjectile(UProjectileManager::GetPredictedProjectileId(PredictionKey));
+	}
+}
+
+bool UThrowComponent::CanThrow(class UThrowableItem* Item, const FVector& Origin) const
+{
+	const AActor* Owner = GetOwner();
+
+	//Only throw items we actually have.  A removed item keeps its OwningInventory, so check it is still in there and not used up
+	if (!Owner || !Item || !Item->ThrowableClass || !Item->OwningInventory || Item->OwningInventory->GetOwner() != Owner
+		|| Item->GetQuantity() <= 0 || !Item->OwningInventory->GetItems().Contains(Item))
+	{
+		return false;
+	}
+
+	return FVector::DistSquared(Owner->GetActorLocation(), Origin) <= FMath::Square(MaxThrowOriginDistance);
+}
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ThrowComponent.generated.h"
+
+/**
+ * Lets a player throw throwable items without waiting on the server.  The owning client starts simulating the throw straight
+ * away under a prediction key and asks the server to throw it for real.  The servers projectile spawn event carries the same
+ * key, so the owning client takes over its own projectile instead of drawing a second one.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class SURVIVALGAME_API UThrowComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:	
+	// Sets default values for this component's properties
+	UThrowComponent();
+
+	/* [owning client or server] Throw a throwable item from Origin towards Direction */
+	UFUNCTION(BlueprintCallable, Category = "Throwable")
+	void Throw(class UThrowableItem* Item, const FVector& Origin, const FVector& Direction);
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerThrow(class UThrowableItem* Item, const FVector_NetQuantize& Origin, const FVector_NetQuantizeNormal& Direction, const uint16 PredictionKey);
+
+	/* Play the toss montage for a throw the server accepted, on everyone but the owning client that predicted it */
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastPlayTossAnimation(class UAnimMontage* TossAnimation);
+
+	void PlayTossAnimation(class UAnimMontage* TossAnimation);
+
+	/* The server didn't accept a predicted throw, remove it */
+	UFUNCTION(Client, Reliable)
+	void ClientRejectThrow(const uint16 PredictionKey);
+
+	/* [server] Check a throw the client asked for is one it could actually make */
+	bool CanThrow(class UThrowableItem* Item, const FVector& Origin) const;
+
+	//How far from the thrower the server accepts a throw starting from, to allow for the hand being away from the actor location
+	UPROPERTY(EditDefaultsOnly, Category = "Throwable")
+	float MaxThrowOriginDistance;
+
+	//The last prediction key we threw with.  0 is never used, it means "not predicted"
+	uint16 LastPredictionKey;
+
+};
@@ -1,17 +1,17 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "../Items/EquippableItem.h"
-#include "AmmoItem.generated.h"
-
-/**
- * 
- */
-UCLASS(Blueprintable)
-class SURVIVALGAME_API UAmmoItem : public UEquippableItem
-{
-	GENERATED_BODY()
-	
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "../Items/EquippableItem.h"
+#include "AmmoItem.generated.h"
+
+/**
+ * 
+ */
+UCLASS(Blueprintable)
+class SURVIVALGAME_API UAmmoItem : public UEquippableItem
+{
+	GENERATED_BODY()
+	
+};
@@ -1,104 +1,119 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "EquippableItem.h"
-#include "Net/UnrealNetwork.h"
-#include "../Player/SurvivalCharacter.h"
-#include "../Components/InventoryComponent.h"
-
-#define LOCTEXT_NAMESPACE "EquippableItem"
-
-UEquippableItem::UEquippableItem()
-{
-	bStackable = false;
-	bEquipped = false;
-	UseActionText = LOCTEXT("ItemUseActionText", "Equip");
-}
-
-void UEquippableItem::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const
-{
-	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-
-	DOREPLIFETIME(UEquippableItem, bEquipped);
-}
-
-void UEquippableItem::Use(class ASurvivalCharacter* Character)
-{
-	if (Character && Character->HasAuthority())
-	{
-		if (Character->GetEquippedItems().Contains(Slot) && !bEquipped)
-		{
-			UEquippableItem* AlreadyEquippedItem = *Character->GetEquippedItems().Find(Slot);
-
-			AlreadyEquippedItem->SetEquipped(false);
-		}
-
-		SetEquipped(!IsEquipped());
-	}
-}
-
-bool UEquippableItem::Equip(class ASurvivalCharacter* Character)
-{
-	if (Character)
-	{
-		return Character->EquipItem(this);
-	}
-	return false;
-}
-
-bool UEquippableItem::UnEquip(class ASurvivalCharacter* Character)
-{
-	if (Character)
-	{
-		return Character->UnEquipItem(this);
-	}
-	return false;
-}
-
-bool UEquippableItem::ShouldShowInInventory() const
-{
-	return !bEquipped;
-}
-
-void UEquippableItem::AddedToInventory(class UInventoryComponent* Inventory)
-{
-	//If the player looted an item don't equip it
-	if (ASurvivalCharacter* Character = Cast<ASurvivalCharacter>(Inventory->GetOwner()))
-	{
-		if (Character && !Character->bIsLooting())
-		{
-			//If we take an equippable, and don't have an item equipped at its slot, then auto equip it
-			if (!Character->GetEquippedItems().Contains(Slot))
-			{
-				SetEquipped(true);
-			}
-		}
-	}
-}
-
-void UEquippableItem::SetEquipped(bool bNewEquipped)
-{
-	bEquipped = bNewEquipped;
-	EquipStatusChanged();
-	MarkDirtyForReplication();
-}
-
-void UEquippableItem::EquipStatusChanged()
-{
-	if (ASurvivalCharacter* Character = Cast<ASurvivalCharacter>(GetOuter()))
-	{
-		if (bEquipped)
-		{
-			Equip(Character);
-		}
-		else
-		{
-			UnEquip(Character);
-		}
-	}
-
-	//Tell UI to update
-	OnItemModified.Broadcast();
-}
-
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EquippableItem.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "../Player/SurvivalCharacter.h"
+#include "../Components/InventoryComponent.h"
+#include "../Components/EquipmentComponent.h"
+
+#define LOCTEXT_NAMESPACE "EquippableItem"
+
+UEquippableItem::UEquippableItem()
+{
+	bStackable = false;
+	bEquipped = false;
+	UseActionText = LOCTEXT("ItemUseActionText", "Equip");
+}
+
+void UEquippableItem::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UEquippableItem, bEquipped, Params);
+}
+
+void UEquippableItem::Use(class ASurvivalCharacter* Character)
+{
+	if (Character && Character->HasAuthority())
+	{
+		UEquippableItem* AlreadyEquippedItem = Character->GetEquippedItems().FindRef(Slot);
+
+		if (AlreadyEquippedItem && !bEquipped)
+		{
+			AlreadyEquippedItem->SetEquipped(false);
+		}
+
+		SetEquipped(!IsEquipped());
+	}
+}
+
+bool UEquippableItem::Equip(class ASurvivalCharacter* Character)
+{
+	if (Character && Character->EquipItem(this))
+	{
+		//The equipment component mirrors the characters equipped items by slot, and applies their stat modifiers
+		if (UEquipmentComponent* Equipment = Character->FindComponentByClass<UEquipmentComponent>())
+		{
+			Equipment->EquipItem(this);
+		}
+		return true;
+	}
+	return false;
+}
+
+bool UEquippableItem::UnEquip(class ASurvivalCharacter* Character)
+{
+	if (Character && Character->UnEquipItem(this))
+	{
+		if (UEquipmentComponent* Equipment = Character->FindComponentByClass<UEquipmentComponent>())
+		{
+			Equipment->UnEquipItem(this);
+		}
+		return true;
+	}
+	return false;
+}
+
+bool UEquippableItem::ShouldShowInInventory() const
+{
+	return !bEquipped;
+}
+
+void UEquippableItem::AddedToInventory(class UInventoryComponent* Inventory)
+{
+	//If the player looted an item don't equip it
+	if (ASurvivalCharacter* Character = Cast<ASurvivalCharacter>(Inventory->GetOwner()))
+	{
+		if (Character && !Character->bIsLooting())
+		{
+			//If we take an equippable, and don't have an item equipped at its slot, then auto equip it
+			if (!Character->GetEquippedItems().FindRef(Slot))
+			{
+				SetEquipped(true);
+			}
+		}
+	}
+}
+
+void UEquippableItem::SetEquipped(bool bNewEquipped)
+{
+	bEquipped = bNewEquipped;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UEquippableItem, bEquipped, this);
+	EquipStatusChanged();
+	MarkDirtyForReplication();
+}
+
+void UEquippableItem::EquipStatusChanged()
+{
+	if (ASurvivalCharacter* Character = Cast<ASurvivalCharacter>(GetOuter()))
+	{
+		if (bEquipped)
+		{
+			Equip(Character);
+		}
+		else
+		{
+			UnEquip(Character);
+		}
+	}
+
+	//Tell UI to update
+	OnItemModified.Broadcast();
+}
+
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
@@ -1,52 +1,74 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "FoodItem.h"
-#include "../Player/SurvivalCharacter.h"
-#include "../Player/SurvivalPlayerController.h"
-#include "../Components/InventoryComponent.h"
-
-#define LOCTEXT_NAMESPACE "FoodItem"
-
-UFoodItem::UFoodItem()
-{
-	HealAmount = 20.0f;
-	UseActionText = LOCTEXT("ItemUseActionText", "Consume");
-}
-
-void UFoodItem::Use(class ASurvivalCharacter* Character)
-{
-	if (Character)
-	{
-		const float ActualHealedAmount = Character->ModifyHealth(HealAmount);
-		const bool bUsedFood = !FMath::IsNearlyZero(ActualHealedAmount);
-
-		if (!Character->HasAuthority())
-		{
-			if (ASurvivalPlayerController* PC = Cast<ASurvivalPlayerController>(Character->GetController()))
-			{
-				if (bUsedFood)
-				{
-					PC->ClientShowNotification(FText::Format(LOCTEXT("AteFoodText", "Ate {FoodName}, healed {HealAmount}, health."), ItemDisplayName, ActualHealedAmount));
-				}
-				else
-				{
-					PC->ClientShowNotification(FText::Format(LOCTEXT("FullHealthText", "No need to eat {FoodName}, health is already full."), ItemDisplayName, HealAmount));
-				}
-			}
-		}
-
-		if (bUsedFood)
-		{
-			if (UInventoryComponent* Inventory = Character->PlayerInventory)
-			{
-				Inventory->ConsumeItem(this, 1);
-			}
-		}
-	}
-
-	
-	
-}
-
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FoodItem.h"
+#include "../Player/SurvivalCharacter.h"
+#include "../Player/SurvivalPlayerController.h"
+#include "../Components/InventoryComponent.h"
+#include "../Components/SurvivalEffectsComponent.h"
+#include "../Components/SurvivalNeedsComponent.h"
+#include "../SurvivalEffectManager.h"
+
+#define LOCTEXT_NAMESPACE "FoodItem"
+
+UFoodItem::UFoodItem()
+{
+	HealAmount = 20.0f;
+	HungerRestored = 30.0f;
+	ThirstRestored = 0.0f;
+	UseActionText = LOCTEXT("ItemUseActionText", "Consume");
+}
+
+void UFoodItem::Use(class ASurvivalCharacter* Character)
+{
+	//Only the server eats, the owner is told how it went
+	if (!Character || !Character->HasAuthority())
+	{
+		return;
+	}
+
+	const float ActualHealedAmount = Character->ModifyHealth(HealAmount);
+	USurvivalNeedsComponent* Needs = Character->FindComponentByClass<USurvivalNeedsComponent>();
+	const float ActualRestoredAmount = Needs ? Needs->Consume(HungerRestored, ThirstRestored) : 0.f;
+
+	//Effects are applied under our class defaults, so eating the same food again restarts them instead of stacking
+	bool bStartedEffects = false;
+	USurvivalEffectManager* EffectManager = Character->GetWorld()->GetSubsystem<USurvivalEffectManager>();
+	USurvivalEffectsComponent* CharacterEffects = Character->FindComponentByClass<USurvivalEffectsComponent>();
+	if (EffectManager && CharacterEffects)
+	{
+		for (int32 i = 0; i < Effects.Num(); ++i)
+		{
+			EffectManager->ApplyEffect(CharacterEffects, GetClass()->GetDefaultObject(), Effects[i], i);
+			bStartedEffects = true;
+		}
+	}
+
+	const bool bUsedFood = !FMath::IsNearlyZero(ActualHealedAmount) || !FMath::IsNearlyZero(ActualRestoredAmount) || bStartedEffects;
+
+	if (ASurvivalPlayerController* PC = Cast<ASurvivalPlayerController>(Character->GetController()))
+	{
+		if (!FMath::IsNearlyZero(ActualHealedAmount))
+		{
+			PC->ClientShowNotification(FText::Format(LOCTEXT("AteFoodText", "Ate {FoodName}, healed {HealAmount}, health."), ItemDisplayName, ActualHealedAmount));
+		}
+		else if (bUsedFood)
+		{
+			PC->ClientShowNotification(FText::Format(LOCTEXT("AteFoodNeedsText", "Ate {FoodName}."), ItemDisplayName));
+		}
+		else
+		{
+			PC->ClientShowNotification(FText::Format(LOCTEXT("FullHealthText", "No need to eat {FoodName}, health and needs are already full."), ItemDisplayName, HealAmount));
+		}
+	}
+
+	if (bUsedFood)
+	{
+		if (UInventoryComponent* Inventory = Character->PlayerInventory)
+		{
+			Inventory->ConsumeItem(this, 1);
+		}
+	}
+}
+
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
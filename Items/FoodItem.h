@@ -1,27 +1,40 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "SurvivalGame\Items\Item.h"
-#include "FoodItem.generated.h"
-
-/**
- * 
- */
-UCLASS()
-class SURVIVALGAME_API UFoodItem : public UItem
-{
-	GENERATED_BODY()
-
-public:
-
-	UFoodItem();
-
-	//The amount for the food to heal
-	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Healing")
-	float HealAmount;
-
-	virtual void Use(class ASurvivalCharacter* Character) override;
-	
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SurvivalGame\Items\Item.h"
+#include "../Components/SurvivalEffectsComponent.h"
+#include "FoodItem.generated.h"
+
+/**
+ * 
+ */
+UCLASS()
+class SURVIVALGAME_API UFoodItem : public UItem
+{
+	GENERATED_BODY()
+
+public:
+
+	UFoodItem();
+
+	//The amount for the food to heal straight away.  Use an effect to heal over time
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Healing")
+	float HealAmount;
+
+	//The amount of hunger eating this restores
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Needs")
+	float HungerRestored;
+
+	//The amount of thirst eating this restores.  Drinks are food that restore thirst
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Needs")
+	float ThirstRestored;
+
+	//Effects eating this starts, like healing over time or buffs
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Effects")
+	TArray<FSurvivalEffect> Effects;
+
+	virtual void Use(class ASurvivalCharacter* Character) override;
+	
+};
@@ -1,34 +1,43 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "GearItem.h"
-#include "../Player/SurvivalCharacter.h"
-
-UGearItem::UGearItem()
-{
-	DamageDefenceMultiplier = 0.10f;
-}
-
-bool UGearItem::Equip(class ASurvivalCharacter* Character)
-{
-	bool bEquipSuccessful = Super::Equip(Character);
-
-	if (bEquipSuccessful && Character)
-	{
-		Character->EquipGear(this);
-	}
-
-	return bEquipSuccessful;
-}
-
-bool UGearItem::UnEquip(class ASurvivalCharacter* Character)
-{
-	bool bUnEquipSuccessful = Super::UnEquip(Character);
-
-	if (bUnEquipSuccessful && Character)
-	{
-		Character->UnEquipGear(Slot);
-	}
-
-	return bUnEquipSuccessful;
-}
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GearItem.h"
+#include "../Player/SurvivalCharacter.h"
+#include "../Components/EquipmentComponent.h"
+
+UGearItem::UGearItem()
+{
+	DamageDefenceMultiplier = 0.10f;
+	CarryCapacityBonus = 0.f;
+	SlotCapacityBonus = 0;
+}
+
+bool UGearItem::Equip(class ASurvivalCharacter* Character)
+{
+	bool bEquipSuccessful = Super::Equip(Character);
+
+	if (bEquipSuccessful && Character)
+	{
+		Character->EquipGear(this);
+	}
+
+	return bEquipSuccessful;
+}
+
+bool UGearItem::UnEquip(class ASurvivalCharacter* Character)
+{
+	bool bUnEquipSuccessful = Super::UnEquip(Character);
+
+	if (bUnEquipSuccessful && Character)
+	{
+		Character->UnEquipGear(Slot);
+	}
+
+	return bUnEquipSuccessful;
+}
+
+float UGearItem::GetTotalDamageDefence(const class ASurvivalCharacter* Character)
+{
+	const UEquipmentComponent* Equipment = Character ? Character->FindComponentByClass<UEquipmentComponent>() : nullptr;
+	return Equipment ? Equipment->GetDamageDefence() : 0.f;
+}
@@ -1,35 +1,46 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "../Items/EquippableItem.h"
-#include "GearItem.generated.h"
-
-/**
- * 
- */
-UCLASS(Blueprintable)
-class SURVIVALGAME_API UGearItem : public UEquippableItem
-{
-	GENERATED_BODY()
-
-public:
-
-	UGearItem();
-
-	virtual bool Equip(class ASurvivalCharacter* Character) override;
-	virtual bool UnEquip(class ASurvivalCharacter* Character) override;
-	
-	/*The skeletal mesh for this gear*/
-	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Gear")
-	class USkeletalMesh* Mesh;
-
-	/*Optional material instance to apply to the gear*/
-	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Gear")
-	class UMaterialInstance* MaterialInstance;
-
-	/*The amount of defence this item provides.  0.2 = 20% less damage taken*/
-	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Gear", meta = (ClampMin = 0.0, ClampMax = 1.0))
-	float DamageDefenceMultiplier;
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "../Items/EquippableItem.h"
+#include "GearItem.generated.h"
+
+/**
+ * 
+ */
+UCLASS(Blueprintable)
+class SURVIVALGAME_API UGearItem : public UEquippableItem
+{
+	GENERATED_BODY()
+
+public:
+
+	UGearItem();
+
+	virtual bool Equip(class ASurvivalCharacter* Character) override;
+	virtual bool UnEquip(class ASurvivalCharacter* Character) override;
+
+	/*The fraction of damage a characters equipped gear blocks, cached by the characters equipment component*/
+	static float GetTotalDamageDefence(const class ASurvivalCharacter* Character);
+	
+	/*The skeletal mesh for this gear. Merged with the rest of the characters gear, so it needs Allow CPU Access set*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Gear")
+	class USkeletalMesh* Mesh;
+
+	/*Optional material instance to apply to the gear*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Gear")
+	class UMaterialInstance* MaterialInstance;
+
+	/*The amount of defence this item provides.  0.2 = 20% less damage taken*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Gear", meta = (ClampMin = 0.0, ClampMax = 1.0))
+	float DamageDefenceMultiplier;
+
+	/*The extra weight the wearer can carry, i.e. for backpacks*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Gear", meta = (ClampMin = 0.0))
+	float CarryCapacityBonus;
+
+	/*The extra items the wearer can carry*/
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Gear", meta = (ClampMin = 0))
+	int32 SlotCapacityBonus;
+};
@@ -1,94 +1,118 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "Item.h"
-#include "../Components/InventoryComponent.h"
-#include "Net/UnrealNetwork.h"
-
-#define LOCTEXT_NAMESPACE "Item"
-
-void UItem::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty> & OutLifetimeProps) const
-{
-	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-
-	DOREPLIFETIME(UItem, Quantity);
-}
-
-bool UItem::IsSupportedForNetworking() const
-{
-	return true;
-}
-
-class UWorld* UItem::GetWorld() const
-{
-	return World;
-}
-
-#if WITH_EDITOR
-void UItem::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
-{
-	Super::PostEditChangeProperty(PropertyChangedEvent);
-
-	FName ChangedPropertyName = PropertyChangedEvent.Property ? PropertyChangedEvent.Property->GetFName() : NAME_None;
-
-	//UPROPERTY clamping doesn't support using a variable to clamp so we do in here instead
-	if (ChangedPropertyName == GET_MEMBER_NAME_CHECKED(UItem, Quantity))
-	{
-		Quantity = FMath::Clamp(Quantity, 1, bStackable ? MaxStackSize : 1);
-	}
-}
-#endif
-
-UItem::UItem()
-{
-	ItemDisplayName = LOCTEXT("ItemName", "Item");
-	UseActionText = LOCTEXT("ItemUseActionText", "Use");
-	Weight = 0.0f;
-	bStackable = true;
-	Quantity = 1;
-	MaxStackSize = 2;
-	RepKey = 0;
-}
-
-void UItem::OnRep_Quantity()
-{
-	OnItemModified.Broadcast();
-}
-
-void UItem::SetQuantity(const int32 NewQuantity)
-{
-	if (NewQuantity != Quantity)
-	{
-		Quantity = FMath::Clamp(NewQuantity, 0, bStackable ? MaxStackSize : 1);
-		MarkDirtyForReplication();
-	}
-}
-
-bool UItem::ShouldShowInInventory() const
-{
-	return true;
-}
-
-void UItem::Use(class ASurvivalCharacter* Character)
-{
-
-}
-
-void UItem::AddedToInventory(class UInventoryComponent* Inventory)
-{
-
-}
-
-void UItem::MarkDirtyForReplication()
-{
-	//Mark this object for replication
-	++RepKey;
-
-	//Mark array for replication
-	if (OwningInventory)
-	{
-		++OwningInventory->ReplicatedItemsKey;
-	}
-}
-
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Item.h"
+#include "../Components/InventoryComponent.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+#define LOCTEXT_NAMESPACE "Item"
+
+void UItem::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty> & OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UItem, Quantity, Params);
+}
+
+bool UItem::IsSupportedForNetworking() const
+{
+	return true;
+}
+
+class UWorld* UItem::GetWorld() const
+{
+	return World;
+}
+
+#if WITH_EDITOR
+void UItem::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	FName ChangedPropertyName = PropertyChangedEvent.Property ? PropertyChangedEvent.Property->GetFName() : NAME_None;
+
+	//UPROPERTY clamping doesn't support using a variable to clamp so we do in here instead
+	if (ChangedPropertyName == GET_MEMBER_NAME_CHECKED(UItem, Quantity))
+	{
+		Quantity = FMath::Clamp(Quantity, 1, bStackable ? MaxStackSize : 1);
+	}
+}
+#endif
+
+UItem::UItem()
+{
+	ItemDisplayName = LOCTEXT("ItemName", "Item");
+	UseActionText = LOCTEXT("ItemUseActionText", "Use");
+	Weight = 0.0f;
+	bStackable = true;
+	Quantity = 1;
+	MaxStackSize = 2;
+	RepKey = 0;
+}
+
+void UItem::OnRep_Quantity(const int32 OldQuantity)
+{
+	OnItemModified.Broadcast();
+
+	if (OwningInventory)
+	{
+		OwningInventory->NotifyItemQuantityChanged(this, Quantity - OldQuantity);
+	}
+}
+
+void UItem::SetQuantity(const int32 NewQuantity)
+{
+	if (NewQuantity != Quantity)
+	{
+		const int32 OldQuantity = Quantity;
+
+		Quantity = FMath::Clamp(NewQuantity, 0, bStackable ? MaxStackSize : 1);
+		MarkDirtyForReplication();
+
+		if (OwningInventory)
+		{
+			OwningInventory->NotifyItemQuantityChanged(this, Quantity - OldQuantity);
+		}
+	}
+}
+
+bool UItem::ShouldShowInInventory() const
+{
+	return true;
+}
+
+void UItem::Use(class ASurvivalCharacter* Character)
+{
+
+}
+
+void UItem::AddedToInventory(class UInventoryComponent* Inventory)
+{
+
+}
+
+void UItem::RemovedFromInventory(class UInventoryComponent* Inventory)
+{
+
+}
+
+void UItem::MarkDirtyForReplication()
+{
+	//Quantity is push based, so it's only compared when we say it changed
+	MARK_PROPERTY_DIRTY_FROM_NAME(UItem, Quantity, this);
+
+	//Mark this object for replication
+	++RepKey;
+
+	//Mark array for replication
+	if (OwningInventory)
+	{
+		++OwningInventory->ReplicatedItemsKey;
+	}
+}
+
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
@@ -1,9 +1,38 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "ThrowableItem.h"
-
-UThrowableItem::UThrowableItem()
-{
-
-}
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ThrowableItem.h"
+#include "../Weapons/ProjectileManager.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "Engine/World.h"
+
+UThrowableItem::UThrowableItem()
+{
+
+}
+
+int32 UThrowableItem::Throw(AActor* Thrower, const FVector& Origin, const FVector& Direction, const uint16 PredictionKey)
+{
+	UWorld* World = Thrower ? Thrower->GetWorld() : nullptr;
+
+	if (!ThrowableClass || !World)
+	{
+		return INDEX_NONE;
+	}
+
+	//Throwables are simulated by the projectile manager rather than spawned as actors
+	if (UProjectileManager* ProjectileManager = World->GetSubsystem<UProjectileManager>())
+	{
+		return ProjectileManager->SpawnProjectile(ThrowableClass, Origin, GetThrowVelocity(Direction), Thrower, PredictionKey);
+	}
+
+	return INDEX_NONE;
+}
+
+FVector UThrowableItem::GetThrowVelocity(const FVector& Direction) const
+{
+	const UProjectileMovementComponent* Movement = ThrowableClass ? ThrowableClass->GetDefaultObject<AThrowableWeapon>()->GetThrowableMovement() : nullptr;
+	const float ThrowSpeed = Movement ? Movement->InitialSpeed : 1000.f;
+
+	return Direction.GetSafeNormal() * ThrowSpeed;
+}
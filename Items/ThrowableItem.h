@@ -1,29 +1,36 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "../Items/EquippableItem.h"
-#include "../Weapons/ThrowableWeapon.h"
-#include "ThrowableItem.generated.h"
-
-/**
- * 
- */
-UCLASS(Blueprintable)
-class SURVIVALGAME_API UThrowableItem : public UEquippableItem
-{
-	GENERATED_BODY()
-
-public:
-	UThrowableItem();
-
-	//The montage to play when we toss a throwable
-	UPROPERTY(EditDefaultsOnly, Category = "Weapons")
-	class UAnimMontage* ThrowableTossAnimation;
-
-	//The actor to spawn in when we throw the item. (i.e. grenade actor, molotov actor, etc.)
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
-	TSubclassOf<class AThrowableWeapon> ThrowableClass;
-	
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "../Items/EquippableItem.h"
+#include "../Weapons/ThrowableWeapon.h"
+#include "ThrowableItem.generated.h"
+
+/**
+ * 
+ */
+UCLASS(Blueprintable)
+class SURVIVALGAME_API UThrowableItem : public UEquippableItem
+{
+	GENERATED_BODY()
+
+public:
+	UThrowableItem();
+
+	/* [server] Throw this item from Origin towards Direction, at the throwables initial speed.  Returns the thrown projectile's id.
+	Players throw through UThrowComponent, which predicts the throw on the owning client and passes its prediction key along */
+	int32 Throw(AActor* Thrower, const FVector& Origin, const FVector& Direction, const uint16 PredictionKey = 0);
+
+	/* The velocity a throw towards Direction leaves the hand with */
+	FVector GetThrowVelocity(const FVector& Direction) const;
+
+	//The montage to play when we toss a throwable
+	UPROPERTY(EditDefaultsOnly, Category = "Weapons")
+	class UAnimMontage* ThrowableTossAnimation;
+
+	//The actor to spawn in when we throw the item. (i.e. grenade actor, molotov actor, etc.)
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
+	TSubclassOf<class AThrowableWeapon> ThrowableClass;
+	
+};
@@ -1,35 +1,93 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "WeaponItem.h"
-#include "../Player/SurvivalPlayerController.h"
-#include "../Player/SurvivalCharacter.h"
-
-UWeaponItem::UWeaponItem()
-{
-
-}
-
-bool UWeaponItem::Equip(class ASurvivalCharacter* Character)
-{
-	bool bEquipSuccessful = Super::Equip(Character);
-
-	if (bEquipSuccessful && Character)
-	{
-		Character->EquipWeapon(this);
-	}
-
-	return bEquipSuccessful;
-}
-
-bool UWeaponItem::UnEquip(class ASurvivalCharacter* Character)
-{
-	bool bUnEquipSuccessful = Super::UnEquip(Character);
-
-	if (bUnEquipSuccessful && Character)
-	{
-		Character->UnEquipWeapon();
-	}
-
-	return bUnEquipSuccessful;
-}
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WeaponItem.h"
+#include "../Player/SurvivalPlayerController.h"
+#include "../Player/SurvivalCharacter.h"
+#include "../Weapons/Weapon.h"
+#include "Engine/World.h"
+
+UWeaponItem::UWeaponItem()
+{
+	Weapon = nullptr;
+}
+
+bool UWeaponItem::Equip(class ASurvivalCharacter* Character)
+{
+	bool bEquipSuccessful = Super::Equip(Character);
+
+	if (bEquipSuccessful && Character)
+	{
+		Character->EquipWeapon(this);
+	}
+
+	return bEquipSuccessful;
+}
+
+bool UWeaponItem::UnEquip(class ASurvivalCharacter* Character)
+{
+	bool bUnEquipSuccessful = Super::UnEquip(Character);
+
+	if (bUnEquipSuccessful && Character)
+	{
+		Character->UnEquipWeapon();
+	}
+
+	return bUnEquipSuccessful;
+}
+
+void UWeaponItem::RemovedFromInventory(class UInventoryComponent* Inventory)
+{
+	Super::RemovedFromInventory(Inventory);
+
+	//Once the item has been dropped or taken the weapon can't be equipped again, so there is no point keeping it
+	DestroyWeapon();
+}
+
+AWeapon* UWeaponItem::GetOrSpawnWeapon(class ASurvivalCharacter* Character)
+{
+	if (!Character || !Character->HasAuthority() || !WeaponClass)
+	{
+		return nullptr;
+	}
+
+	if (Weapon && !Weapon->IsPendingKillPending() && Weapon->GetPawnOwner() == Character)
+	{
+		return Weapon;
+	}
+
+	DestroyWeapon();
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = Character;
+	SpawnParams.Instigator = Character;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	Weapon = Character->GetWorld()->SpawnActor<AWeapon>(WeaponClass, SpawnParams);
+
+	if (Weapon)
+	{
+		Weapon->SetItem(this);
+		Character->OnDestroyed.AddUniqueDynamic(this, &UWeaponItem::OnCharacterDestroyed);
+	}
+
+	return Weapon;
+}
+
+void UWeaponItem::DestroyWeapon()
+{
+	if (Weapon)
+	{
+		if (Weapon->HasAuthority() && !Weapon->IsPendingKillPending())
+		{
+			Weapon->Destroy();
+		}
+
+		Weapon = nullptr;
+	}
+}
+
+void UWeaponItem::OnCharacterDestroyed(AActor* DestroyedActor)
+{
+	DestroyWeapon();
+}
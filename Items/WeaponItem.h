@@ -1,26 +1,44 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "../Items/EquippableItem.h"
-#include "WeaponItem.generated.h"
-
-/**
- * 
- */
-UCLASS(Blueprintable)
-class SURVIVALGAME_API UWeaponItem : public UEquippableItem
-{
-	GENERATED_BODY()
-
-public:
-	UWeaponItem();
-
-	virtual bool Equip(class ASurvivalCharacter* Character) override;
-	virtual bool UnEquip(class ASurvivalCharacter* Character) override;
-
-	//The weapon class to give to the player upon equipping this weapon item
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
-	TSubclassOf<class AWeapon> WeaponClass;
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "../Items/EquippableItem.h"
+#include "WeaponItem.generated.h"
+
+/**
+ * 
+ */
+UCLASS(Blueprintable)
+class SURVIVALGAME_API UWeaponItem : public UEquippableItem
+{
+	GENERATED_BODY()
+
+public:
+	UWeaponItem();
+
+	virtual bool Equip(class ASurvivalCharacter* Character) override;
+	virtual bool UnEquip(class ASurvivalCharacter* Character) override;
+	virtual void RemovedFromInventory(class UInventoryComponent* Inventory) override;
+
+	/**[server] Get the weapon actor for this item.  The actor is kept (holstered and dormant) after unequipping, so equipping
+	this item again reuses it and its clip instead of spawning a new weapon.  EquipWeapon should call this rather than spawning. */
+	class AWeapon* GetOrSpawnWeapon(class ASurvivalCharacter* Character);
+
+	/**[server] Destroy the cached weapon actor, which returns its clip to the inventory */
+	void DestroyWeapon();
+
+	//The weapon class to give to the player upon equipping this weapon item
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon")
+	TSubclassOf<class AWeapon> WeaponClass;
+
+protected:
+
+	//The weapon actor we spawned for this item
+	UPROPERTY(Transient)
+	class AWeapon* Weapon;
+
+	//Don't leave our weapon lying around holstered if the character that owns it goes away
+	UFUNCTION()
+	void OnCharacterDestroyed(AActor* DestroyedActor);
+};
@@ -1,61 +1,143 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "SurvivalCharacter.h"
-#include <Camera/CameraComponent.h>
-#include <Components/SkeletalMeshComponent.h>
-
-// Sets default values
-ASurvivalCharacter::ASurvivalCharacter()
-{
- 	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
-
-	CameraComponent = CreateDefaultSubobject<UCameraComponent>("CameraComonent");
-	CameraComponent->SetupAttachment(GetMesh());
-	CameraComponent->bUsePawnControlRotation = true;
-
-	HelmetMesh = CreateDefaultSubobject<USkeletalMeshComponent>("HelmetMesh");
-	HelmetMesh->SetupAttachment(GetMesh());
-
-	ChestMesh = CreateDefaultSubobject<USkeletalMeshComponent>("ChestMesh");
-	ChestMesh->SetupAttachment(GetMesh());
-
-	LegsMesh = CreateDefaultSubobject<USkeletalMeshComponent>("LegsMesh");
-	LegsMesh->SetupAttachment(GetMesh());
-
-	FeetMesh = CreateDefaultSubobject<USkeletalMeshComponent>("FeetMesh");
-	FeetMesh->SetupAttachment(GetMesh());
-
-	VestMesh = CreateDefaultSubobject<USkeletalMeshComponent>("VestMesh");
-	VestMesh->SetupAttachment(GetMesh());
-
-	HandsMesh = CreateDefaultSubobject<USkeletalMeshComponent>("HandsMesh");
-	HandsMesh->SetupAttachment(GetMesh());
-
-	BackpackMesh = CreateDefaultSubobject<USkeletalMeshComponent>("BackpackMesh");
-	BackpackMesh->SetupAttachment(GetMesh());
-
-}
-
-// Called when the game starts or when spawned
-void ASurvivalCharacter::BeginPlay()
-{
-	Super::BeginPlay();
-	
-}
-
-// Called every frame
-void ASurvivalCharacter::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-
-}
-
-// Called to bind functionality to input
-void ASurvivalCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
-{
-	Super::SetupPlayerInputComponent(PlayerInputComponent);
-
-}
-
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SurvivalCharacter.h"
+#include <Camera/CameraComponent.h>
+#include <Components/SkeletalMeshComponent.h>
+#include "CharacterSignificanceSubsystem.h"
+#include "Components/EquipmentComponent.h"
+#include "Components/GearMeshComponent.h"
+#include "Components/StatsComponent.h"
+#include "Components/SurvivalEffectsComponent.h"
+#include "Components/SurvivalNeedsComponent.h"
+#include "Items/GearItem.h"
+
+// Sets default values
+ASurvivalCharacter::ASurvivalCharacter()
+{
+ 	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
+	PrimaryActorTick.bCanEverTick = true;
+
+	CameraComponent = CreateDefaultSubobject<UCameraComponent>("CameraComonent");
+	CameraComponent->SetupAttachment(GetMesh());
+	CameraComponent->bUsePawnControlRotation = true;
+
+	//The significance subsystem sets how many frames the body skips through URO, which interpolates the skipped frames
+	GetMesh()->bEnableUpdateRateOptimizations = true;
+	GetMesh()->OnAnimUpdateRateParamsCreated.BindUObject(this, &ASurvivalCharacter::OnAnimUpdateRateParamsCreated);
+
+	GearMesh = CreateDefaultSubobject<UGearMeshComponent>("GearMesh");
+	GearMesh->SetupAttachment(GetMesh());
+
+	Stats = CreateDefaultSubobject<UStatsComponent>("Stats");
+	Equipment = CreateDefaultSubobject<UEquipmentComponent>("Equipment");
+	Needs = CreateDefaultSubobject<USurvivalNeedsComponent>("Needs");
+	Effects = CreateDefaultSubobject<USurvivalEffectsComponent>("Effects");
+
+	bCosmeticAnimation = false;
+	Significance = ECharacterSignificance::High;
+
+}
+
+// Called when the game starts or when spawned
+void ASurvivalCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+	
+	if (UCharacterSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UCharacterSignificanceSubsystem>())
+	{
+		SignificanceSubsystem->RegisterCharacter(this);
+	}
+}
+
+void ASurvivalCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UCharacterSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UCharacterSignificanceSubsystem>())
+	{
+		SignificanceSubsystem->UnregisterCharacter(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ASurvivalCharacter::EquipGear(class UGearItem* Gear)
+{
+	if (Gear)
+	{
+		GearMesh->SetGear(Gear->Slot, Gear->Mesh, Gear->MaterialInstance);
+	}
+}
+
+void ASurvivalCharacter::UnEquipGear(const EEquippableSlot Slot)
+{
+	GearMesh->ClearGear(Slot);
+}
+
+void ASurvivalCharacter::SetSignificance(const ECharacterSignificance NewSignificance)
+{
+	const FCharacterUpdateRate& UpdateRate = UCharacterSignificanceSubsystem::GetUpdateRate(NewSignificance);
+
+	SetActorTickInterval(UpdateRate.TickInterval);
+
+	Significance = NewSignificance;
+	ApplyAnimationFrameSkip(Significance);
+
+	//Gear follows the bodies pose, so it skips the same frames.  Cloth is simulated per mesh though
+	for (USkeletalMeshComponent* MeshComponent : { GetMesh(), (USkeletalMeshComponent*)GearMesh })
+	{
+		if (UpdateRate.bSimulateCloth)
+		{
+			MeshComponent->ResumeClothingSimulation();
+		}
+		else
+		{
+			MeshComponent->SuspendClothingSimulation();
+		}
+	}
+}
+
+void ASurvivalCharacter::OnAnimUpdateRateParamsCreated(struct FAnimUpdateRateParameters* AnimUpdateRateParams)
+{
+	//The params are created lazily, possibly after the significance subsystem has already ranked us
+	ApplyAnimationFrameSkip(Significance);
+}
+
+void ASurvivalCharacter::ApplyAnimationFrameSkip(const ECharacterSignificance InSignificance)
+{
+	FAnimUpdateRateParameters* AnimUpdateRateParams = GetMesh()->AnimUpdateRateParams;
+
+	if (!AnimUpdateRateParams)
+	{
+		return;
+	}
+
+	const bool bCanSkipFrames = !HasAuthority() || bCosmeticAnimation;
+	const int32 FrameSkip = bCanSkipFrames ? UCharacterSignificanceSubsystem::GetUpdateRate(InSignificance).AnimationFrameSkip : 0;
+
+	//URO looks the frame skip up by LOD, so the same skip at every LOD makes it follow our significance alone
+	AnimUpdateRateParams->bShouldUseLodMap = true;
+	AnimUpdateRateParams->LODToFrameSkipMap.Reset();
+
+	for (int32 LODIndex = 0; LODIndex < FMath::Max(GetMesh()->GetNumLODs(), 1); ++LODIndex)
+	{
+		AnimUpdateRateParams->LODToFrameSkipMap.Add(LODIndex, FrameSkip);
+	}
+
+	//Off screen characters are already Hidden, which has the most frame skip
+	AnimUpdateRateParams->BaseNonRenderedUpdateRate = FrameSkip + 1;
+}
+
+// Called every frame
+void ASurvivalCharacter::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+}
+
+// Called to bind functionality to input
+void ASurvivalCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
+{
+	Super::SetupPlayerInputComponent(PlayerInputComponent);
+
+}
+
@@ -1,56 +1,78 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/Character.h"
-#include "SurvivalCharacter.generated.h"
-
-UCLASS()
-class SURVIVALGAME_API ASurvivalCharacter : public ACharacter
-{
-	GENERATED_BODY()
-
-public:
-	// Sets default values for this character's properties
-	ASurvivalCharacter();
-
-	UPROPERTY(EditAnywhere, Category = "Components")
-	class UCameraComponent* CameraComponent;
-
-	UPROPERTY(EditAnywhere, Category = "Components")
-	class USkeletalMeshComponent* HelmetMesh;
-
-	UPROPERTY(EditAnywhere, Category = "Components")
-	class USkeletalMeshComponent* ChestMesh;
-
-	UPROPERTY(EditAnywhere, Category = "Components")
-	class USkeletalMeshComponent* LegsMesh;
-
-	UPROPERTY(EditAnywhere, Category = "Components")
-	class USkeletalMeshComponent* FeetMesh;
-
-	UPROPERTY(EditAnywhere, Category = "Components")
-	class USkeletalMeshComponent* VestMesh;
-
-	UPROPERTY(EditAnywhere, Category = "Components")
-	class USkeletalMeshComponent* HandsMesh;
-
-	UPROPERTY(EditAnywhere, Category = "Components")
-	class USkeletalMeshComponent* BackpackMesh;
-
-protected:
-	// Called when the game starts or when spawned
-	virtual void BeginPlay() override;
-
-	void MoveForward(float Val);
-	void MoveRight(float Val);
-
-public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
-	// Called to bind functionality to input
-	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
-
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Character.h"
+#include "SurvivalCharacter.generated.h"
+
+enum class EEquippableSlot : uint8;
+enum class ECharacterSignificance : uint8;
+
+UCLASS()
+class SURVIVALGAME_API ASurvivalCharacter : public ACharacter
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this character's properties
+	ASurvivalCharacter();
+
+	UPROPERTY(EditAnywhere, Category = "Components")
+	class UCameraComponent* CameraComponent;
+
+	/*Every piece of gear the character has equipped, merged into one mesh. Empty slots cost nothing*/
+	UPROPERTY(EditAnywhere, Category = "Components")
+	class UGearMeshComponent* GearMesh;
+
+	/*The items the character has equipped, and what their gear adds up to*/
+	UPROPERTY(EditAnywhere, Category = "Components")
+	class UEquipmentComponent* Equipment;
+
+	/*Everything items and effects do to the characters stats*/
+	UPROPERTY(EditAnywhere, Category = "Components")
+	class UStatsComponent* Stats;
+
+	/*The characters hunger, thirst and temperature, simulated by the survival needs subsystem*/
+	UPROPERTY(EditAnywhere, Category = "Components")
+	class USurvivalNeedsComponent* Needs;
+
+	/*The timed effects running on the character, like healing over time*/
+	UPROPERTY(EditAnywhere, Category = "Components")
+	class USurvivalEffectsComponent* Effects;
+
+	void EquipGear(class UGearItem* Gear);
+	void UnEquipGear(const EEquippableSlot Slot);
+
+	/*Update the character and its meshes at the rate the significance subsystem picked for it*/
+	void SetSignificance(const ECharacterSignificance NewSignificance);
+
+	/*If the bodies animation only matters for looks, so the authority can skip frames of it too.  Otherwise the authority always
+	animates every frame, since hit detection, root motion and anim notifies depend on it*/
+	UPROPERTY(EditDefaultsOnly, Category = "Significance")
+	bool bCosmeticAnimation;
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/*Point the bodies update rate optimization at our significance, rather than its screen size*/
+	void OnAnimUpdateRateParamsCreated(struct FAnimUpdateRateParameters* AnimUpdateRateParams);
+
+	/*Set the bodies animation frame skip for a significance*/
+	void ApplyAnimationFrameSkip(const ECharacterSignificance InSignificance);
+
+	ECharacterSignificance Significance;
+
+	void MoveForward(float Val);
+	void MoveRight(float Val);
+
+public:	
+	// Called every frame
+	virtual void Tick(float DeltaTime) override;
+
+	// Called to bind functionality to input
+	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
+
+};
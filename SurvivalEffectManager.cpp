@@ -0,0 +1,190 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SurvivalEffectManager.h"
+#include "SurvivalGame.h"
+#include "Components/SurvivalEffectsComponent.h"
+#include "Player/SurvivalCharacter.h"
+#include "Algo/BinarySearch.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Survival Effects Update"), STAT_SurvivalEffectsUpdate, STATGROUP_SurvivalGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Survival Effects Active"), STAT_SurvivalEffectsActive, STATGROUP_SurvivalGame);
+
+static TAutoConsoleVariable<float> CVarEffectsUpdateInterval(
+	TEXT("Survival.Effects.UpdateInterval"),
+	0.25f,
+	TEXT("Seconds between updates of every timed effect, i.e. how often healing over time and bleeding are applied."),
+	ECVF_Default);
+
+void USurvivalEffectManager::Deinitialize()
+{
+	Super::Deinitialize();
+
+	Effects.Empty();
+}
+
+void USurvivalEffectManager::Tick(float DeltaTime)
+{
+	TimeSinceUpdate += DeltaTime;
+
+	if (TimeSinceUpdate < CVarEffectsUpdateInterval.GetValueOnGameThread())
+	{
+		return;
+	}
+
+	TimeSinceUpdate = 0.f;
+
+	UpdateEffects(GetWorld()->GetTimeSeconds());
+}
+
+bool USurvivalEffectManager::IsTickable() const
+{
+	return !IsTemplate() && Effects.Num() > 0;
+}
+
+TStatId USurvivalEffectManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USurvivalEffectManager, STATGROUP_Tickables);
+}
+
+UWorld* USurvivalEffectManager::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+void USurvivalEffectManager::ApplyEffect(USurvivalEffectsComponent* Target, UObject* Source, const FSurvivalEffect& Effect, const int32 EffectIndex /*= 0*/)
+{
+	if (!Target || Target->GetOwnerRole() != ROLE_Authority || Effect.Duration <= 0.f)
+	{
+		return;
+	}
+
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	//We don't tick while there are no effects, so don't count the time before this one
+	if (!Effects.Num())
+	{
+		LastUpdateTime = Now;
+		TimeSinceUpdate = 0.f;
+	}
+
+	FManagedEffect NewEffect;
+	NewEffect.Target = Target;
+	NewEffect.Source = Source;
+	NewEffect.EffectIndex = EffectIndex;
+	NewEffect.StartTime = Now;
+	NewEffect.ExpiryTime = Now + Effect.Duration;
+	NewEffect.HealthPerSecond = Effect.HealthPerSecond;
+
+	//Restart the effect if it is already running, keeping its id so the client replaces it
+	const int32 ExistingIndex = Effects.IndexOfByPredicate([&NewEffect](const FManagedEffect& Existing)
+	{
+		return Existing.Target == NewEffect.Target && Existing.Source == NewEffect.Source && Existing.EffectIndex == NewEffect.EffectIndex;
+	});
+
+	if (ExistingIndex != INDEX_NONE)
+	{
+		//Apply what the old effect has done since the last update, so restarting doesn't lose it
+		const FManagedEffect& Existing = Effects[ExistingIndex];
+		const float Elapsed = Now - FMath::Max(LastUpdateTime, Existing.StartTime);
+
+		if (ASurvivalCharacter* Character = Cast<ASurvivalCharacter>(Target->GetOwner()))
+		{
+			if (Existing.HealthPerSecond != 0.f && Elapsed > 0.f)
+			{
+				Character->ModifyHealth(Existing.HealthPerSecond * Elapsed);
+			}
+		}
+
+		NewEffect.Id = Existing.Id;
+		Effects.RemoveAt(ExistingIndex);
+	}
+	else
+	{
+		NewEffect.Id = GetNextEffectId();
+	}
+
+	InsertEffect(NewEffect);
+	Target->StartEffect(NewEffect.Id, Source, Effect);
+}
+
+void USurvivalEffectManager::RemoveEffects(USurvivalEffectsComponent* Target)
+{
+	Effects.RemoveAll([Target](const FManagedEffect& Effect) { return Effect.Target == Target; });
+}
+
+void USurvivalEffectManager::UpdateEffects(const float Now)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SurvivalEffectsUpdate);
+	SET_DWORD_STAT(STAT_SurvivalEffectsActive, Effects.Num());
+
+	//Add up every characters health change first, so each character is healed or hurt once
+	TMap<USurvivalEffectsComponent*, float, TInlineSetAllocator<16>> HealthChanges;
+
+	for (const FManagedEffect& Effect : Effects)
+	{
+		USurvivalEffectsComponent* Target = Effect.Target.Get();
+
+		if (!Target || Effect.HealthPerSecond == 0.f)
+		{
+			continue;
+		}
+
+		const float Elapsed = FMath::Min(Now, Effect.ExpiryTime) - FMath::Max(LastUpdateTime, Effect.StartTime);
+
+		if (Elapsed > 0.f)
+		{
+			HealthChanges.FindOrAdd(Target) += Effect.HealthPerSecond * Elapsed;
+		}
+	}
+
+	LastUpdateTime = Now;
+
+	//Expired effects are all at the front
+	int32 NumExpired = 0;
+	while (NumExpired < Effects.Num() && Effects[NumExpired].ExpiryTime <= Now)
+	{
+		++NumExpired;
+	}
+
+	TArray<FManagedEffect, TInlineAllocator<16>> ExpiredEffects(Effects.GetData(), NumExpired);
+	Effects.RemoveAt(0, NumExpired, false);
+
+	//A character that dies from a health change removes its effects from its death path, so the arrays are finished with by now
+	for (const TPair<USurvivalEffectsComponent*, float>& HealthChange : HealthChanges)
+	{
+		ASurvivalCharacter* Character = Cast<ASurvivalCharacter>(HealthChange.Key->GetOwner());
+
+		//Don't heal or hurt a character that is already on its way out
+		if (Character && !Character->IsPendingKillPending() && !Character->GetTearOff())
+		{
+			Character->ModifyHealth(HealthChange.Value);
+		}
+	}
+
+	for (const FManagedEffect& ExpiredEffect : ExpiredEffects)
+	{
+		if (USurvivalEffectsComponent* Target = ExpiredEffect.Target.Get())
+		{
+			Target->StopEffect(ExpiredEffect.Id);
+		}
+	}
+}
+
+void USurvivalEffectManager::InsertEffect(const FManagedEffect& Effect)
+{
+	const int32 InsertIndex = Algo::UpperBoundBy(Effects, Effect.ExpiryTime, &FManagedEffect::ExpiryTime);
+	Effects.Insert(Effect, InsertIndex);
+}
+
+uint16 USurvivalEffectManager::GetNextEffectId()
+{
+	//Skip 0 when the id wraps, so it is never a valid id
+	if (++LastEffectId == 0)
+	{
+		++LastEffectId;
+	}
+
+	return LastEffectId;
+}
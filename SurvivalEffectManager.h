@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "SurvivalEffectManager.generated.h"
+
+class USurvivalEffectsComponent;
+struct FSurvivalEffect;
+
+/**
+ * Runs every timed effect in the world on the server, instead of each effect having its own timer.  Effects are kept in one
+ * array sorted by when they expire, so expired effects are always at the front.  At a fixed rate, the health change of every
+ * effect is added up per character and applied once, and the expired effects are stopped together.
+ *
+ * Only starting and stopping an effect is sent to the owning client, through its effects component.
+ */
+UCLASS()
+class SURVIVALGAME_API USurvivalEffectManager : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	//FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+	/* [server] Start an effect on a character.  Applying the same effect from the same source again restarts it.  EffectIndex
+	tells apart several effects applied by one source */
+	void ApplyEffect(USurvivalEffectsComponent* Target, UObject* Source, const FSurvivalEffect& Effect, const int32 EffectIndex = 0);
+
+	/* [server] Drop every effect on a character without applying what is left of them */
+	void RemoveEffects(USurvivalEffectsComponent* Target);
+
+protected:
+
+	struct FManagedEffect
+	{
+		TWeakObjectPtr<USurvivalEffectsComponent> Target;
+		TWeakObjectPtr<UObject> Source;
+		int32 EffectIndex;
+
+		float StartTime;
+		float ExpiryTime;
+		float HealthPerSecond;
+
+		uint16 Id;
+	};
+
+	/* Apply the health change of every effect since the last update, and stop the ones that have expired */
+	void UpdateEffects(const float Now);
+
+	/* Add an effect, keeping the array sorted by expiry */
+	void InsertEffect(const FManagedEffect& Effect);
+
+	uint16 GetNextEffectId();
+
+	//Sorted by expiry, soonest first
+	TArray<FManagedEffect> Effects;
+
+	float LastUpdateTime;
+	float TimeSinceUpdate;
+	uint16 LastEffectId;
+};
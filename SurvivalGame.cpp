@@ -1,6 +1,6 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#include "SurvivalGame.h"
-#include "Modules/ModuleManager.h"
-
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, SurvivalGame, "SurvivalGame" );
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SurvivalGame.h"
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, SurvivalGame, "SurvivalGame" );
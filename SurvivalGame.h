@@ -1,6 +1,7 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+DECLARE_STATS_GROUP(TEXT("SurvivalGame"), STATGROUP_SurvivalGame, STATCAT_Advanced);
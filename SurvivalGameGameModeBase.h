@@ -1,17 +1,17 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/GameModeBase.h"
-#include "SurvivalGameGameModeBase.generated.h"
-
-/**
- * 
- */
-UCLASS()
-class SURVIVALGAME_API ASurvivalGameGameModeBase : public AGameModeBase
-{
-	GENERATED_BODY()
-	
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameModeBase.h"
+#include "SurvivalGameGameModeBase.generated.h"
+
+/**
+ * 
+ */
+UCLASS()
+class SURVIVALGAME_API ASurvivalGameGameModeBase : public AGameModeBase
+{
+	GENERATED_BODY()
+	
+};
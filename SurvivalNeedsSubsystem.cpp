@@ -0,0 +1,294 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SurvivalNeedsSubsystem.h"
+#include "SurvivalGame.h"
+#include "Components/SurvivalNeedsComponent.h"
+#include "GameFramework/DamageType.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_CYCLE_STAT(TEXT("Survival Needs Update"), STAT_SurvivalNeedsUpdate, STATGROUP_SurvivalGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Survival Needs Characters"), STAT_SurvivalNeedsCharacters, STATGROUP_SurvivalGame);
+
+static TAutoConsoleVariable<float> CVarNeedsUpdateInterval(
+	TEXT("Survival.Needs.UpdateInterval"),
+	1.f,
+	TEXT("Seconds between updates of every characters hunger, thirst and temperature."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarNeedsHungerRate(
+	TEXT("Survival.Needs.HungerRate"),
+	100.f / 3600.f,
+	TEXT("Hunger lost per second."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarNeedsThirstRate(
+	TEXT("Survival.Needs.ThirstRate"),
+	100.f / 2400.f,
+	TEXT("Thirst lost per second."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarNeedsTemperatureRate(
+	TEXT("Survival.Needs.TemperatureRate"),
+	0.02f,
+	TEXT("The fraction of the gap to the environment temperature a characters temperature closes each second."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarNeedsAmbientTemperature(
+	TEXT("Survival.Needs.AmbientTemperature"),
+	50.f,
+	TEXT("The environment temperature of characters nothing else is warming or cooling.  50 is comfortable."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarNeedsStarvationDamage(
+	TEXT("Survival.Needs.StarvationDamage"),
+	1.f,
+	TEXT("Damage per second taken by characters out of food or water."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarNeedsFreezingTemperature(
+	TEXT("Survival.Needs.FreezingTemperature"),
+	10.f,
+	TEXT("Characters whose temperature is at or below this are freezing, and take exposure damage."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarNeedsOverheatingTemperature(
+	TEXT("Survival.Needs.OverheatingTemperature"),
+	90.f,
+	TEXT("Characters whose temperature is at or above this are overheating, and take exposure damage."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarNeedsExposureDamage(
+	TEXT("Survival.Needs.ExposureDamage"),
+	1.f,
+	TEXT("Damage per second taken by characters that are freezing or overheating."),
+	ECVF_Default);
+
+static const float MaxNeed = 100.f;
+
+void USurvivalNeedsSubsystem::Deinitialize()
+{
+	Super::Deinitialize();
+
+	Components.Empty();
+	Hunger.Empty();
+	Thirst.Empty();
+	Temperature.Empty();
+	EnvironmentTemperature.Empty();
+	HasEnvironmentOverride.Empty();
+}
+
+void USurvivalNeedsSubsystem::Tick(float DeltaTime)
+{
+	UpdateTime += DeltaTime;
+
+	const float UpdateInterval = FMath::Max(CVarNeedsUpdateInterval.GetValueOnGameThread(), 0.1f);
+
+	if (UpdateTime < UpdateInterval)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_SurvivalNeedsUpdate);
+	SET_DWORD_STAT(STAT_SurvivalNeedsCharacters, Components.Num());
+
+	//Catch up in one step after a hitch, needs change slowly enough that it makes no difference
+	const float UpdateDeltaTime = UpdateTime;
+	UpdateTime = 0.f;
+
+	UpdateNeeds(UpdateDeltaTime);
+	ApplyNeeds(UpdateDeltaTime);
+}
+
+bool USurvivalNeedsSubsystem::IsTickable() const
+{
+	return !IsTemplate() && Components.Num() > 0;
+}
+
+TStatId USurvivalNeedsSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USurvivalNeedsSubsystem, STATGROUP_Tickables);
+}
+
+UWorld* USurvivalNeedsSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+int32 USurvivalNeedsSubsystem::Register(USurvivalNeedsComponent* NeedsComponent)
+{
+	const FSurvivalNeeds& Needs = NeedsComponent->Needs;
+
+	Hunger.Add(Needs.Hunger);
+	Thirst.Add(Needs.Thirst);
+	Temperature.Add(Needs.Temperature);
+	EnvironmentTemperature.Add(CVarNeedsAmbientTemperature.GetValueOnGameThread());
+	HasEnvironmentOverride.Add(false);
+
+	return Components.Add(NeedsComponent);
+}
+
+void USurvivalNeedsSubsystem::Unregister(const int32 Index)
+{
+	if (!Components.IsValidIndex(Index))
+	{
+		return;
+	}
+
+	Components.RemoveAtSwap(Index);
+	Hunger.RemoveAtSwap(Index);
+	Thirst.RemoveAtSwap(Index);
+	Temperature.RemoveAtSwap(Index);
+	EnvironmentTemperature.RemoveAtSwap(Index);
+	HasEnvironmentOverride.RemoveAtSwap(Index);
+
+	//The last component was moved into the gap
+	if (Components.IsValidIndex(Index) && Components[Index].IsValid())
+	{
+		Components[Index]->NeedsIndex = Index;
+	}
+}
+
+float USurvivalNeedsSubsystem::Consume(const int32 Index, const float HungerRestored, const float ThirstRestored)
+{
+	if (!Components.IsValidIndex(Index))
+	{
+		return 0.f;
+	}
+
+	const float OldHunger = Hunger[Index];
+	const float OldThirst = Thirst[Index];
+
+	Hunger[Index] = FMath::Clamp(OldHunger + HungerRestored, 0.f, MaxNeed);
+	Thirst[Index] = FMath::Clamp(OldThirst + ThirstRestored, 0.f, MaxNeed);
+
+	//Show the owner straight away rather than at the next update
+	if (USurvivalNeedsComponent* NeedsComponent = Components[Index].Get())
+	{
+		NeedsComponent->SetNeeds(GetRoundedNeeds(Index));
+	}
+
+	return (Hunger[Index] - OldHunger) + (Thirst[Index] - OldThirst);
+}
+
+void USurvivalNeedsSubsystem::SetEnvironmentTemperature(const int32 Index, const float NewEnvironmentTemperature)
+{
+	if (EnvironmentTemperature.IsValidIndex(Index))
+	{
+		EnvironmentTemperature[Index] = FMath::Clamp(NewEnvironmentTemperature, 0.f, MaxNeed);
+		HasEnvironmentOverride[Index] = true;
+	}
+}
+
+void USurvivalNeedsSubsystem::ResetEnvironmentTemperature(const int32 Index)
+{
+	if (EnvironmentTemperature.IsValidIndex(Index))
+	{
+		EnvironmentTemperature[Index] = FMath::Clamp(CVarNeedsAmbientTemperature.GetValueOnGameThread(), 0.f, MaxNeed);
+		HasEnvironmentOverride[Index] = false;
+	}
+}
+
+FSurvivalNeeds USurvivalNeedsSubsystem::GetRoundedNeeds(const int32 Index) const
+{
+	FSurvivalNeeds Needs;
+	Needs.Hunger = (uint8)FMath::RoundToInt(Hunger[Index]);
+	Needs.Thirst = (uint8)FMath::RoundToInt(Thirst[Index]);
+	Needs.Temperature = (uint8)FMath::RoundToInt(Temperature[Index]);
+	return Needs;
+}
+
+void USurvivalNeedsSubsystem::UpdateNeeds(const float DeltaTime)
+{
+	const float HungerLost = CVarNeedsHungerRate.GetValueOnGameThread() * DeltaTime;
+	const float ThirstLost = CVarNeedsThirstRate.GetValueOnGameThread() * DeltaTime;
+	const float TemperatureBlend = FMath::Clamp(CVarNeedsTemperatureRate.GetValueOnGameThread() * DeltaTime, 0.f, 1.f);
+	const float AmbientTemperature = FMath::Clamp(CVarNeedsAmbientTemperature.GetValueOnGameThread(), 0.f, MaxNeed);
+
+	//The ambient temperature can change (i.e. with the time of day), so characters outside of volumes follow it
+	for (int32 i = 0; i < EnvironmentTemperature.Num(); ++i)
+	{
+		if (!HasEnvironmentOverride[i])
+		{
+			EnvironmentTemperature[i] = AmbientTemperature;
+		}
+	}
+
+	const int32 Num = Components.Num();
+	const int32 NumVectorized = Num & ~3;
+
+	float* RESTRICT HungerData = Hunger.GetData();
+	float* RESTRICT ThirstData = Thirst.GetData();
+	float* RESTRICT TemperatureData = Temperature.GetData();
+	const float* RESTRICT EnvironmentData = EnvironmentTemperature.GetData();
+
+	//Four characters at a time
+	const VectorRegister HungerLostVector = VectorSetFloat1(HungerLost);
+	const VectorRegister ThirstLostVector = VectorSetFloat1(ThirstLost);
+	const VectorRegister TemperatureBlendVector = VectorSetFloat1(TemperatureBlend);
+	const VectorRegister Zero = VectorZero();
+
+	for (int32 i = 0; i < NumVectorized; i += 4)
+	{
+		VectorStore(VectorMax(VectorSubtract(VectorLoad(HungerData + i), HungerLostVector), Zero), HungerData + i);
+		VectorStore(VectorMax(VectorSubtract(VectorLoad(ThirstData + i), ThirstLostVector), Zero), ThirstData + i);
+
+		//Close a fraction of the gap to the environment temperature
+		const VectorRegister CurrentTemperature = VectorLoad(TemperatureData + i);
+		const VectorRegister TemperatureGap = VectorSubtract(VectorLoad(EnvironmentData + i), CurrentTemperature);
+		VectorStore(VectorMultiplyAdd(TemperatureGap, TemperatureBlendVector, CurrentTemperature), TemperatureData + i);
+	}
+
+	//Then whatever is left over
+	for (int32 i = NumVectorized; i < Num; ++i)
+	{
+		HungerData[i] = FMath::Max(HungerData[i] - HungerLost, 0.f);
+		ThirstData[i] = FMath::Max(ThirstData[i] - ThirstLost, 0.f);
+		TemperatureData[i] += (EnvironmentData[i] - TemperatureData[i]) * TemperatureBlend;
+	}
+}
+
+void USurvivalNeedsSubsystem::ApplyNeeds(const float DeltaTime)
+{
+	const float StarvationDamage = CVarNeedsStarvationDamage.GetValueOnGameThread() * DeltaTime;
+	const float ExposureDamage = CVarNeedsExposureDamage.GetValueOnGameThread() * DeltaTime;
+	const float FreezingTemperature = CVarNeedsFreezingTemperature.GetValueOnGameThread();
+	const float OverheatingTemperature = CVarNeedsOverheatingTemperature.GetValueOnGameThread();
+
+	//Damage can kill and unregister a character, so it waits until we're done with the arrays
+	TArray<TPair<AActor*, float>, TInlineAllocator<16>> SufferingActors;
+
+	for (int32 i = 0; i < Components.Num(); ++i)
+	{
+		USurvivalNeedsComponent* NeedsComponent = Components[i].Get();
+
+		if (!NeedsComponent)
+		{
+			continue;
+		}
+
+		NeedsComponent->SetNeeds(GetRoundedNeeds(i));
+
+		float Damage = 0.f;
+
+		if (Hunger[i] <= 0.f || Thirst[i] <= 0.f)
+		{
+			Damage += StarvationDamage;
+		}
+
+		if (Temperature[i] <= FreezingTemperature || Temperature[i] >= OverheatingTemperature)
+		{
+			Damage += ExposureDamage;
+		}
+
+		if (Damage > 0.f)
+		{
+			SufferingActors.Emplace(NeedsComponent->GetOwner(), Damage);
+		}
+	}
+
+	for (const TPair<AActor*, float>& SufferingActor : SufferingActors)
+	{
+		UGameplayStatics::ApplyDamage(SufferingActor.Key, SufferingActor.Value, nullptr, nullptr, UDamageType::StaticClass());
+	}
+}
@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "SurvivalNeedsSubsystem.generated.h"
+
+class USurvivalNeedsComponent;
+
+/**
+ * Simulates the hunger, thirst and temperature of every character on the server.  Needs are stored in one array per need rather
+ * than on the characters, and updated at a low fixed rate in a single SIMD pass.  After each update the rounded needs are handed
+ * to the characters needs components, which only replicate them if they changed by a whole point.
+ *
+ * Characters that have run out of food or water, or are freezing or overheating, take damage every update.  The environment
+ * temperature comes from the temperature volume a character is in, or the ambient temperature outside of them.
+ */
+UCLASS()
+class SURVIVALGAME_API USurvivalNeedsSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	//FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+	/* Start simulating a characters needs.  Returns where they are stored */
+	int32 Register(USurvivalNeedsComponent* NeedsComponent);
+
+	/* Stop simulating a characters needs.  The last character is moved into the gap */
+	void Unregister(const int32 Index);
+
+	/* Restore some hunger and thirst.  Returns how much they went up by in total */
+	float Consume(const int32 Index, const float HungerRestored, const float ThirstRestored);
+
+	void SetEnvironmentTemperature(const int32 Index, const float EnvironmentTemperature);
+
+	/* Expose a character to the ambient temperature again */
+	void ResetEnvironmentTemperature(const int32 Index);
+
+protected:
+
+	/* Move every characters needs on by DeltaTime */
+	void UpdateNeeds(const float DeltaTime);
+
+	/* Hand the rounded needs to every component, and hurt characters that are starving, dehydrated, freezing or overheating */
+	void ApplyNeeds(const float DeltaTime);
+
+	/* A characters needs rounded to whole points, the way its component replicates them */
+	struct FSurvivalNeeds GetRoundedNeeds(const int32 Index) const;
+
+	TArray<TWeakObjectPtr<USurvivalNeedsComponent>> Components;
+
+	TArray<float> Hunger;
+	TArray<float> Thirst;
+	TArray<float> Temperature;
+	TArray<float> EnvironmentTemperature;
+
+	//Characters whose environment temperature is set by a volume, rather than following the ambient temperature
+	TBitArray<> HasEnvironmentOverride;
+
+	//Time since the last update
+	float UpdateTime;
+};
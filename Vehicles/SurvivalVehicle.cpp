@@ -1,173 +1,828 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "SurvivalVehicle.h"
-#include "Components/SkeletalMeshComponent.h"
-#include "GameFramework/SpringArmComponent.h"
-#include "Camera/CameraComponent.h"
-#include "WheeledVehicleMovementComponent4W.h"
-#include <Kismet/GameplayStatics.h>
-#include "../Components/InteractionComponent.h"
-#include "../Player/SurvivalCharacter.h"
-#include "Net/UnrealNetwork.h"
-
-static const FName NAME_SteerInput("Steer");
-static const FName NAME_ThrottleInput("Throttle");
-
-ASurvivalVehicle::ASurvivalVehicle()
-{
-	UWheeledVehicleMovementComponent4W* Vehicle4W = CastChecked<UWheeledVehicleMovementComponent4W>(GetVehicleMovement());
-
-	// Adjust the tire loading
-	Vehicle4W->MinNormalizedTireLoad = 0.0f;
-	Vehicle4W->MinNormalizedTireLoadFiltered = 0.2f;
-	Vehicle4W->MaxNormalizedTireLoad = 2.0f;
-	Vehicle4W->MaxNormalizedTireLoadFiltered = 2.0f;
-
-	// Torque setup
-	Vehicle4W->MaxEngineRPM = 5700.0f;
-	Vehicle4W->EngineSetup.TorqueCurve.GetRichCurve()->Reset();
-	Vehicle4W->EngineSetup.TorqueCurve.GetRichCurve()->AddKey(0.0f, 400.0f);
-	Vehicle4W->EngineSetup.TorqueCurve.GetRichCurve()->AddKey(1890.0f, 500.0f);
-	Vehicle4W->EngineSetup.TorqueCurve.GetRichCurve()->AddKey(5730.0f, 400.0f);
-
-	// Adjust the steering
-	Vehicle4W->SteeringCurve.GetRichCurve()->Reset();
-	Vehicle4W->SteeringCurve.GetRichCurve()->AddKey(0.0f, 1.0f);
-	Vehicle4W->SteeringCurve.GetRichCurve()->AddKey(40.0f, 0.7f);
-	Vehicle4W->SteeringCurve.GetRichCurve()->AddKey(120.0f, 0.6f);
-
-	Vehicle4W->DifferentialSetup.DifferentialType = EVehicleDifferential4W::LimitedSlip_4W;
-	Vehicle4W->DifferentialSetup.FrontRearSplit = 0.65;
-
-	// Automatic gearbox
-	Vehicle4W->TransmissionSetup.bUseGearAutoBox = true;
-	Vehicle4W->TransmissionSetup.GearSwitchTime = 0.15f;
-	Vehicle4W->TransmissionSetup.GearAutoBoxLatency = 1.0f;
-
-	// Create a spring arm component for our chase camera
-	SpringArm = CreateDefaultSubobject<USpringArmComponent>(TEXT("SpringArm"));
-	SpringArm->SetupAttachment(RootComponent);
-	SpringArm->TargetArmLength = 250.0f;
-	SpringArm->bUsePawnControlRotation = true;
-
-	// Create the chase camera component
-	Camera = CreateDefaultSubobject<UCameraComponent>(TEXT("ChaseCamera"));
-	Camera->SetupAttachment(SpringArm, USpringArmComponent::SocketName);
-	Camera->FieldOfView = 90.f;
-
-	InteractionComponent = CreateDefaultSubobject<UInteractionComponent>(TEXT("InteractionComponent"));
-	InteractionComponent->SetInteractableNameText(InteractionNameText);
-	InteractionComponent->SetInteractableActionText(InteractionActionText);
-	InteractionComponent->InteractionTime = InteractionTime;
-
-}
-
-void ASurvivalVehicle::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-
-	UpdateInAirControl(DeltaTime);
-}
-
-void ASurvivalVehicle::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
-{
-	Super::SetupPlayerInputComponent(PlayerInputComponent);
-
-	PlayerInputComponent->BindAxis("Throttle", this, &ASurvivalVehicle::ApplyThrottle);
-	PlayerInputComponent->BindAxis("Steer", this, &ASurvivalVehicle::ApplySteering);
-	PlayerInputComponent->BindAxis("LookUpVehicle", this, &ASurvivalVehicle::LookUp);
-	PlayerInputComponent->BindAxis("TurnVehicle", this, &ASurvivalVehicle::Turn);
-
-	PlayerInputComponent->BindAction("Handbrake", IE_Pressed, this, &ASurvivalVehicle::OnHandbrakePressed);
-	PlayerInputComponent->BindAction("Handbrake", IE_Released, this, &ASurvivalVehicle::OnHandbrakeReleased);
-}
-
-void ASurvivalVehicle::ApplyThrottle(float Val)
-{
-	GetVehicleMovementComponent()->SetThrottleInput(Val);
-}
-
-void ASurvivalVehicle::ApplySteering(float Val)
-{
-	GetVehicleMovementComponent()->SetSteeringInput(Val);
-}
-
-void ASurvivalVehicle::LookUp(float Val)
-{
-	if (Val != 0.f)
-	{
-		AddControllerPitchInput(Val);
-	}
-}
-
-void ASurvivalVehicle::Turn(float Val)
-{
-	if (Val != 0.f)
-	{
-		AddControllerYawInput(Val);
-	}
-}
-
-void ASurvivalVehicle::OnHandbrakePressed()
-{
-	GetVehicleMovementComponent()->SetHandbrakeInput(true);
-}
-
-void ASurvivalVehicle::OnHandbrakeReleased()
-{
-	GetVehicleMovementComponent()->SetHandbrakeInput(false);
-}
-
-void ASurvivalVehicle::UpdateInAirControl(float DeltaTime)
-{
-	if (UWheeledVehicleMovementComponent* Vehicle4W = CastChecked<UWheeledVehicleMovementComponent>(GetVehicleMovement()))
-	{
-		FCollisionQueryParams QueryParams;
-		QueryParams.AddIgnoredActor(this);
-
-		const FVector TraceStart = GetActorLocation() + FVector(0.f, 0.f, 50.f);
-		const FVector TraceEnd = GetActorLocation() + FVector(0.f, 0.f, 200.f);
-
-		FHitResult Hit;
-
-		//Check if car is flipped on its side, and check if the car is in the air
-		const bool bInAir = !GetWorld()->LineTraceSingleByChannel(Hit, TraceStart, TraceEnd, ECC_Visibility, QueryParams);
-		const bool bNotGrounded = FVector::DotProduct(GetActorUpVector(), FVector::UpVector) < 0.1f;
-
-		//Only allow in air-movement if we are not on the ground, or are in the air
-		if (bInAir || bNotGrounded)
-		{
-			if (InputComponent)
-			{
-				const float ForwardInput = InputComponent->GetAxisValue(TEXT("Steer"));
-				const float RightInput = InputComponent->GetAxisValue(TEXT("Throttle"));
-
-				//In car is grounded allow player to roll the car over
-				const float AirMovementForcePitch = 3.f;
-				const float AirMovementForceRoll = !bInAir && bNotGrounded ? 20.f : 3.f;
-
-				if (UPrimitiveComponent* VehicleMesh = Vehicle4W->UpdatedPrimitive)
-				{
-					const FVector MovementVector = FVector(RightInput * -AirMovementForceRoll, ForwardInput * AirMovementForcePitch, 0.f) * DeltaTime * 200.f;
-					const FVector NewAngularMovement = GetActorRotation().RotateVector(MovementVector);
-
-					VehicleMesh->SetPhysicsAngularVelocityInDegrees(NewAngularMovement, true);
-				}
-			}	
-		}
-	}
-}
-
-void ASurvivalVehicle::OnRep_Driver()
-{
-
-}
-
-void ASurvivalVehicle::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
-{
-	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-
-	DOREPLIFETIME(ASurvivalVehicle, Driver);
-}
-
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SurvivalVehicle.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/SpringArmComponent.h"
+#include "Camera/CameraComponent.h"
+#include "WheeledVehicleMovementComponent4W.h"
+#include "VehicleWheel.h"
+#include "VehicleManagerSubsystem.h"
+#include <Kismet/GameplayStatics.h>
+#include "../Components/InteractionComponent.h"
+#include "../Player/SurvivalCharacter.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Components/InputComponent.h"
+
+static TAutoConsoleVariable<float> CVarVehicleProxyInterpolationDelay(
+	TEXT("Vehicle.Proxy.InterpolationDelay"),
+	0.15f,
+	TEXT("How far in the past kinematic vehicle proxies are shown, so there is usually a snapshot either side of them."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarVehicleProxyMaxExtrapolation(
+	TEXT("Vehicle.Proxy.MaxExtrapolation"),
+	0.25f,
+	TEXT("How far kinematic vehicle proxies are moved on past their last snapshot, in seconds."),
+	ECVF_Default);
+
+//Plenty for the interpolation delay at any net update frequency we use
+static const int32 MaxBufferedSnapshots = 8;
+
+static TAutoConsoleVariable<float> CVarVehiclePredictionTimeout(
+	TEXT("Vehicle.PredictionTimeout"),
+	2.f,
+	TEXT("How long a predicted enter or exit waits for the server before it is undone."),
+	ECVF_Default);
+
+//About a second of input at 120fps.  If the server takes longer than that we only replay the latest
+static const int32 MaxBufferedInputs = 120;
+
+ASurvivalVehicle::ASurvivalVehicle()
+{
+	//Awake vehicles are updated together by the vehicle manager instead
+	PrimaryActorTick.bCanEverTick = false;
+
+	UWheeledVehicleMovementComponent4W* Vehicle4W = CastChecked<UWheeledVehicleMovementComponent4W>(GetVehicleMovement());
+
+	// Adjust the tire loading
+	Vehicle4W->MinNormalizedTireLoad = 0.0f;
+	Vehicle4W->MinNormalizedTireLoadFiltered = 0.2f;
+	Vehicle4W->MaxNormalizedTireLoad = 2.0f;
+	Vehicle4W->MaxNormalizedTireLoadFiltered = 2.0f;
+
+	// Torque setup
+	Vehicle4W->MaxEngineRPM = 5700.0f;
+	Vehicle4W->EngineSetup.TorqueCurve.GetRichCurve()->Reset();
+	Vehicle4W->EngineSetup.TorqueCurve.GetRichCurve()->AddKey(0.0f, 400.0f);
+	Vehicle4W->EngineSetup.TorqueCurve.GetRichCurve()->AddKey(1890.0f, 500.0f);
+	Vehicle4W->EngineSetup.TorqueCurve.GetRichCurve()->AddKey(5730.0f, 400.0f);
+
+	// Adjust the steering
+	Vehicle4W->SteeringCurve.GetRichCurve()->Reset();
+	Vehicle4W->SteeringCurve.GetRichCurve()->AddKey(0.0f, 1.0f);
+	Vehicle4W->SteeringCurve.GetRichCurve()->AddKey(40.0f, 0.7f);
+	Vehicle4W->SteeringCurve.GetRichCurve()->AddKey(120.0f, 0.6f);
+
+	Vehicle4W->DifferentialSetup.DifferentialType = EVehicleDifferential4W::LimitedSlip_4W;
+	Vehicle4W->DifferentialSetup.FrontRearSplit = 0.65;
+
+	// Automatic gearbox
+	Vehicle4W->TransmissionSetup.bUseGearAutoBox = true;
+	Vehicle4W->TransmissionSetup.GearSwitchTime = 0.15f;
+	Vehicle4W->TransmissionSetup.GearAutoBoxLatency = 1.0f;
+
+	// Create a spring arm component for our chase camera
+	SpringArm = CreateDefaultSubobject<USpringArmComponent>(TEXT("SpringArm"));
+	SpringArm->SetupAttachment(RootComponent);
+	SpringArm->TargetArmLength = 250.0f;
+	SpringArm->bUsePawnControlRotation = true;
+
+	// Create the chase camera component
+	Camera = CreateDefaultSubobject<UCameraComponent>(TEXT("ChaseCamera"));
+	Camera->SetupAttachment(SpringArm, USpringArmComponent::SocketName);
+	Camera->FieldOfView = 90.f;
+
+	InteractionComponent = CreateDefaultSubobject<UInteractionComponent>(TEXT("InteractionComponent"));
+	InteractionComponent->SetInteractableNameText(InteractionNameText);
+	InteractionComponent->SetInteractableActionText(InteractionActionText);
+	InteractionComponent->InteractionTime = InteractionTime;
+	InteractionComponent->OnInteract.AddDynamic(this, &ASurvivalVehicle::OnInteract);
+
+	//We need to know when the body goes to sleep and wakes up to do the same
+	GetMesh()->BodyInstance.bGenerateWakeEvents = true;
+
+	//Clients get our physics state from Snapshot instead, which the driver is corrected towards and remote clients simulate or interpolate
+	SetReplicatingMovement(false);
+
+	SleepingNetUpdateFrequency = 1.f;
+	bSleeping = false;
+	AwakeNetUpdateFrequency = NetUpdateFrequency;
+	ThrottleInput = 0.f;
+	SteeringInput = 0.f;
+	bHandbrakeInput = false;
+	DriverSeatSocket = TEXT("DriverSeat");
+	ExitOffset = FVector(0.f, -200.f, 50.f);
+	PredictionStartTime = 0.f;
+	bProxyPhysicsEnabled = true;
+	ProxyWheelRPM = 0.f;
+}
+
+void ASurvivalVehicle::BeginPlay()
+{
+	Super::BeginPlay();
+
+	AwakeNetUpdateFrequency = NetUpdateFrequency;
+
+	GetMesh()->OnComponentWake.AddDynamic(this, &ASurvivalVehicle::OnMeshWake);
+	GetMesh()->OnComponentSleep.AddDynamic(this, &ASurvivalVehicle::OnMeshSleep);
+
+	if (UVehicleManagerSubsystem* VehicleManager = GetWorld()->GetSubsystem<UVehicleManagerSubsystem>())
+	{
+		VehicleManager->RegisterVehicle(this);
+	}
+}
+
+void ASurvivalVehicle::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UVehicleManagerSubsystem* VehicleManager = GetWorld()->GetSubsystem<UVehicleManagerSubsystem>())
+	{
+		VehicleManager->UnregisterVehicle(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ASurvivalVehicle::PossessedBy(AController* NewController)
+{
+	Super::PossessedBy(NewController);
+
+	if (ASurvivalCharacter* Character = EnteringDriver.Get())
+	{
+		AttachDriver(Character);
+		SetDriver(Character);
+	}
+
+	WakeUp();
+}
+
+void ASurvivalVehicle::UnPossessed()
+{
+	//Our controller is going back to the driver, or elsewhere, so take the driver out of the seat either way
+	if (HasAuthority() && Driver)
+	{
+		DetachDriver(Driver);
+		SetDriver(nullptr);
+	}
+
+	Super::UnPossessed();
+
+	ThrottleInput = 0.f;
+	SteeringInput = 0.f;
+	bHandbrakeInput = false;
+	BufferedInputs.Reset();
+
+	//If the body is already at rest it won't tell us it went to sleep
+	if (!GetMesh()->RigidBodyIsAwake())
+	{
+		Sleep();
+	}
+}
+
+void ASurvivalVehicle::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
+{
+	Super::SetupPlayerInputComponent(PlayerInputComponent);
+
+	PlayerInputComponent->BindAxis("Throttle", this, &ASurvivalVehicle::ApplyThrottle);
+	PlayerInputComponent->BindAxis("Steer", this, &ASurvivalVehicle::ApplySteering);
+	PlayerInputComponent->BindAxis("LookUpVehicle", this, &ASurvivalVehicle::LookUp);
+	PlayerInputComponent->BindAxis("TurnVehicle", this, &ASurvivalVehicle::Turn);
+
+	PlayerInputComponent->BindAction("Handbrake", IE_Pressed, this, &ASurvivalVehicle::OnHandbrakePressed);
+	PlayerInputComponent->BindAction("Handbrake", IE_Released, this, &ASurvivalVehicle::OnHandbrakeReleased);
+
+	PlayerInputComponent->BindAction("Interact", IE_Pressed, this, &ASurvivalVehicle::ExitVehicle);
+}
+
+void ASurvivalVehicle::ApplyThrottle(float Val)
+{
+	ThrottleInput = Val;
+
+	if (!IsBufferingInput())
+	{
+		GetVehicleMovementComponent()->SetThrottleInput(Val);
+	}
+}
+
+void ASurvivalVehicle::ApplySteering(float Val)
+{
+	SteeringInput = Val;
+
+	if (!IsBufferingInput())
+	{
+		GetVehicleMovementComponent()->SetSteeringInput(Val);
+	}
+}
+
+void ASurvivalVehicle::LookUp(float Val)
+{
+	if (Val != 0.f)
+	{
+		AddControllerPitchInput(Val);
+	}
+}
+
+void ASurvivalVehicle::Turn(float Val)
+{
+	if (Val != 0.f)
+	{
+		AddControllerYawInput(Val);
+	}
+}
+
+void ASurvivalVehicle::OnHandbrakePressed()
+{
+	bHandbrakeInput = true;
+
+	if (!IsBufferingInput())
+	{
+		GetVehicleMovementComponent()->SetHandbrakeInput(true);
+	}
+}
+
+void ASurvivalVehicle::OnHandbrakeReleased()
+{
+	bHandbrakeInput = false;
+
+	if (!IsBufferingInput())
+	{
+		GetVehicleMovementComponent()->SetHandbrakeInput(false);
+	}
+}
+
+void ASurvivalVehicle::ApplyInput(const FBufferedVehicleInput& Input)
+{
+	UWheeledVehicleMovementComponent* VehicleMovement = GetVehicleMovementComponent();
+	VehicleMovement->SetThrottleInput(Input.Throttle);
+	VehicleMovement->SetSteeringInput(Input.Steering);
+	VehicleMovement->SetHandbrakeInput(Input.bHandbrake);
+}
+
+void ASurvivalVehicle::UpdateInAirControl(float DeltaTime, const bool bTouchingGround)
+{
+	if (UWheeledVehicleMovementComponent* Vehicle4W = CastChecked<UWheeledVehicleMovementComponent>(GetVehicleMovement()))
+	{
+		//Check if car is flipped on its side, and check if the car is in the air.  A car on its roof has no wheels touching, but is on the ground
+		const bool bInAir = IsInAir() && !bTouchingGround;
+		const bool bNotGrounded = IsFlipped();
+
+		//Only allow in air-movement if we are not on the ground, or are in the air
+		if (bInAir || bNotGrounded)
+		{
+			if (InputComponent)
+			{
+				const float ForwardInput = SteeringInput;
+				const float RightInput = ThrottleInput;
+
+				//In car is grounded allow player to roll the car over
+				const float AirMovementForcePitch = 3.f;
+				const float AirMovementForceRoll = !bInAir && bNotGrounded ? 20.f : 3.f;
+
+				if (UPrimitiveComponent* VehicleMesh = Vehicle4W->UpdatedPrimitive)
+				{
+					const FVector MovementVector = FVector(RightInput * -AirMovementForceRoll, ForwardInput * AirMovementForcePitch, 0.f) * DeltaTime * 200.f;
+					const FVector NewAngularMovement = GetActorRotation().RotateVector(MovementVector);
+
+					VehicleMesh->SetPhysicsAngularVelocityInDegrees(NewAngularMovement, true);
+				}
+			}	
+		}
+	}
+}
+
+bool ASurvivalVehicle::IsInAir() const
+{
+	//The wheels already know from their suspension raycasts whether they are touching anything
+	for (const UVehicleWheel* Wheel : GetVehicleMovementComponent()->Wheels)
+	{
+		if (Wheel && !Wheel->IsInAir())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool ASurvivalVehicle::IsFlipped() const
+{
+	return FVector::DotProduct(GetActorUpVector(), FVector::UpVector) < 0.1f;
+}
+
+void ASurvivalVehicle::Sleep()
+{
+	//Someone is driving us, or might be about to
+	if (bSleeping || GetController() || Driver || IsPredictingEnter())
+	{
+		return;
+	}
+
+	bSleeping = true;
+
+	//Remote vehicles stay registered, so the vehicle manager still gives them physics when the local player comes close
+	if (GetLocalRole() != ROLE_SimulatedProxy)
+	{
+		if (UVehicleManagerSubsystem* VehicleManager = GetWorld()->GetSubsystem<UVehicleManagerSubsystem>())
+		{
+			VehicleManager->UnregisterVehicle(this);
+		}
+	}
+
+	GetVehicleMovementComponent()->SetComponentTickEnabled(false);
+
+	NetUpdateFrequency = FMath::Min(SleepingNetUpdateFrequency, AwakeNetUpdateFrequency);
+
+	//Make sure clients get where we came to rest, as the snapshot isn't updated while we sleep
+	if (HasAuthority())
+	{
+		UpdateSnapshot();
+	}
+}
+
+void ASurvivalVehicle::WakeUp()
+{
+	if (!bSleeping)
+	{
+		return;
+	}
+
+	bSleeping = false;
+
+	if (UVehicleManagerSubsystem* VehicleManager = GetWorld()->GetSubsystem<UVehicleManagerSubsystem>())
+	{
+		VehicleManager->RegisterVehicle(this);
+	}
+
+	GetVehicleMovementComponent()->SetComponentTickEnabled(true);
+
+	NetUpdateFrequency = AwakeNetUpdateFrequency;
+
+	//Whatever woke us up probably moved us, so don't wait for the slow update to tell clients
+	if (HasAuthority())
+	{
+		ForceNetUpdate();
+	}
+}
+
+void ASurvivalVehicle::OnMeshWake(UPrimitiveComponent* WakingComponent, FName BoneName)
+{
+	WakeUp();
+}
+
+void ASurvivalVehicle::OnMeshSleep(UPrimitiveComponent* SleepingComponent, FName BoneName)
+{
+	Sleep();
+}
+
+void ASurvivalVehicle::SetDriver(class ASurvivalCharacter* NewDriver)
+{
+	if (HasAuthority() && Driver != NewDriver)
+	{
+		Driver = NewDriver;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ASurvivalVehicle, Driver, this);
+		OnRep_Driver();
+	}
+}
+
+void ASurvivalVehicle::OnRep_Driver()
+{
+	//Someone else got the seat we predicted getting into
+	if (IsPredictingEnter() && Driver && Driver != PredictedDriver.Get())
+	{
+		CancelPredictedEnter();
+	}
+
+	//The server agreed to let our driver out
+	if (PredictedExitDriver.IsValid() && Driver != PredictedExitDriver.Get())
+	{
+		PredictedExitDriver.Reset();
+	}
+
+	if (Driver)
+	{
+		WakeUp();
+		GetMesh()->WakeAllRigidBodies();
+	}
+	else if (!GetMesh()->RigidBodyIsAwake())
+	{
+		//The driver got out of a vehicle that is already at rest, so it won't tell us it went to sleep
+		Sleep();
+	}
+}
+
+void ASurvivalVehicle::OnInteract(class ASurvivalCharacter* Character)
+{
+	if (!Character || Driver)
+	{
+		return;
+	}
+
+	if (HasAuthority())
+	{
+		if (AController* CharacterController = Character->GetController())
+		{
+			EnteringDriver = Character;
+			CharacterController->Possess(this);
+			EnteringDriver.Reset();
+		}
+	}
+	else if (Character->IsLocallyControlled())
+	{
+		PredictEnter(Character);
+	}
+}
+
+void ASurvivalVehicle::ExitVehicle()
+{
+	if (!Driver || PredictedExitDriver.IsValid())
+	{
+		return;
+	}
+
+	if (!HasAuthority())
+	{
+		PredictExit();
+	}
+
+	ServerExitVehicle();
+}
+
+void ASurvivalVehicle::ServerExitVehicle_Implementation()
+{
+	//Possessing the driver again unpossesses us, which takes them out of the seat and clears Driver
+	ASurvivalCharacter* OldDriver = Driver;
+	AController* DriverController = GetController();
+
+	if (OldDriver && DriverController)
+	{
+		DriverController->Possess(OldDriver);
+	}
+}
+
+bool ASurvivalVehicle::ServerExitVehicle_Validate()
+{
+	return true;
+}
+
+void ASurvivalVehicle::PawnClientRestart()
+{
+	Super::PawnClientRestart();
+
+	//We may have been kinematic while we were far away, but the driver simulates us
+	SetProxyPhysicsEnabled(true);
+
+	if (IsPredictingEnter())
+	{
+		ConfirmPredictedEnter();
+	}
+}
+
+void ASurvivalVehicle::PredictEnter(class ASurvivalCharacter* Character)
+{
+	APlayerController* PC = Character ? Cast<APlayerController>(Character->GetController()) : nullptr;
+
+	if (!PC || !PC->IsLocalController() || Driver || IsPredictingEnter())
+	{
+		return;
+	}
+
+	PredictedDriver = Character;
+	PredictionStartTime = GetWorld()->GetTimeSeconds();
+	BufferedInputs.Reset();
+
+	AttachDriver(Character);
+
+	//Our input isn't set up until we're possessed, so listen for throttle and steering ourselves until then
+	PredictedInputComponent = NewObject<UInputComponent>(this, TEXT("PredictedInputComponent"));
+	PredictedInputComponent->BindAxis("Throttle", this, &ASurvivalVehicle::ApplyThrottle);
+	PredictedInputComponent->BindAxis("Steer", this, &ASurvivalVehicle::ApplySteering);
+	PredictedInputComponent->BindAction("Handbrake", IE_Pressed, this, &ASurvivalVehicle::OnHandbrakePressed);
+	PredictedInputComponent->BindAction("Handbrake", IE_Released, this, &ASurvivalVehicle::OnHandbrakeReleased);
+	PC->PushInputComponent(PredictedInputComponent);
+
+	//We simulate from here on, so the input we buffer moves us straight away
+	SetProxyPhysicsEnabled(true);
+
+	//The vehicle manager records the buffered input
+	WakeUp();
+}
+
+void ASurvivalVehicle::PredictExit()
+{
+	if (!IsLocallyControlled() || !Driver || PredictedExitDriver.IsValid())
+	{
+		return;
+	}
+
+	PredictedExitDriver = Driver;
+	PredictionStartTime = GetWorld()->GetTimeSeconds();
+
+	//Let go of everything so the vehicle doesn't drive off without us
+	ThrottleInput = 0.f;
+	SteeringInput = 0.f;
+	bHandbrakeInput = true;
+	BufferedInputs.Reset();
+	ApplyInput(FBufferedVehicleInput{ 0.f, 0.f, true });
+
+	DetachDriver(Driver);
+}
+
+void ASurvivalVehicle::UpdateBufferedInput()
+{
+	const float PredictionTimeout = CVarVehiclePredictionTimeout.GetValueOnGameThread();
+	const bool bPredictionTimedOut = GetWorld()->TimeSince(PredictionStartTime) > PredictionTimeout;
+
+	if (IsPredictingEnter())
+	{
+		if (bPredictionTimedOut)
+		{
+			CancelPredictedEnter();
+			return;
+		}
+
+		if (BufferedInputs.Num() >= MaxBufferedInputs)
+		{
+			BufferedInputs.RemoveAt(0, 1, false);
+		}
+
+		BufferedInputs.Add(FBufferedVehicleInput{ ThrottleInput, SteeringInput, bHandbrakeInput });
+		return;
+	}
+
+	if (BufferedInputs.Num())
+	{
+		//Keep recording live input behind the replay, and replay two inputs a frame so we catch up with live input
+		BufferedInputs.Add(FBufferedVehicleInput{ ThrottleInput, SteeringInput, bHandbrakeInput });
+
+		const int32 NumReplayed = FMath::Min(2, BufferedInputs.Num());
+		ApplyInput(BufferedInputs[NumReplayed - 1]);
+		BufferedInputs.RemoveAt(0, NumReplayed, false);
+	}
+
+	//The server never let our driver out, put them back
+	if (PredictedExitDriver.IsValid() && bPredictionTimedOut)
+	{
+		if (Driver == PredictedExitDriver.Get())
+		{
+			AttachDriver(Driver);
+			bHandbrakeInput = false;
+			ApplyInput(FBufferedVehicleInput());
+		}
+
+		PredictedExitDriver.Reset();
+	}
+}
+
+void ASurvivalVehicle::AttachDriver(class ASurvivalCharacter* Character)
+{
+	if (UCharacterMovementComponent* CharacterMovement = Character->GetCharacterMovement())
+	{
+		CharacterMovement->DisableMovement();
+	}
+
+	Character->SetActorEnableCollision(false);
+	Character->AttachToComponent(GetMesh(), FAttachmentTransformRules::SnapToTargetNotIncludingScale, DriverSeatSocket);
+}
+
+void ASurvivalVehicle::DetachDriver(class ASurvivalCharacter* Character)
+{
+	Character->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	Character->SetActorLocation(GetActorTransform().TransformPosition(ExitOffset), false, nullptr, ETeleportType::TeleportPhysics);
+	Character->SetActorRotation(FRotator(0.f, GetActorRotation().Yaw, 0.f));
+	Character->SetActorEnableCollision(true);
+
+	if (UCharacterMovementComponent* CharacterMovement = Character->GetCharacterMovement())
+	{
+		CharacterMovement->SetMovementMode(MOVE_Walking);
+	}
+}
+
+void ASurvivalVehicle::ConfirmPredictedEnter()
+{
+	//Possession set up our real input, and the buffered input is replayed by UpdateBufferedInput
+	if (APlayerController* PC = Cast<APlayerController>(GetController()))
+	{
+		PC->PopInputComponent(PredictedInputComponent);
+	}
+
+	PredictedDriver.Reset();
+	PredictedInputComponent = nullptr;
+}
+
+void ASurvivalVehicle::CancelPredictedEnter()
+{
+	ASurvivalCharacter* Character = PredictedDriver.Get();
+
+	if (Character)
+	{
+		if (APlayerController* PC = Cast<APlayerController>(Character->GetController()))
+		{
+			PC->PopInputComponent(PredictedInputComponent);
+		}
+
+		DetachDriver(Character);
+	}
+
+	PredictedDriver.Reset();
+	PredictedInputComponent = nullptr;
+	BufferedInputs.Reset();
+}
+
+void ASurvivalVehicle::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	if (!bSleeping)
+	{
+		UpdateSnapshot();
+	}
+}
+
+void ASurvivalVehicle::UpdateSnapshot()
+{
+	Snapshot.Location = GetActorLocation();
+	Snapshot.SetRotation(GetActorRotation());
+	Snapshot.Velocity = GetVelocity();
+	Snapshot.AngularVelocity = GetMesh()->GetPhysicsAngularVelocityInDegrees();
+	Snapshot.WheelRPM = (int16)FMath::Clamp(GetWheelRPM(), (float)MIN_int16, (float)MAX_int16);
+	Snapshot.ServerTime = GetWorld()->GetTimeSeconds();
+	MARK_PROPERTY_DIRTY_FROM_NAME(ASurvivalVehicle, Snapshot, this);
+}
+
+void ASurvivalVehicle::OnRep_Snapshot()
+{
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		return;
+	}
+
+	//The driver simulates the vehicle itself, and is only corrected towards where the server has it
+	if (GetLocalRole() != ROLE_SimulatedProxy)
+	{
+		ApplySnapshotCorrection();
+		return;
+	}
+
+	if (SnapshotBuffer.Num() && Snapshot.ServerTime <= SnapshotBuffer.Last().ServerTime)
+	{
+		return;
+	}
+
+	if (SnapshotBuffer.Num() >= MaxBufferedSnapshots)
+	{
+		SnapshotBuffer.RemoveAt(0, 1, false);
+	}
+
+	SnapshotBuffer.Add(Snapshot);
+
+	if (bProxyPhysicsEnabled)
+	{
+		ApplySnapshotCorrection();
+	}
+	else
+	{
+		//Kinematic proxies don't get physics wake events, so the snapshot wakes them up to be interpolated
+		WakeUp();
+	}
+}
+
+void ASurvivalVehicle::ApplySnapshotCorrection()
+{
+	//Same as the default replicated movement, the snapshot becomes the target our physics is corrected towards
+	FRepMovement& RepMovement = GetReplicatedMovement_Mutable();
+	RepMovement.Location = Snapshot.Location;
+	RepMovement.Rotation = Snapshot.GetRotation();
+	RepMovement.LinearVelocity = Snapshot.Velocity;
+	RepMovement.AngularVelocity = Snapshot.AngularVelocity;
+	RepMovement.bRepPhysics = true;
+	RepMovement.bSimulatedPhysicSleep = false;
+
+	PostNetReceivePhysicState();
+}
+
+void ASurvivalVehicle::PostNetReceiveRole()
+{
+	Super::PostNetReceiveRole();
+
+	if (GetLocalRole() == ROLE_SimulatedProxy)
+	{
+		//We may have been put to sleep while we were driven here, which unregistered us
+		if (UVehicleManagerSubsystem* VehicleManager = GetWorld()->GetSubsystem<UVehicleManagerSubsystem>())
+		{
+			VehicleManager->RegisterVehicle(this);
+		}
+	}
+	else
+	{
+		SetProxyPhysicsEnabled(true);
+	}
+}
+
+void ASurvivalVehicle::SetProxyPhysicsEnabled(const bool bEnabled)
+{
+	//Only remote vehicles are ever made kinematic, but any vehicle that was can be given physics back
+	if (bProxyPhysicsEnabled == bEnabled || HasAuthority() || (!bEnabled && GetLocalRole() != ROLE_SimulatedProxy))
+	{
+		return;
+	}
+
+	bProxyPhysicsEnabled = bEnabled;
+
+	GetMesh()->SetSimulatePhysics(bEnabled);
+
+	if (bEnabled && SnapshotBuffer.Num())
+	{
+		//Carry on from where we were being interpolated, at the speed we were last told
+		GetMesh()->SetPhysicsLinearVelocity(SnapshotBuffer.Last().Velocity);
+		GetMesh()->SetPhysicsAngularVelocityInDegrees(SnapshotBuffer.Last().AngularVelocity);
+	}
+}
+
+bool ASurvivalVehicle::UpdateProxyInterpolation()
+{
+	if (bProxyPhysicsEnabled || !SnapshotBuffer.Num())
+	{
+		return false;
+	}
+
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	const float RenderTime = (GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds()) - CVarVehicleProxyInterpolationDelay.GetValueOnGameThread();
+
+	//Find the snapshots either side of the render time.  There are only a few, so a linear search is fine
+	int32 NextIndex = 0;
+	while (NextIndex < SnapshotBuffer.Num() && SnapshotBuffer[NextIndex].ServerTime <= RenderTime)
+	{
+		++NextIndex;
+	}
+
+	FVector NewLocation;
+	FRotator NewRotation;
+	bool bAtRest = false;
+
+	if (NextIndex == 0)
+	{
+		//Not caught up with the first snapshot yet, wait there
+		const FVehicleSnapshot& First = SnapshotBuffer[0];
+
+		NewLocation = First.Location;
+		NewRotation = First.GetRotation();
+		ProxyWheelRPM = First.WheelRPM;
+	}
+	else if (NextIndex == SnapshotBuffer.Num())
+	{
+		//Past the last snapshot, carry on in the direction it was going for a little while
+		const FVehicleSnapshot& Last = SnapshotBuffer.Last();
+		const float ExtrapolationTime = FMath::Min(RenderTime - Last.ServerTime, CVarVehicleProxyMaxExtrapolation.GetValueOnGameThread());
+
+		NewLocation = Last.Location + Last.Velocity * ExtrapolationTime;
+		NewRotation = Last.GetRotation();
+		ProxyWheelRPM = Last.WheelRPM;
+
+		bAtRest = Last.Velocity.IsNearlyZero(1.f) && Last.AngularVelocity.IsNearlyZero(1.f);
+
+		SnapshotBuffer.RemoveAt(0, SnapshotBuffer.Num() - 1, false);
+	}
+	else
+	{
+		const FVehicleSnapshot& From = SnapshotBuffer[NextIndex - 1];
+		const FVehicleSnapshot& To = SnapshotBuffer[NextIndex];
+		const float SnapshotInterval = FMath::Max(To.ServerTime - From.ServerTime, KINDA_SMALL_NUMBER);
+		const float Alpha = (RenderTime - From.ServerTime) / SnapshotInterval;
+
+		//Hermite, using the velocities as tangents, so the path curves the way the vehicle actually went
+		NewLocation = FMath::CubicInterp(FVector(From.Location), From.Velocity * SnapshotInterval, FVector(To.Location), To.Velocity * SnapshotInterval, Alpha);
+		NewRotation = FQuat::Slerp(From.GetRotation().Quaternion(), To.GetRotation().Quaternion(), Alpha).Rotator();
+		ProxyWheelRPM = FMath::Lerp((float)From.WheelRPM, (float)To.WheelRPM, Alpha);
+
+		//We won't need anything before the snapshot we're interpolating from again
+		SnapshotBuffer.RemoveAt(0, NextIndex - 1, false);
+	}
+
+	SetActorLocationAndRotation(NewLocation, NewRotation, false, nullptr, ETeleportType::TeleportPhysics);
+
+	return bAtRest;
+}
+
+float ASurvivalVehicle::GetWheelRPM() const
+{
+	if (!bProxyPhysicsEnabled)
+	{
+		return ProxyWheelRPM;
+	}
+
+	const UWheeledVehicleMovementComponent* VehicleMovement = GetVehicleMovementComponent();
+	const UVehicleWheel* Wheel = VehicleMovement->Wheels.Num() ? VehicleMovement->Wheels[0] : nullptr;
+
+	if (!Wheel || Wheel->ShapeRadius <= 0.f)
+	{
+		return 0.f;
+	}
+
+	return VehicleMovement->GetForwardSpeed() / (2.f * PI * Wheel->ShapeRadius) * 60.f;
+}
+
+void ASurvivalVehicle::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(ASurvivalVehicle, Driver, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ASurvivalVehicle, Snapshot, Params);
+}
+
@@ -1,62 +1,267 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "WheeledVehicle.h"
-#include "SurvivalVehicle.generated.h"
-
-/**
- * 
- */
-UCLASS()
-class SURVIVALGAME_API ASurvivalVehicle : public AWheeledVehicle
-{
-	GENERATED_BODY()
-
-public:
-	ASurvivalVehicle();
-
-	virtual void Tick(float DeltaTime) override;
-
-	virtual void SetupPlayerInputComponent(UInputComponent* PlayerInputComponent) override;
-
-	/* Throttle / Steering */
-	void ApplyThrottle(float Val);
-	void ApplySteering(float Val);
-
-	/* Look around */
-	void LookUp(float Val);
-	void Turn(float Val);
-
-	/* Handbrake */
-	void OnHandbrakePressed();
-	void OnHandbrakeReleased();
-
-	/* Update in air physics */
-	void UpdateInAirControl(float DeltaTime);
-
-	FText InteractionNameText = FText::FromString("Pickup Truck");
-	FText InteractionActionText = FText::FromString("Drive the truck.");
-	float InteractionTime = 0.5f;
-
-protected:
-	/* Spring arm that will offset the camera */
-	UPROPERTY(Category = Camera, EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
-	class USpringArmComponent* SpringArm;
-
-	/* Camera component that will be our viewpoint */
-	UPROPERTY(Category = Camera, EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
-	class UCameraComponent* Camera;
-
-	UPROPERTY(EditDefaultsOnly)
-	class UInteractionComponent* InteractionComponent;
-
-	UPROPERTY(ReplicatedUsing = OnRep_Driver)
-	class ASurvivalCharacter* Driver;
-
-	UFUNCTION()
-	void OnRep_Driver();
-
-	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WheeledVehicle.h"
+#include "SurvivalVehicle.generated.h"
+
+//A compact copy of a vehicles physics state.  Replicated to remote clients instead of the default replicated movement
+USTRUCT()
+struct FVehicleSnapshot
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY()
+	FVector_NetQuantize Location;
+
+	//Rotation, compressed to shorts
+	UPROPERTY()
+	uint16 Pitch = 0;
+
+	UPROPERTY()
+	uint16 Yaw = 0;
+
+	UPROPERTY()
+	uint16 Roll = 0;
+
+	UPROPERTY()
+	FVector_NetQuantize Velocity;
+
+	//In degrees a second
+	UPROPERTY()
+	FVector_NetQuantize AngularVelocity;
+
+	UPROPERTY()
+	int16 WheelRPM = 0;
+
+	//The server world time the snapshot was taken at
+	UPROPERTY()
+	float ServerTime = 0.f;
+
+	FORCEINLINE FRotator GetRotation() const
+	{
+		return FRotator(FRotator::DecompressAxisFromShort(Pitch), FRotator::DecompressAxisFromShort(Yaw), FRotator::DecompressAxisFromShort(Roll));
+	}
+
+	FORCEINLINE void SetRotation(const FRotator& Rotation)
+	{
+		Pitch = FRotator::CompressAxisToShort(Rotation.Pitch);
+		Yaw = FRotator::CompressAxisToShort(Rotation.Yaw);
+		Roll = FRotator::CompressAxisToShort(Rotation.Roll);
+	}
+};
+
+/**
+ * 
+ */
+UCLASS()
+class SURVIVALGAME_API ASurvivalVehicle : public AWheeledVehicle
+{
+	GENERATED_BODY()
+
+public:
+	ASurvivalVehicle();
+
+	virtual void PossessedBy(AController* NewController) override;
+	virtual void UnPossessed() override;
+	virtual void PawnClientRestart() override;
+
+	virtual void SetupPlayerInputComponent(UInputComponent* PlayerInputComponent) override;
+
+	/* Throttle / Steering */
+	void ApplyThrottle(float Val);
+	void ApplySteering(float Val);
+
+	/* Look around */
+	void LookUp(float Val);
+	void Turn(float Val);
+
+	/* Handbrake */
+	void OnHandbrakePressed();
+	void OnHandbrakeReleased();
+
+	/* Update in air physics.  Called by the vehicle manager, with whether last frames ground probe found anything under us */
+	void UpdateInAirControl(float DeltaTime, const bool bTouchingGround);
+
+	/* True if none of the wheels are touching anything */
+	bool IsInAir() const;
+
+	/* True if the vehicle is on its side or roof */
+	bool IsFlipped() const;
+
+	/* Replicate less, and leave the vehicle manager unless we're a remote vehicle, until something wakes the vehicle up */
+	void Sleep();
+	void WakeUp();
+
+	FORCEINLINE bool IsSleeping() const { return bSleeping; }
+
+	/* [client] Switch between simulating physics (near the local player) and interpolating snapshots kinematically (far away).  Only
+	remote vehicles can be made kinematic, a vehicle driven here always has its physics turned back on */
+	void SetProxyPhysicsEnabled(const bool bEnabled);
+
+	FORCEINLINE bool IsProxyPhysicsEnabled() const { return bProxyPhysicsEnabled; }
+
+	/* [remote client] Move a kinematic proxy to where the snapshots say it was, a little in the past.  Returns true once it has come to rest */
+	bool UpdateProxyInterpolation();
+
+	/* Our NetUpdateFrequency while awake and close to players, which the vehicle manager scales down with distance */
+	FORCEINLINE float GetAwakeNetUpdateFrequency() const { return AwakeNetUpdateFrequency; }
+
+	/* How fast the wheels are turning, for animating wheels on kinematic proxies */
+	UFUNCTION(BlueprintPure, Category = "Vehicle")
+	float GetWheelRPM() const;
+
+	/* [server] Set who is driving the vehicle */
+	void SetDriver(class ASurvivalCharacter* NewDriver);
+
+	/* [owning client] Get in straight away, instead of waiting for the server to possess us.  Throttle and steering are buffered
+	until it does and then replayed, or thrown away if the server gives the seat to someone else */
+	void PredictEnter(class ASurvivalCharacter* Character);
+
+	/* [owning client] Get out straight away.  If the server doesn't clear Driver in time, the character is put back in */
+	void PredictExit();
+
+	/* [driver] Get out of the vehicle, predicting it on the owning client */
+	void ExitVehicle();
+
+	FORCEINLINE bool IsPredictingEnter() const { return PredictedDriver.IsValid(); }
+
+	/* Called by the vehicle manager for vehicles driven or about to be driven here.  Records input while waiting for the server and
+	replays it once we're possessed */
+	void UpdateBufferedInput();
+
+	FORCEINLINE class ASurvivalCharacter* GetDriver() const { return Driver; }
+
+	FText InteractionNameText = FText::FromString("Pickup Truck");
+	FText InteractionActionText = FText::FromString("Drive the truck.");
+	float InteractionTime = 0.5f;
+
+protected:
+	/* Spring arm that will offset the camera */
+	UPROPERTY(Category = Camera, EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
+	class USpringArmComponent* SpringArm;
+
+	/* Camera component that will be our viewpoint */
+	UPROPERTY(Category = Camera, EditDefaultsOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
+	class UCameraComponent* Camera;
+
+	UPROPERTY(EditDefaultsOnly)
+	class UInteractionComponent* InteractionComponent;
+
+	UFUNCTION()
+	void OnRep_Driver();
+
+	/* Get in.  The server possesses us for the character, and the owning client predicts it */
+	UFUNCTION()
+	void OnInteract(class ASurvivalCharacter* Character);
+
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerExitVehicle();
+
+	/* [server] The character whose controller is possessing us, so PossessedBy knows who to seat */
+	TWeakObjectPtr<class ASurvivalCharacter> EnteringDriver;
+
+	/* The socket the driver sits in */
+	UPROPERTY(EditDefaultsOnly, Category = "Seat")
+	FName DriverSeatSocket;
+
+	/* Where the driver gets out, relative to the vehicle */
+	UPROPERTY(EditDefaultsOnly, Category = "Seat")
+	FVector ExitOffset;
+
+	/* [owning client] The character we predicted getting in or out, until the server agrees */
+	TWeakObjectPtr<class ASurvivalCharacter> PredictedDriver;
+	TWeakObjectPtr<class ASurvivalCharacter> PredictedExitDriver;
+
+	/* [owning client] When we started predicting, to give up if the server never answers */
+	float PredictionStartTime;
+
+	/* [owning client] Binds our input while we wait to be possessed */
+	UPROPERTY(Transient)
+	class UInputComponent* PredictedInputComponent;
+
+	struct FBufferedVehicleInput
+	{
+		float Throttle = 0.f;
+		float Steering = 0.f;
+		bool bHandbrake = false;
+	};
+
+	/* [owning client] Input recorded while predicting, oldest first */
+	TArray<FBufferedVehicleInput> BufferedInputs;
+
+	bool bHandbrakeInput;
+
+	/* True while input shouldn't go straight to the movement component, because we're waiting for the server or replaying */
+	FORCEINLINE bool IsBufferingInput() const { return IsPredictingEnter() || PredictedExitDriver.IsValid() || BufferedInputs.Num() > 0; }
+
+	void ApplyInput(const FBufferedVehicleInput& Input);
+
+	/* Sit a character in the drivers seat, or take them out of it */
+	void AttachDriver(class ASurvivalCharacter* Character);
+	void DetachDriver(class ASurvivalCharacter* Character);
+
+	/* [owning client] The server possessed us for the character we predicted, or gave the seat to someone else */
+	void ConfirmPredictedEnter();
+	void CancelPredictedEnter();
+
+	/* How often a sleeping vehicle is considered for replication */
+	UPROPERTY(EditDefaultsOnly, Category = "Sleep")
+	float SleepingNetUpdateFrequency;
+
+	bool bSleeping;
+
+	/* Our NetUpdateFrequency while awake, restored when we wake up */
+	float AwakeNetUpdateFrequency;
+
+	/* [server] Our physics state, for the driver to be corrected towards and remote clients to simulate or interpolate */
+	UPROPERTY(ReplicatedUsing = OnRep_Snapshot)
+	FVehicleSnapshot Snapshot;
+
+	UFUNCTION()
+	void OnRep_Snapshot();
+
+	/* [server] Update Snapshot from our physics state */
+	void UpdateSnapshot();
+
+	/* [client] Correct our physics towards Snapshot */
+	void ApplySnapshotCorrection();
+
+	/* Our physics may have been turned off as a remote vehicle, so it's turned back on if we're driven here */
+	virtual void PostNetReceiveRole() override;
+
+	/* [remote client] The last few snapshots, oldest first */
+	TArray<FVehicleSnapshot> SnapshotBuffer;
+
+	/* [remote client] Whether we simulate physics or interpolate snapshots */
+	bool bProxyPhysicsEnabled;
+
+	/* [remote client] The wheel RPM interpolated from snapshots, while we aren't simulating physics */
+	float ProxyWheelRPM;
+
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	/* The last throttle and steering input, kept so in air control doesn't need to look the axes up again */
+	float ThrottleInput;
+	float SteeringInput;
+
+	/* The vehicle sleeps when its body does, and wakes with it, e.g. when something hits or pushes it */
+	UFUNCTION()
+	void OnMeshWake(UPrimitiveComponent* WakingComponent, FName BoneName);
+
+	UFUNCTION()
+	void OnMeshSleep(UPrimitiveComponent* SleepingComponent, FName BoneName);
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+private:
+	/* Push model replicated, so only ever set it through SetDriver, which marks it dirty */
+	UPROPERTY(ReplicatedUsing = OnRep_Driver)
+	class ASurvivalCharacter* Driver;
+};
@@ -0,0 +1,243 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VehicleManagerSubsystem.h"
+#include "../SurvivalGame.h"
+#include "SurvivalVehicle.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("Vehicle Manager Tick"), STAT_VehicleManagerTick, STATGROUP_SurvivalGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Vehicle Manager Vehicles"), STAT_VehicleManagerVehicles, STATGROUP_SurvivalGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Vehicle Manager Ground Probes"), STAT_VehicleManagerGroundProbes, STATGROUP_SurvivalGame);
+
+static TAutoConsoleVariable<float> CVarVehicleGroundProbeMargin(
+	TEXT("Vehicle.GroundProbeMargin"),
+	30.f,
+	TEXT("How far below a vehicles bounds the ground probe looks for something the vehicle is resting on."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarVehicleProxyPhysicsDistance(
+	TEXT("Vehicle.Proxy.PhysicsDistance"),
+	5000.f,
+	TEXT("Remote vehicles closer than this to the local player simulate physics, further ones are interpolated from snapshots."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarVehicleNetNearDistance(
+	TEXT("Vehicle.NetFrequency.NearDistance"),
+	3000.f,
+	TEXT("Vehicles this close to a player replicate at their full net update frequency."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarVehicleNetFarDistance(
+	TEXT("Vehicle.NetFrequency.FarDistance"),
+	15000.f,
+	TEXT("Vehicles this far from every player replicate at Vehicle.NetFrequency.MinFrequency."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarVehicleNetMinFrequency(
+	TEXT("Vehicle.NetFrequency.MinFrequency"),
+	5.f,
+	TEXT("The net update frequency of awake vehicles far from every player."),
+	ECVF_Default);
+
+//Proxies switch back to interpolation a little further out than they switch to physics, so they don't flip flop on the boundary
+static const float ProxyPhysicsHysteresis = 1.1f;
+
+void UVehicleManagerSubsystem::Deinitialize()
+{
+	Super::Deinitialize();
+
+	Vehicles.Empty();
+}
+
+void UVehicleManagerSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VehicleManagerTick);
+	INC_DWORD_STAT_BY(STAT_VehicleManagerVehicles, Vehicles.Num());
+
+	ReadGroundProbes();
+
+	UWorld* World = GetWorld();
+
+	//Where the players are, for the server to scale update rates and for clients to pick which proxies get physics
+	TArray<FVector> PlayerLocations;
+	FVector LocalViewLocation = FVector::ZeroVector;
+	bool bHasLocalView = false;
+
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PC = It->Get())
+		{
+			PlayerLocations.Add(PC->GetFocalLocation());
+
+			if (PC->IsLocalController() && !bHasLocalView)
+			{
+				LocalViewLocation = PC->GetFocalLocation();
+				bHasLocalView = true;
+			}
+		}
+	}
+
+	TArray<ASurvivalVehicle*, TInlineAllocator<16>> RestingProxies;
+
+	for (const FManagedVehicle& ManagedVehicle : Vehicles)
+	{
+		ASurvivalVehicle* Vehicle = ManagedVehicle.Vehicle.Get();
+
+		if (!Vehicle)
+		{
+			continue;
+		}
+
+		if (Vehicle->HasAuthority())
+		{
+			UpdateNetUpdateFrequency(Vehicle, PlayerLocations);
+		}
+		else if (Vehicle->GetLocalRole() == ROLE_SimulatedProxy && !Vehicle->IsPredictingEnter() && bHasLocalView && UpdateProxy(Vehicle, LocalViewLocation))
+		{
+			RestingProxies.Add(Vehicle);
+		}
+
+		//Only the driver has inputs to apply
+		if (Vehicle->IsLocallyControlled() || Vehicle->IsPredictingEnter())
+		{
+			Vehicle->UpdateBufferedInput();
+		}
+
+		if (Vehicle->IsLocallyControlled())
+		{
+			Vehicle->UpdateInAirControl(DeltaTime, ManagedVehicle.bTouchingGround);
+		}
+	}
+
+	//Kinematic proxies don't get sleep events, so we put them to sleep once they stop
+	for (ASurvivalVehicle* Vehicle : RestingProxies)
+	{
+		Vehicle->Sleep();
+	}
+
+	StartGroundProbes();
+}
+
+bool UVehicleManagerSubsystem::IsTickable() const
+{
+	return !IsTemplate() && Vehicles.Num() > 0;
+}
+
+TStatId UVehicleManagerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UVehicleManagerSubsystem, STATGROUP_Tickables);
+}
+
+UWorld* UVehicleManagerSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+void UVehicleManagerSubsystem::RegisterVehicle(ASurvivalVehicle* Vehicle)
+{
+	if (Vehicle && !Vehicles.ContainsByPredicate([Vehicle](const FManagedVehicle& ManagedVehicle) { return ManagedVehicle.Vehicle == Vehicle; }))
+	{
+		FManagedVehicle& ManagedVehicle = Vehicles.AddDefaulted_GetRef();
+		ManagedVehicle.Vehicle = Vehicle;
+	}
+}
+
+void UVehicleManagerSubsystem::UnregisterVehicle(ASurvivalVehicle* Vehicle)
+{
+	//Any probe in flight for the vehicle is just never read back
+	Vehicles.RemoveAllSwap([Vehicle](const FManagedVehicle& ManagedVehicle) { return ManagedVehicle.Vehicle == Vehicle; });
+}
+
+void UVehicleManagerSubsystem::ReadGroundProbes()
+{
+	UWorld* World = GetWorld();
+
+	for (int32 i = Vehicles.Num() - 1; i >= 0; --i)
+	{
+		FManagedVehicle& ManagedVehicle = Vehicles[i];
+
+		if (!ManagedVehicle.Vehicle.IsValid())
+		{
+			Vehicles.RemoveAtSwap(i);
+			continue;
+		}
+
+		if (ManagedVehicle.GroundProbe.IsValid())
+		{
+			FTraceDatum TraceDatum;
+			if (World->QueryTraceData(ManagedVehicle.GroundProbe, TraceDatum))
+			{
+				ManagedVehicle.bTouchingGround = TraceDatum.OutHits.Num() > 0;
+			}
+
+			ManagedVehicle.GroundProbe = FTraceHandle();
+		}
+	}
+}
+
+void UVehicleManagerSubsystem::StartGroundProbes()
+{
+	UWorld* World = GetWorld();
+	const float ProbeMargin = CVarVehicleGroundProbeMargin.GetValueOnGameThread();
+
+	for (FManagedVehicle& ManagedVehicle : Vehicles)
+	{
+		ASurvivalVehicle* Vehicle = ManagedVehicle.Vehicle.Get();
+
+		if (!Vehicle || !Vehicle->IsLocallyControlled())
+		{
+			continue;
+		}
+
+		//Straight down from the middle of the vehicle to just under its bounds, so it works whichever way up the vehicle is
+		const FBoxSphereBounds& Bounds = Vehicle->GetMesh()->Bounds;
+		const FVector ProbeEnd = Bounds.Origin - FVector(0.f, 0.f, Bounds.BoxExtent.Z + ProbeMargin);
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(VehicleGroundProbe), false, Vehicle);
+
+		ManagedVehicle.GroundProbe = World->AsyncLineTraceByChannel(EAsyncTraceType::Test, Bounds.Origin, ProbeEnd, ECC_Visibility, QueryParams);
+		INC_DWORD_STAT(STAT_VehicleManagerGroundProbes);
+	}
+}
+
+void UVehicleManagerSubsystem::UpdateNetUpdateFrequency(ASurvivalVehicle* Vehicle, const TArray<FVector>& PlayerLocations) const
+{
+	const FVector VehicleLocation = Vehicle->GetActorLocation();
+	float ClosestDistanceSq = MAX_FLT;
+
+	for (const FVector& PlayerLocation : PlayerLocations)
+	{
+		ClosestDistanceSq = FMath::Min(ClosestDistanceSq, FVector::DistSquared(PlayerLocation, VehicleLocation));
+	}
+
+	const float NearDistance = CVarVehicleNetNearDistance.GetValueOnGameThread();
+	const float FarDistance = FMath::Max(CVarVehicleNetFarDistance.GetValueOnGameThread(), NearDistance + 1.f);
+	const float FarAlpha = ClosestDistanceSq == MAX_FLT ? 1.f : FMath::Clamp(FMath::GetRangePct(NearDistance, FarDistance, FMath::Sqrt(ClosestDistanceSq)), 0.f, 1.f);
+
+	const float AwakeFrequency = Vehicle->GetAwakeNetUpdateFrequency();
+	Vehicle->NetUpdateFrequency = FMath::Lerp(AwakeFrequency, FMath::Min(CVarVehicleNetMinFrequency.GetValueOnGameThread(), AwakeFrequency), FarAlpha);
+}
+
+bool UVehicleManagerSubsystem::UpdateProxy(ASurvivalVehicle* Vehicle, const FVector& ViewLocation) const
+{
+	const float PhysicsDistance = CVarVehicleProxyPhysicsDistance.GetValueOnGameThread();
+	const float DistanceSq = FVector::DistSquared(Vehicle->GetActorLocation(), ViewLocation);
+
+	if (Vehicle->IsProxyPhysicsEnabled())
+	{
+		if (DistanceSq > FMath::Square(PhysicsDistance * ProxyPhysicsHysteresis))
+		{
+			Vehicle->SetProxyPhysicsEnabled(false);
+		}
+	}
+	else if (DistanceSq < FMath::Square(PhysicsDistance))
+	{
+		Vehicle->SetProxyPhysicsEnabled(true);
+	}
+
+	//Sleeping proxies are only here for the distance check
+	return !Vehicle->IsSleeping() && Vehicle->UpdateProxyInterpolation();
+}
@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "WorldCollision.h"
+#include "VehicleManagerSubsystem.generated.h"
+
+class ASurvivalVehicle;
+
+/**
+ * Updates every awake vehicle in the world in one pass, instead of each vehicle ticking on its own.  The ground probes of every
+ * driven vehicle go out together as async traces, and are read back the next frame to decide how much air control to apply.
+ * Sleeping vehicles aren't registered, so parked vehicles cost nothing, except on remote clients where they stay registered for the
+ * distance check below.
+ *
+ * Also does the distance based LOD for vehicles.  The server replicates vehicles less often the further they are from every player,
+ * and clients only simulate physics for remote vehicles near the local player, interpolating the rest from their snapshots.
+ */
+UCLASS()
+class SURVIVALGAME_API UVehicleManagerSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	//FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+	/* Start updating a vehicle.  Vehicles register when they start play, wake up or become remote vehicles */
+	void RegisterVehicle(ASurvivalVehicle* Vehicle);
+
+	/* Stop updating a vehicle.  Vehicles unregister when they end play, or go to sleep unless they're remote vehicles */
+	void UnregisterVehicle(ASurvivalVehicle* Vehicle);
+
+	FORCEINLINE int32 GetNumActiveVehicles() const { return Vehicles.Num(); }
+
+protected:
+
+	struct FManagedVehicle
+	{
+		TWeakObjectPtr<ASurvivalVehicle> Vehicle;
+
+		//The ground probe started last frame, if the vehicle was driven
+		FTraceHandle GroundProbe;
+
+		//Whether the last ground probe found something under the vehicle
+		bool bTouchingGround = true;
+	};
+
+	/* Read back last frames ground probes */
+	void ReadGroundProbes();
+
+	/* Start this frames ground probes, for every vehicle that is driven here */
+	void StartGroundProbes();
+
+	/* [server] Scale a vehicles net update frequency down with its distance to the closest player */
+	void UpdateNetUpdateFrequency(ASurvivalVehicle* Vehicle, const TArray<FVector>& PlayerLocations) const;
+
+	/* [client] Pick physics or interpolation for a remote vehicle, and interpolate it if it's awake and needs it.  Returns true if it
+	has come to rest */
+	bool UpdateProxy(ASurvivalVehicle* Vehicle, const FVector& ViewLocation) const;
+
+	TArray<FManagedVehicle> Vehicles;
+};
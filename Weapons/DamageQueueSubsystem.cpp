@@ -0,0 +1,241 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DamageQueueSubsystem.h"
+#include "../SurvivalGame.h"
+#include "Weapon.h"
+#include "WeaponLatencyTracer.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/DamageType.h"
+#include "Engine/World.h"
+#include "Algo/StableSort.h"
+
+DECLARE_CYCLE_STAT(TEXT("Damage Queue Resolve"), STAT_DamageQueueResolve, STATGROUP_SurvivalGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Queue Hits"), STAT_DamageQueueHits, STATGROUP_SurvivalGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Queue Victims"), STAT_DamageQueueVictims, STATGROUP_SurvivalGame);
+
+void UDamageQueueSubsystem::Deinitialize()
+{
+	Super::Deinitialize();
+
+	QueuedHits.Empty();
+	ConfirmedWeapons.Empty();
+}
+
+void UDamageQueueSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DamageQueueResolve);
+
+	//Resolving damage can queue more (e.g. something exploding when it dies), that waits until next frame
+	TArray<FQueuedHit> Hits = MoveTemp(QueuedHits);
+	QueuedHits.Reset();
+
+	//Group hits by victim, then by who did the damage and how.  The sort is stable, so each groups hits stay in the order they happened
+	Algo::StableSort(Hits, [](const FQueuedHit& A, const FQueuedHit& B)
+	{
+		if (A.Victim != B.Victim)
+		{
+			return A.Victim.Get() < B.Victim.Get();
+		}
+		if (A.InstigatedBy != B.InstigatedBy)
+		{
+			return A.InstigatedBy.Get() < B.InstigatedBy.Get();
+		}
+		if (A.DamageCauser != B.DamageCauser)
+		{
+			return A.DamageCauser.Get() < B.DamageCauser.Get();
+		}
+		return *A.DamageTypeClass < *B.DamageTypeClass;
+	});
+
+	int32 FirstHit = 0;
+	for (int32 i = 1; i <= Hits.Num(); ++i)
+	{
+		if (i == Hits.Num() || Hits[i].Victim != Hits[FirstHit].Victim)
+		{
+			ResolveVictim(Hits, FirstHit, i - 1);
+			FirstHit = i;
+		}
+	}
+
+	const double Now = FPlatformTime::Seconds();
+
+	for (const TPair<TWeakObjectPtr<AWeapon>, FHitConfirm>& ConfirmedWeapon : ConfirmedWeapons)
+	{
+		if (AWeapon* Weapon = ConfirmedWeapon.Key.Get())
+		{
+			Weapon->ClientConfirmHit(ConfirmedWeapon.Value.ShotTraceId, (float)(Now - ConfirmedWeapon.Value.QueueTime));
+		}
+	}
+
+	ConfirmedWeapons.Reset();
+}
+
+bool UDamageQueueSubsystem::IsTickable() const
+{
+	return !IsTemplate() && QueuedHits.Num() > 0;
+}
+
+TStatId UDamageQueueSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDamageQueueSubsystem, STATGROUP_Tickables);
+}
+
+UWorld* UDamageQueueSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+void UDamageQueueSubsystem::QueueDamage(AActor* Victim, const float Damage, const FHitResult& Hit, const FVector& ShotDirection, AController* InstigatedBy, AActor* DamageCauser, TSubclassOf<UDamageType> DamageTypeClass, const uint16 ShotTraceId /*= 0*/)
+{
+	if (!Victim || Damage <= 0.f)
+	{
+		return;
+	}
+
+	FQueuedHit& QueuedHit = QueuedHits.AddDefaulted_GetRef();
+	QueuedHit.Victim = Victim;
+	QueuedHit.Damage = Damage;
+	QueuedHit.Hit = Hit;
+	QueuedHit.ShotDirection = ShotDirection;
+	QueuedHit.InstigatedBy = InstigatedBy;
+	QueuedHit.DamageCauser = DamageCauser;
+	QueuedHit.DamageTypeClass = DamageTypeClass;
+	QueuedHit.ShotTraceId = ShotTraceId;
+	QueuedHit.QueueTime = FPlatformTime::Seconds();
+
+	INC_DWORD_STAT(STAT_DamageQueueHits);
+}
+
+void UDamageQueueSubsystem::QueueRadialDamage(AActor* Victim, const float BaseDamage, const FVector& Origin, const FRadialDamageParams& Params, const FHitResult& Hit, AController* InstigatedBy, AActor* DamageCauser, TSubclassOf<UDamageType> DamageTypeClass)
+{
+	if (!Victim || BaseDamage <= 0.f)
+	{
+		return;
+	}
+
+	FQueuedHit& QueuedHit = QueuedHits.AddDefaulted_GetRef();
+	QueuedHit.Victim = Victim;
+	QueuedHit.Damage = BaseDamage;
+	QueuedHit.Hit = Hit;
+	QueuedHit.ShotDirection = (Hit.ImpactPoint - Origin).GetSafeNormal();
+	QueuedHit.InstigatedBy = InstigatedBy;
+	QueuedHit.DamageCauser = DamageCauser;
+	QueuedHit.DamageTypeClass = DamageTypeClass;
+	QueuedHit.QueueTime = FPlatformTime::Seconds();
+	QueuedHit.bRadial = true;
+	QueuedHit.Origin = Origin;
+	QueuedHit.RadialParams = Params;
+
+	INC_DWORD_STAT(STAT_DamageQueueHits);
+}
+
+void UDamageQueueSubsystem::ResolveVictim(const TArray<FQueuedHit>& Hits, const int32 FirstHit, const int32 LastHit)
+{
+	AActor* Victim = Hits[FirstHit].Victim.Get();
+
+	if (!Victim)
+	{
+		return;
+	}
+
+	FResolvedDamage ResolvedDamage;
+	ResolvedDamage.Victim = Victim;
+	ResolvedDamage.Hits.Reserve(LastHit - FirstHit + 1);
+
+	for (int32 i = FirstHit; i <= LastHit; ++i)
+	{
+		const FQueuedHit& QueuedHit = Hits[i];
+
+		FResolvedHit& ResolvedHit = ResolvedDamage.Hits.AddDefaulted_GetRef();
+		ResolvedHit.InstigatedBy = QueuedHit.InstigatedBy.Get();
+		ResolvedHit.DamageCauser = QueuedHit.DamageCauser.Get();
+		ResolvedHit.BoneName = QueuedHit.Hit.BoneName;
+		ResolvedHit.Damage = QueuedHit.Damage;
+	}
+
+	int32 FirstGroupHit = FirstHit;
+	for (int32 i = FirstHit + 1; i <= LastHit + 1; ++i)
+	{
+		if (i > LastHit || !CanMergeHits(Hits[i], Hits[FirstGroupHit]))
+		{
+			ResolvedDamage.DamageTaken += ApplyMergedHits(Victim, Hits, FirstGroupHit, i - 1);
+			FirstGroupHit = i;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_DamageQueueVictims);
+
+	OnDamageResolved.Broadcast(ResolvedDamage);
+}
+
+float UDamageQueueSubsystem::ApplyMergedHits(AActor* Victim, const TArray<FQueuedHit>& Hits, const int32 FirstHit, const int32 LastHit)
+{
+	float TotalDamage = 0.f;
+
+	for (int32 i = FirstHit; i <= LastHit; ++i)
+	{
+		TotalDamage += Hits[i].Damage;
+	}
+
+	//Every hit in the group shares an instigator, causer and damage type.  The last one decides the hit reaction
+	const FQueuedHit& LastQueuedHit = Hits[LastHit];
+	float DamageTaken = 0.f;
+
+	if (LastQueuedHit.bRadial)
+	{
+		//Radial hits only merge with hits from the same explosion, and the victim scales the damage by its distance from it
+		FRadialDamageEvent DamageEvent;
+		DamageEvent.DamageTypeClass = LastQueuedHit.DamageTypeClass;
+		DamageEvent.Origin = LastQueuedHit.Origin;
+		DamageEvent.Params = LastQueuedHit.RadialParams;
+
+		for (int32 i = FirstHit; i <= LastHit; ++i)
+		{
+			DamageEvent.ComponentHits.Add(Hits[i].Hit);
+		}
+
+		DamageTaken = Victim->TakeDamage(TotalDamage, DamageEvent, LastQueuedHit.InstigatedBy.Get(), LastQueuedHit.DamageCauser.Get());
+	}
+	else
+	{
+		FPointDamageEvent DamageEvent(TotalDamage, LastQueuedHit.Hit, LastQueuedHit.ShotDirection, LastQueuedHit.DamageTypeClass);
+		DamageTaken = Victim->TakeDamage(TotalDamage, DamageEvent, LastQueuedHit.InstigatedBy.Get(), LastQueuedHit.DamageCauser.Get());
+	}
+
+	if (AWeapon* Weapon = Cast<AWeapon>(LastQueuedHit.DamageCauser.Get()))
+	{
+		for (int32 i = FirstHit; i <= LastHit; ++i)
+		{
+			if (Hits[i].ShotTraceId)
+			{
+				FWeaponLatencyTracer::RecordStage(FWeaponLatencyTracer::MakeTraceId(Weapon, Hits[i].ShotTraceId), EWeaponTraceStage::ApplyDamage);
+			}
+		}
+
+		//Hits are in the order they happened, so the confirm ends up with the latest shot.  A weapon hitting several victims
+		//confirms the latest one resolved
+		if (DamageTaken > 0.f)
+		{
+			FHitConfirm& HitConfirm = ConfirmedWeapons.FindOrAdd(Weapon);
+			if (LastQueuedHit.QueueTime >= HitConfirm.QueueTime)
+			{
+				HitConfirm.ShotTraceId = LastQueuedHit.ShotTraceId;
+				HitConfirm.QueueTime = LastQueuedHit.QueueTime;
+			}
+		}
+	}
+
+	return DamageTaken;
+}
+
+bool UDamageQueueSubsystem::CanMergeHits(const FQueuedHit& A, const FQueuedHit& B)
+{
+	if (A.Victim != B.Victim || A.InstigatedBy != B.InstigatedBy || A.DamageCauser != B.DamageCauser || A.DamageTypeClass != B.DamageTypeClass)
+	{
+		return false;
+	}
+
+	//Radial damage is scaled from its explosions origin, so it can't be merged with anything but the same explosion
+	return A.bRadial == B.bRadial && (!A.bRadial || A.Origin.Equals(B.Origin));
+}
@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "DamageQueueSubsystem.generated.h"
+
+class AController;
+class UDamageType;
+
+//A single hit that went into a victims resolved damage
+USTRUCT(BlueprintType)
+struct FResolvedHit
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintReadOnly, Category = "Damage")
+	AController* InstigatedBy = nullptr;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Damage")
+	AActor* DamageCauser = nullptr;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Damage")
+	FName BoneName;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Damage")
+	float Damage = 0.f;
+};
+
+//All the damage a victim took in a frame, applied as one damage event per attacker and damage type
+USTRUCT(BlueprintType)
+struct FResolvedDamage
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintReadOnly, Category = "Damage")
+	AActor* Victim = nullptr;
+
+	//The damage the victim actually took in total, after its own TakeDamage handling
+	UPROPERTY(BlueprintReadOnly, Category = "Damage")
+	float DamageTaken = 0.f;
+
+	//Every hit that was merged, in the order they happened
+	UPROPERTY(BlueprintReadOnly, Category = "Damage")
+	TArray<FResolvedHit> Hits;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnDamageResolved, const FResolvedDamage& /*ResolvedDamage*/);
+
+/**
+ * Server side queue for damage.  Hits are queued as they come in and resolved once a frame.  Hits on the same victim from the same
+ * instigator, causer and damage type are merged into one TakeDamage call, so every attacker keeps the credit and damage type of
+ * their own hits.  That gives one health change and one hit confirm per shooter, however many pellets or explosions landed.  The
+ * individual hits are kept, with their bones, for anything that needs to know who hit what.
+ */
+UCLASS()
+class SURVIVALGAME_API UDamageQueueSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	//FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+	/* [server] Queue damage for the victim.  It is applied, merged with any other damage the victim takes this frame, at the end of the frame.
+	ShotTraceId is the weapon shot that caused the damage, if any, for FWeaponLatencyTracer */
+	void QueueDamage(AActor* Victim, const float Damage, const FHitResult& Hit, const FVector& ShotDirection, AController* InstigatedBy, AActor* DamageCauser, TSubclassOf<UDamageType> DamageTypeClass, const uint16 ShotTraceId = 0);
+
+	/* [server] Queue explosion damage for the victim.  It is applied as a radial damage event, like UGameplayStatics::ApplyRadialDamage,
+	so BaseDamage is scaled by the victims distance from Origin when it is applied.  Hit is where the explosion reached the victim */
+	void QueueRadialDamage(AActor* Victim, const float BaseDamage, const FVector& Origin, const FRadialDamageParams& Params, const FHitResult& Hit, AController* InstigatedBy, AActor* DamageCauser, TSubclassOf<UDamageType> DamageTypeClass);
+
+	/* Broadcast for every victim once its damage for the frame has been applied */
+	FOnDamageResolved OnDamageResolved;
+
+protected:
+
+	struct FQueuedHit
+	{
+		TWeakObjectPtr<AActor> Victim;
+		float Damage = 0.f;
+		FHitResult Hit;
+		FVector ShotDirection = FVector::ZeroVector;
+		TWeakObjectPtr<AController> InstigatedBy;
+		TWeakObjectPtr<AActor> DamageCauser;
+		TSubclassOf<UDamageType> DamageTypeClass;
+		uint16 ShotTraceId = 0;
+		double QueueTime = 0.0;
+
+		//Radial hits are applied as a radial damage event from their explosions origin
+		bool bRadial = false;
+		FVector Origin = FVector::ZeroVector;
+		FRadialDamageParams RadialParams;
+	};
+
+	//The latest shot of a weapon that did damage, to confirm to its owner
+	struct FHitConfirm
+	{
+		uint16 ShotTraceId = 0;
+		double QueueTime = 0.0;
+	};
+
+	/* Apply the hits of one victim, from Hits[FirstHit] to Hits[LastHit], one damage event per group of hits that can be merged */
+	void ResolveVictim(const TArray<FQueuedHit>& Hits, const int32 FirstHit, const int32 LastHit);
+
+	/* Apply a group of hits on a victim that share an instigator, causer and damage type, as one damage event.  Returns the damage taken */
+	float ApplyMergedHits(AActor* Victim, const TArray<FQueuedHit>& Hits, const int32 FirstHit, const int32 LastHit);
+
+	/* Whether two hits on the same victim can be merged into one damage event */
+	static bool CanMergeHits(const FQueuedHit& A, const FQueuedHit& B);
+
+	TArray<FQueuedHit> QueuedHits;
+
+	//The weapons whose shots did damage this frame, so each shooter gets one hit confirm
+	TMap<TWeakObjectPtr<class AWeapon>, FHitConfirm> ConfirmedWeapons;
+};
@@ -1,17 +1,17 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/DamageType.h"
-#include "MeleeDamage.generated.h"
-
-/**
- * 
- */
-UCLASS()
-class SURVIVALGAME_API UMeleeDamage : public UDamageType
-{
-	GENERATED_BODY()
-	
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/DamageType.h"
+#include "MeleeDamage.generated.h"
+
+/**
+ * 
+ */
+UCLASS()
+class SURVIVALGAME_API UMeleeDamage : public UDamageType
+{
+	GENERATED_BODY()
+	
+};
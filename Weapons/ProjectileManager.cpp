@@ -0,0 +1,597 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ProjectileManager.h"
+#include "../SurvivalGame.h"
+#include "ThrowableWeapon.h"
+#include "ProjectileReplicator.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/Pawn.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "Math/VectorRegister.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile Manager Tick"), STAT_ProjectileManagerTick, STATGROUP_SurvivalGame);
+DECLARE_CYCLE_STAT(TEXT("Projectile Manager Sweeps"), STAT_ProjectileManagerSweeps, STATGROUP_SurvivalGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectile Manager Async Sweeps"), STAT_ProjectileManagerAsyncSweeps, STATGROUP_SurvivalGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles Simulated"), STAT_ProjectilesSimulated, STATGROUP_SurvivalGame);
+
+//Projectiles slower than this after bouncing off the floor come to rest
+static const float ProjectileRestSpeed = 20.f;
+
+//Late projectiles are caught up in steps no longer than this, so they still bounce off things on the way
+static const float ProjectileCatchUpStep = 1.f / 30.f;
+
+//How long clients keep drawing a projectile after its fuse runs out, so the servers detonation has time to arrive and replace it
+static const float ClientFuseGraceTime = 0.5f;
+
+void UProjectileManager::Deinitialize()
+{
+	Super::Deinitialize();
+
+	DEC_DWORD_STAT_BY(STAT_ProjectilesSimulated, NumProjectiles);
+
+	NumProjectiles = 0;
+	PendingSpawnEvents.Empty();
+	Replicator = nullptr;
+}
+
+void UProjectileManager::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileManagerTick);
+
+	//Hits from last frames sweeps are applied before the projectiles move on from where they were swept to
+	ReadSweeps();
+	ProcessPendingSpawnEvents();
+	UpdateFuses(DeltaTime);
+	IntegrateProjectiles(DeltaTime);
+	StartSweeps();
+	UpdateProjectileInstances();
+}
+
+bool UProjectileManager::IsTickable() const
+{
+	//Once the last projectile is gone we tick one more time to clear its instance
+	return !IsTemplate() && (NumProjectiles > 0 || PendingSpawnEvents.Num() > 0 || bProjectilesDrawn);
+}
+
+TStatId UProjectileManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectileManager, STATGROUP_Tickables);
+}
+
+UWorld* UProjectileManager::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+int32 UProjectileManager::SpawnProjectile(TSubclassOf<AThrowableWeapon> ThrowableClass, const FVector& Origin, const FVector& Velocity, AActor* Instigator, const uint16 PredictionKey)
+{
+	UWorld* World = GetWorld();
+
+	if (!ThrowableClass || !World || World->GetNetMode() == NM_Client)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 ClassIndex = FindOrAddClassInfo(ThrowableClass);
+	const int32 ProjectileId = NextProjectileId++;
+
+	AddProjectile(ProjectileId, ClassIndex, Origin, Velocity, ThrowableClass->GetDefaultObject<AThrowableWeapon>()->GetFuseTime(), Instigator);
+
+	FProjectileSpawnEvent SpawnEvent;
+	SpawnEvent.ProjectileId = ProjectileId;
+	SpawnEvent.ThrowableClass = ThrowableClass;
+	SpawnEvent.Origin = Origin;
+	SpawnEvent.Velocity = Velocity;
+	SpawnEvent.ServerSpawnTime = GetServerWorldTimeSeconds();
+	SpawnEvent.Instigator = Instigator;
+	SpawnEvent.PredictionKey = PredictionKey;
+
+	if (AProjectileReplicator* ProjectileReplicator = GetReplicator())
+	{
+		ProjectileReplicator->AddProjectile(SpawnEvent);
+	}
+
+	return ProjectileId;
+}
+
+void UProjectileManager::SpawnPredictedProjectile(TSubclassOf<AThrowableWeapon> ThrowableClass, const FVector& Origin, const FVector& Velocity, AActor* Instigator, const uint16 PredictionKey)
+{
+	if (!ThrowableClass || PredictionKey == 0)
+	{
+		return;
+	}
+
+	const int32 ClassIndex = FindOrAddClassInfo(ThrowableClass);
+
+	AddProjectile(GetPredictedProjectileId(PredictionKey), ClassIndex, Origin, Velocity, ThrowableClass->GetDefaultObject<AThrowableWeapon>()->GetFuseTime(), Instigator);
+}
+
+void UProjectileManager::OnSpawnEventReceived(const FProjectileSpawnEvent& SpawnEvent)
+{
+	if (!SpawnEvent.ThrowableClass)
+	{
+		return;
+	}
+
+	//Until the game state arrives we don't know the servers time, so we can't tell how far to catch the projectile up
+	if (!GetWorld()->GetGameState())
+	{
+		PendingSpawnEvents.Add(SpawnEvent);
+		return;
+	}
+
+	const float ServerTime = GetServerWorldTimeSeconds();
+
+	if (ReconcilePredictedProjectile(SpawnEvent, ServerTime))
+	{
+		return;
+	}
+
+	const int32 ClassIndex = FindOrAddClassInfo(SpawnEvent.ThrowableClass);
+	const int32 Index = AddProjectile(SpawnEvent.ProjectileId, ClassIndex, SpawnEvent.Origin, SpawnEvent.Velocity,
+		SpawnEvent.ThrowableClass->GetDefaultObject<AThrowableWeapon>()->GetFuseTime(), SpawnEvent.Instigator);
+
+	//The event took a while to get here, or we joined after the throw, move the projectile to where the server has it
+	CatchUpProjectile(Index, ServerTime - SpawnEvent.ServerSpawnTime);
+}
+
+void UProjectileManager::ProcessPendingSpawnEvents()
+{
+	if (!PendingSpawnEvents.Num() || !GetWorld()->GetGameState())
+	{
+		return;
+	}
+
+	const TArray<FProjectileSpawnEvent> SpawnEvents = MoveTemp(PendingSpawnEvents);
+
+	for (const FProjectileSpawnEvent& SpawnEvent : SpawnEvents)
+	{
+		OnSpawnEventReceived(SpawnEvent);
+	}
+}
+
+void UProjectileManager::RemoveProjectile(const int32 ProjectileId)
+{
+	if (ProjectileId == INDEX_NONE)
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < NumProjectiles; ++i)
+	{
+		if (ProjectileIds[i] == ProjectileId)
+		{
+			RemoveProjectileAt(i);
+			return;
+		}
+	}
+}
+
+bool UProjectileManager::ReconcilePredictedProjectile(const FProjectileSpawnEvent& SpawnEvent, const float ServerTime)
+{
+	if (SpawnEvent.PredictionKey == 0)
+	{
+		return false;
+	}
+
+	const APawn* InstigatorPawn = Cast<APawn>(SpawnEvent.Instigator);
+	if (!InstigatorPawn || !InstigatorPawn->IsLocallyControlled())
+	{
+		return false;
+	}
+
+	const int32 PredictedId = GetPredictedProjectileId(SpawnEvent.PredictionKey);
+
+	for (int32 i = 0; i < NumProjectiles; ++i)
+	{
+		if (ProjectileIds[i] == PredictedId)
+		{
+			//Keep simulating the projectile the player already sees, but under the servers id so its detonation removes it.
+			//Its fuse is synced to the servers, as that is when the detonation will actually happen
+			ProjectileIds[i] = SpawnEvent.ProjectileId;
+			FuseRemaining[i] = SpawnEvent.ThrowableClass->GetDefaultObject<AThrowableWeapon>()->GetFuseTime() - FMath::Max(ServerTime - SpawnEvent.ServerSpawnTime, 0.f);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UProjectileManager::SetReplicator(AProjectileReplicator* InReplicator)
+{
+	Replicator = InReplicator;
+}
+
+int32 UProjectileManager::AddProjectile(const int32 ProjectileId, const int32 ClassIndex, const FVector& Origin, const FVector& Velocity, const float FuseTime, AActor* Instigator)
+{
+	//Grow four at a time so the vectorized update never reads past the end
+	if (NumProjectiles == PositionX.Num())
+	{
+		PositionX.AddZeroed(4);
+		PositionY.AddZeroed(4);
+		PositionZ.AddZeroed(4);
+		VelocityX.AddZeroed(4);
+		VelocityY.AddZeroed(4);
+		VelocityZ.AddZeroed(4);
+		GravityZ.AddZeroed(4);
+		PreviousX.AddZeroed(4);
+		PreviousY.AddZeroed(4);
+		PreviousZ.AddZeroed(4);
+		FuseRemaining.AddZeroed(4);
+		ProjectileIds.AddZeroed(4);
+		ClassIndices.AddZeroed(4);
+		Instigators.AddDefaulted(4);
+		SweepHandles.AddDefaulted(4);
+	}
+
+	const int32 Index = NumProjectiles++;
+
+	PositionX[Index] = PreviousX[Index] = Origin.X;
+	PositionY[Index] = PreviousY[Index] = Origin.Y;
+	PositionZ[Index] = PreviousZ[Index] = Origin.Z;
+	VelocityX[Index] = Velocity.X;
+	VelocityY[Index] = Velocity.Y;
+	VelocityZ[Index] = Velocity.Z;
+	GravityZ[Index] = GetWorld()->GetGravityZ() * ClassInfos[ClassIndex].GravityScale;
+	FuseRemaining[Index] = FuseTime;
+	ProjectileIds[Index] = ProjectileId;
+	ClassIndices[Index] = ClassIndex;
+	Instigators[Index] = Instigator;
+	SweepHandles[Index] = FTraceHandle();
+
+	INC_DWORD_STAT(STAT_ProjectilesSimulated);
+
+	return Index;
+}
+
+void UProjectileManager::RemoveProjectileAt(const int32 Index)
+{
+	check(Index >= 0 && Index < NumProjectiles);
+
+	//Clients joining from now on shouldn't be sent it
+	if (Replicator && Replicator->HasAuthority())
+	{
+		Replicator->RemoveProjectile(ProjectileIds[Index]);
+	}
+
+	const int32 Last = --NumProjectiles;
+
+	if (Index != Last)
+	{
+		PositionX[Index] = PositionX[Last];
+		PositionY[Index] = PositionY[Last];
+		PositionZ[Index] = PositionZ[Last];
+		VelocityX[Index] = VelocityX[Last];
+		VelocityY[Index] = VelocityY[Last];
+		VelocityZ[Index] = VelocityZ[Last];
+		GravityZ[Index] = GravityZ[Last];
+		PreviousX[Index] = PreviousX[Last];
+		PreviousY[Index] = PreviousY[Last];
+		PreviousZ[Index] = PreviousZ[Last];
+		FuseRemaining[Index] = FuseRemaining[Last];
+		ProjectileIds[Index] = ProjectileIds[Last];
+		ClassIndices[Index] = ClassIndices[Last];
+		Instigators[Index] = Instigators[Last];
+		SweepHandles[Index] = SweepHandles[Last];
+	}
+
+	//Padding is kept zeroed so the vectorized update doesn't move it anywhere
+	PositionX[Last] = PositionY[Last] = PositionZ[Last] = 0.f;
+	VelocityX[Last] = VelocityY[Last] = VelocityZ[Last] = 0.f;
+	GravityZ[Last] = 0.f;
+	Instigators[Last] = nullptr;
+	SweepHandles[Last] = FTraceHandle();
+
+	DEC_DWORD_STAT(STAT_ProjectilesSimulated);
+}
+
+void UProjectileManager::IntegrateProjectiles(const float DeltaTime)
+{
+	const int32 NumPadded = Align(NumProjectiles, 4);
+
+	FMemory::Memcpy(PreviousX.GetData(), PositionX.GetData(), NumPadded * sizeof(float));
+	FMemory::Memcpy(PreviousY.GetData(), PositionY.GetData(), NumPadded * sizeof(float));
+	FMemory::Memcpy(PreviousZ.GetData(), PositionZ.GetData(), NumPadded * sizeof(float));
+
+	const VectorRegister VecDeltaTime = VectorSetFloat1(DeltaTime);
+
+	for (int32 i = 0; i < NumPadded; i += 4)
+	{
+		const VectorRegister VelZ = VectorMultiplyAdd(VectorLoad(&GravityZ[i]), VecDeltaTime, VectorLoad(&VelocityZ[i]));
+		VectorStore(VelZ, &VelocityZ[i]);
+
+		VectorStore(VectorMultiplyAdd(VectorLoad(&VelocityX[i]), VecDeltaTime, VectorLoad(&PositionX[i])), &PositionX[i]);
+		VectorStore(VectorMultiplyAdd(VectorLoad(&VelocityY[i]), VecDeltaTime, VectorLoad(&PositionY[i])), &PositionY[i]);
+		VectorStore(VectorMultiplyAdd(VelZ, VecDeltaTime, VectorLoad(&PositionZ[i])), &PositionZ[i]);
+	}
+}
+
+void UProjectileManager::StartSweeps()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileManagerSweeps);
+
+	UWorld* World = GetWorld();
+
+	for (int32 i = 0; i < NumProjectiles; ++i)
+	{
+		const FVector Start(PreviousX[i], PreviousY[i], PreviousZ[i]);
+		const FVector End(PositionX[i], PositionY[i], PositionZ[i]);
+
+		//Projectiles at rest don't need sweeping
+		if (Start.Equals(End, KINDA_SMALL_NUMBER))
+		{
+			continue;
+		}
+
+		const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ProjectileManagerSweep), false, Instigators[i].Get());
+		const FCollisionShape Shape = FCollisionShape::MakeSphere(ClassInfos[ClassIndices[i]].CollisionRadius);
+
+		SweepHandles[i] = World->AsyncSweepByChannel(EAsyncTraceType::Single, Start, End, FQuat::Identity, ECC_WorldDynamic, Shape, QueryParams);
+		INC_DWORD_STAT(STAT_ProjectileManagerAsyncSweeps);
+	}
+}
+
+void UProjectileManager::ReadSweeps()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileManagerSweeps);
+
+	UWorld* World = GetWorld();
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ProjectileManagerSweep), false);
+
+	for (int32 i = 0; i < NumProjectiles; ++i)
+	{
+		if (!SweepHandles[i].IsValid())
+		{
+			continue;
+		}
+
+		FTraceDatum SweepDatum;
+		if (World->QueryTraceData(SweepHandles[i], SweepDatum))
+		{
+			if (SweepDatum.OutHits.Num() && SweepDatum.OutHits[0].bBlockingHit)
+			{
+				ApplyProjectileHit(i, SweepDatum.OutHits[0]);
+			}
+		}
+		else
+		{
+			//The result was lost, sweep again rather than let the projectile pass through whatever it might have hit.  Nothing has
+			//moved the projectile since the sweep started, so it sweeps the same path
+			SweepProjectile(i, QueryParams);
+		}
+
+		SweepHandles[i] = FTraceHandle();
+	}
+}
+
+bool UProjectileManager::SweepProjectile(const int32 Index, FCollisionQueryParams& QueryParams)
+{
+	const FVector Start(PreviousX[Index], PreviousY[Index], PreviousZ[Index]);
+	const FVector End(PositionX[Index], PositionY[Index], PositionZ[Index]);
+
+	//Projectiles at rest don't need sweeping
+	if (Start.Equals(End, KINDA_SMALL_NUMBER))
+	{
+		return false;
+	}
+
+	const FProjectileClassInfo& ClassInfo = ClassInfos[ClassIndices[Index]];
+
+	QueryParams.ClearIgnoredActors();
+
+	if (AActor* Instigator = Instigators[Index].Get())
+	{
+		QueryParams.AddIgnoredActor(Instigator);
+	}
+
+	FHitResult Hit;
+	if (!GetWorld()->SweepSingleByChannel(Hit, Start, End, FQuat::Identity, ECC_WorldDynamic, FCollisionShape::MakeSphere(ClassInfo.CollisionRadius), QueryParams))
+	{
+		return false;
+	}
+
+	ApplyProjectileHit(Index, Hit);
+	return true;
+}
+
+void UProjectileManager::ApplyProjectileHit(const int32 Index, const FHitResult& Hit)
+{
+	const FProjectileClassInfo& ClassInfo = ClassInfos[ClassIndices[Index]];
+
+	//Pull back to where we hit, just off the surface
+	const FVector HitLocation = Hit.Location + Hit.ImpactNormal * KINDA_SMALL_NUMBER;
+	PositionX[Index] = HitLocation.X;
+	PositionY[Index] = HitLocation.Y;
+	PositionZ[Index] = HitLocation.Z;
+
+	FVector Velocity(VelocityX[Index], VelocityY[Index], VelocityZ[Index]);
+
+	if (ClassInfo.bShouldBounce)
+	{
+		//Reflect off the surface, losing speed into it based on how bouncy we are
+		Velocity -= (1.f + ClassInfo.Bounciness) * (Velocity | Hit.ImpactNormal) * Hit.ImpactNormal;
+	}
+
+	//Stop on the floor once we're barely moving, or straight away if we don't bounce
+	const bool bHitFloor = Hit.ImpactNormal.Z > 0.7f;
+	if (!ClassInfo.bShouldBounce || (bHitFloor && Velocity.SizeSquared() < FMath::Square(ProjectileRestSpeed)))
+	{
+		Velocity = FVector::ZeroVector;
+		GravityZ[Index] = 0.f;
+	}
+
+	VelocityX[Index] = Velocity.X;
+	VelocityY[Index] = Velocity.Y;
+	VelocityZ[Index] = Velocity.Z;
+}
+
+void UProjectileManager::CatchUpProjectile(const int32 Index, float CatchUpTime)
+{
+	if (CatchUpTime <= 0.f)
+	{
+		return;
+	}
+
+	FuseRemaining[Index] -= CatchUpTime;
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ProjectileManagerCatchUp), false);
+
+	while (CatchUpTime > 0.f)
+	{
+		const float StepTime = FMath::Min(CatchUpTime, ProjectileCatchUpStep);
+		CatchUpTime -= StepTime;
+
+		PreviousX[Index] = PositionX[Index];
+		PreviousY[Index] = PositionY[Index];
+		PreviousZ[Index] = PositionZ[Index];
+
+		VelocityZ[Index] += GravityZ[Index] * StepTime;
+		PositionX[Index] += VelocityX[Index] * StepTime;
+		PositionY[Index] += VelocityY[Index] * StepTime;
+		PositionZ[Index] += VelocityZ[Index] * StepTime;
+
+		SweepProjectile(Index, QueryParams);
+	}
+}
+
+void UProjectileManager::UpdateFuses(const float DeltaTime)
+{
+	const bool bIsServer = GetWorld()->GetNetMode() != NM_Client;
+	const float DetonateTime = bIsServer ? 0.f : -ClientFuseGraceTime;
+
+	//Go backwards, removing swaps an already updated projectile into this index
+	for (int32 i = NumProjectiles - 1; i >= 0; --i)
+	{
+		FuseRemaining[i] -= DeltaTime;
+
+		if (FuseRemaining[i] <= DetonateTime)
+		{
+			if (bIsServer)
+			{
+				DetonateProjectile(i);
+			}
+
+			RemoveProjectileAt(i);
+		}
+	}
+}
+
+void UProjectileManager::DetonateProjectile(const int32 Index)
+{
+	const FProjectileClassInfo& ClassInfo = ClassInfos[ClassIndices[Index]];
+	AActor* Instigator = Instigators[Index].Get();
+
+	const FVector Location(PositionX[Index], PositionY[Index], PositionZ[Index]);
+	const FVector Velocity(VelocityX[Index], VelocityY[Index], VelocityZ[Index]);
+	const FRotator Rotation = Velocity.IsNearlyZero() ? FRotator::ZeroRotator : Velocity.Rotation();
+
+	AThrowableWeapon* Throwable = GetWorld()->SpawnActorDeferred<AThrowableWeapon>(ClassInfo.ThrowableClass, FTransform(Rotation, Location), Instigator, Cast<APawn>(Instigator), ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+
+	if (Throwable)
+	{
+		Throwable->ProjectileId = ProjectileIds[Index];
+		MARK_PROPERTY_DIRTY_FROM_NAME(AThrowableWeapon, ProjectileId, Throwable);
+		Throwable->FinishSpawning(FTransform(Rotation, Location));
+		Throwable->Detonate();
+	}
+}
+
+void UProjectileManager::UpdateProjectileInstances()
+{
+	//Nothing to draw on a dedicated server
+	if (IsRunningDedicatedServer() || !Replicator)
+	{
+		return;
+	}
+
+	TArray<TArray<FTransform>, TInlineAllocator<4>> ClassTransforms;
+	ClassTransforms.SetNum(ClassInfos.Num());
+
+	for (int32 i = 0; i < NumProjectiles; ++i)
+	{
+		const FVector Velocity(VelocityX[i], VelocityY[i], VelocityZ[i]);
+		const FRotator Rotation = Velocity.IsNearlyZero() ? FRotator::ZeroRotator : Velocity.Rotation();
+		const int32 ClassIndex = ClassIndices[i];
+
+		ClassTransforms[ClassIndex].Emplace(Rotation, FVector(PositionX[i], PositionY[i], PositionZ[i]), ClassInfos[ClassIndex].MeshScale);
+	}
+
+	for (int32 ClassIndex = 0; ClassIndex < ClassInfos.Num(); ++ClassIndex)
+	{
+		Replicator->UpdateProjectileInstances(ClassIndex, ClassInfos[ClassIndex].Mesh, ClassTransforms[ClassIndex]);
+	}
+
+	bProjectilesDrawn = NumProjectiles > 0;
+}
+
+int32 UProjectileManager::FindOrAddClassInfo(TSubclassOf<AThrowableWeapon> ThrowableClass)
+{
+	const int32 ExistingIndex = ClassInfos.IndexOfByPredicate([ThrowableClass](const FProjectileClassInfo& ClassInfo)
+	{
+		return ClassInfo.ThrowableClass == ThrowableClass;
+	});
+
+	if (ExistingIndex != INDEX_NONE)
+	{
+		return ExistingIndex;
+	}
+
+	FProjectileClassInfo ClassInfo;
+	ClassInfo.ThrowableClass = ThrowableClass;
+
+	const AThrowableWeapon* ThrowableCDO = ThrowableClass->GetDefaultObject<AThrowableWeapon>();
+
+	if (const UProjectileMovementComponent* Movement = ThrowableCDO->GetThrowableMovement())
+	{
+		ClassInfo.GravityScale = Movement->ProjectileGravityScale;
+		ClassInfo.Bounciness = Movement->Bounciness;
+		ClassInfo.bShouldBounce = Movement->bShouldBounce;
+	}
+
+	if (const UStaticMeshComponent* MeshComponent = ThrowableCDO->GetThrowableMesh())
+	{
+		ClassInfo.Mesh = MeshComponent->GetStaticMesh();
+		ClassInfo.MeshScale = MeshComponent->GetRelativeScale3D();
+
+		if (ClassInfo.Mesh)
+		{
+			ClassInfo.CollisionRadius = ClassInfo.Mesh->GetBounds().SphereRadius * ClassInfo.MeshScale.GetMax();
+		}
+	}
+
+	return ClassInfos.Add(ClassInfo);
+}
+
+AProjectileReplicator* UProjectileManager::GetReplicator()
+{
+	UWorld* World = GetWorld();
+
+	//Only the server spawns the replicator, clients get theirs through replication
+	if (!Replicator && World && World->GetNetMode() != NM_Client)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		Replicator = World->SpawnActor<AProjectileReplicator>(SpawnParams);
+	}
+
+	return Replicator;
+}
+
+float UProjectileManager::GetServerWorldTimeSeconds() const
+{
+	UWorld* World = GetWorld();
+
+	if (const AGameStateBase* GameState = World ? World->GetGameState() : nullptr)
+	{
+		return GameState->GetServerWorldTimeSeconds();
+	}
+
+	return World ? World->GetTimeSeconds() : 0.f;
+}
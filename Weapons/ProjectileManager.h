@@ -0,0 +1,215 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "WorldCollision.h"
+#include "Engine/NetSerialization.h"
+#include "ProjectileManager.generated.h"
+
+class AThrowableWeapon;
+class AProjectileReplicator;
+struct FCollisionQueryParams;
+
+//Everything a client needs to simulate a thrown projectile locally.  Replicated once, instead of replicating the projectiles movement.
+USTRUCT()
+struct FProjectileSpawnEvent : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+public:
+
+	/* [client] Start simulating the projectile, caught up to where the server has it */
+	void PostReplicatedAdd(const struct FProjectileSpawnArray& InArraySerializer);
+
+	UPROPERTY()
+	int32 ProjectileId = INDEX_NONE;
+
+	UPROPERTY()
+	TSubclassOf<AThrowableWeapon> ThrowableClass;
+
+	UPROPERTY()
+	FVector_NetQuantize Origin;
+
+	UPROPERTY()
+	FVector_NetQuantize10 Velocity;
+
+	//The server world time the projectile was thrown at, so clients can catch up on the time it took to arrive
+	UPROPERTY()
+	float ServerSpawnTime = 0.f;
+
+	UPROPERTY()
+	AActor* Instigator = nullptr;
+
+	//If the instigator predicted this throw, the key it predicted it with.  0 if it wasn't predicted
+	UPROPERTY()
+	uint16 PredictionKey = 0;
+};
+
+//The spawn events of every projectile still in flight on the server.  Clients that join or become relevant mid flight get the whole array
+USTRUCT()
+struct FProjectileSpawnArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY()
+	TArray<FProjectileSpawnEvent> Items;
+
+	UPROPERTY(NotReplicated)
+	class AProjectileReplicator* Owner = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FProjectileSpawnEvent, FProjectileSpawnArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FProjectileSpawnArray> : public TStructOpsTypeTraitsBase2<FProjectileSpawnArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+ * Simulates every thrown projectile in the world in one batched update, instead of each one being an actor with its own
+ * projectile movement component.  Projectiles are stored as a struct of arrays so they can be integrated four at a time,
+ * and their collision sweeps all go out together as async sweeps, which are read back the next frame.  The server replicates
+ * the spawn event of every projectile in flight and clients simulate them locally.  A full AThrowableWeapon actor is only
+ * spawned (by the server) when a projectile detonates.
+ */
+UCLASS()
+class SURVIVALGAME_API UProjectileManager : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	//FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+	/* [server] Throw a projectile.  Returns the id of the new projectile */
+	int32 SpawnProjectile(TSubclassOf<AThrowableWeapon> ThrowableClass, const FVector& Origin, const FVector& Velocity, AActor* Instigator, const uint16 PredictionKey = 0);
+
+	/* [owning client] Start simulating a throw before the server has confirmed it.  The servers spawn event with the same
+	prediction key takes the projectile over, so only one is ever visible */
+	void SpawnPredictedProjectile(TSubclassOf<AThrowableWeapon> ThrowableClass, const FVector& Origin, const FVector& Velocity, AActor* Instigator, const uint16 PredictionKey);
+
+	/* Predicted projectiles use negative ids until the server assigns them a real one */
+	static FORCEINLINE int32 GetPredictedProjectileId(const uint16 PredictionKey) { return -static_cast<int32>(PredictionKey) - 1; }
+
+	/* [client] Start simulating a projectile the server has thrown */
+	void OnSpawnEventReceived(const FProjectileSpawnEvent& SpawnEvent);
+
+	/* Stop simulating a projectile */
+	void RemoveProjectile(const int32 ProjectileId);
+
+	/* [client] Set the replicator the server spawned for us */
+	void SetReplicator(AProjectileReplicator* InReplicator);
+
+	/* Get the replicator, spawning it on the server if it doesn't exist yet */
+	AProjectileReplicator* GetReplicator();
+
+	FORCEINLINE int32 GetNumProjectiles() const { return NumProjectiles; }
+
+protected:
+
+	//Per throwable class settings, read from the class defaults when the class is first thrown
+	struct FProjectileClassInfo
+	{
+		TSubclassOf<AThrowableWeapon> ThrowableClass;
+		class UStaticMesh* Mesh = nullptr;
+		FVector MeshScale = FVector::OneVector;
+		float GravityScale = 1.f;
+		float Bounciness = 0.6f;
+		float CollisionRadius = 5.f;
+		bool bShouldBounce = true;
+	};
+
+	/* Add a projectile to the simulation, returning its index */
+	int32 AddProjectile(const int32 ProjectileId, const int32 ClassIndex, const FVector& Origin, const FVector& Velocity, const float FuseTime, AActor* Instigator);
+
+	/* Remove the projectile at the given index, swapping the last projectile into its place */
+	void RemoveProjectileAt(const int32 Index);
+
+	/* Integrate every projectile, four at a time */
+	void IntegrateProjectiles(const float DeltaTime);
+
+	/* Start an async sweep for every moving projectile, from where it was to where it is now */
+	void StartSweeps();
+
+	/* Read back last frames sweeps, bouncing projectiles off anything they hit */
+	void ReadSweeps();
+
+	/* Sweep a single projectile straight away, returns true if it hit something */
+	bool SweepProjectile(const int32 Index, FCollisionQueryParams& QueryParams);
+
+	/* Move a projectile back to where its sweep hit, and bounce or stop it */
+	void ApplyProjectileHit(const int32 Index, const FHitResult& Hit);
+
+	/* Move a single projectile forward in time, used to catch up projectiles that arrived late on clients */
+	void CatchUpProjectile(const int32 Index, float CatchUpTime);
+
+	/* Count down fuses, detonating (server) or removing (client) projectiles whose fuse has run out */
+	void UpdateFuses(const float DeltaTime);
+
+	/* [server] Spawn the real throwable actor where a projectile ran out of fuse and detonate it */
+	void DetonateProjectile(const int32 Index);
+
+	/* Push projectile transforms to the instanced meshes that draw them */
+	void UpdateProjectileInstances();
+
+	/* [client] Start simulating the projectiles that arrived before we knew the servers time */
+	void ProcessPendingSpawnEvents();
+
+	int32 FindOrAddClassInfo(TSubclassOf<AThrowableWeapon> ThrowableClass);
+
+	/* [owning client] Hand a predicted projectile over to the server's spawn event.  Returns false if we didn't predict it */
+	bool ReconcilePredictedProjectile(const FProjectileSpawnEvent& SpawnEvent, const float ServerTime);
+
+	float GetServerWorldTimeSeconds() const;
+
+	TArray<FProjectileClassInfo> ClassInfos;
+
+	//Projectile state, struct of arrays.  Always padded to a multiple of 4 so they can be processed with vector instructions.
+	TArray<float> PositionX;
+	TArray<float> PositionY;
+	TArray<float> PositionZ;
+	TArray<float> VelocityX;
+	TArray<float> VelocityY;
+	TArray<float> VelocityZ;
+	TArray<float> GravityZ;
+	TArray<float> PreviousX;
+	TArray<float> PreviousY;
+	TArray<float> PreviousZ;
+	TArray<float> FuseRemaining;
+	TArray<int32> ProjectileIds;
+	TArray<int32> ClassIndices;
+	TArray<TWeakObjectPtr<AActor>> Instigators;
+	TArray<FTraceHandle> SweepHandles;
+
+	//The number of live projectiles. The arrays above may be longer because of padding
+	int32 NumProjectiles = 0;
+
+	int32 NextProjectileId = 0;
+
+	//Whether the instanced meshes are showing any projectiles, so they get cleared once the last one is gone
+	bool bProjectilesDrawn = false;
+
+	//[client] Spawn events waiting for the game state, without which we can't tell how far to catch them up
+	TArray<FProjectileSpawnEvent> PendingSpawnEvents;
+
+	UPROPERTY(Transient)
+	AProjectileReplicator* Replicator;
+};
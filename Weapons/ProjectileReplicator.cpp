@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ProjectileReplicator.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+AProjectileReplicator::AProjectileReplicator()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	SetReplicates(true);
+	bAlwaysRelevant = true;
+
+	//Info actors are hidden by default, which would hide the projectile instances too
+	SetActorHiddenInGame(false);
+
+	Projectiles.Owner = this;
+}
+
+void AProjectileReplicator::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(AProjectileReplicator, Projectiles, Params);
+}
+
+void AProjectileReplicator::BeginPlay()
+{
+	Super::BeginPlay();
+
+	//Make sure clients know which replicator to use, as the projectile manager only spawns one on the server
+	if (!HasAuthority())
+	{
+		if (UProjectileManager* ProjectileManager = GetWorld()->GetSubsystem<UProjectileManager>())
+		{
+			ProjectileManager->SetReplicator(this);
+		}
+	}
+}
+
+void AProjectileReplicator::AddProjectile(const FProjectileSpawnEvent& SpawnEvent)
+{
+	Projectiles.MarkItemDirty(Projectiles.Items.Add_GetRef(SpawnEvent));
+	MARK_PROPERTY_DIRTY_FROM_NAME(AProjectileReplicator, Projectiles, this);
+}
+
+void AProjectileReplicator::RemoveProjectile(const int32 ProjectileId)
+{
+	const int32 Index = Projectiles.Items.IndexOfByPredicate([ProjectileId](const FProjectileSpawnEvent& SpawnEvent) { return SpawnEvent.ProjectileId == ProjectileId; });
+
+	if (Index != INDEX_NONE)
+	{
+		Projectiles.Items.RemoveAtSwap(Index);
+		Projectiles.MarkArrayDirty();
+		MARK_PROPERTY_DIRTY_FROM_NAME(AProjectileReplicator, Projectiles, this);
+	}
+}
+
+void FProjectileSpawnEvent::PostReplicatedAdd(const FProjectileSpawnArray& InArraySerializer)
+{
+	UWorld* World = InArraySerializer.Owner ? InArraySerializer.Owner->GetWorld() : nullptr;
+
+	if (UProjectileManager* ProjectileManager = World ? World->GetSubsystem<UProjectileManager>() : nullptr)
+	{
+		ProjectileManager->OnSpawnEventReceived(*this);
+	}
+}
+
+void AProjectileReplicator::UpdateProjectileInstances(const int32 ClassIndex, class UStaticMesh* Mesh, const TArray<FTransform>& Transforms)
+{
+	if (!ProjectileInstances.IsValidIndex(ClassIndex))
+	{
+		ProjectileInstances.SetNumZeroed(ClassIndex + 1);
+	}
+
+	UInstancedStaticMeshComponent*& Instances = ProjectileInstances[ClassIndex];
+
+	if (!Instances)
+	{
+		//Don't bother creating a component until there is something to draw
+		if (!Mesh || !Transforms.Num())
+		{
+			return;
+		}
+
+		Instances = NewObject<UInstancedStaticMeshComponent>(this);
+		Instances->SetStaticMesh(Mesh);
+		Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		Instances->SetCastShadow(true);
+		Instances->SetMobility(EComponentMobility::Movable);
+		Instances->RegisterComponent();
+	}
+
+	if (Instances->GetInstanceCount() != Transforms.Num())
+	{
+		Instances->ClearInstances();
+
+		for (const FTransform& InstanceTransform : Transforms)
+		{
+			Instances->AddInstanceWorldSpace(InstanceTransform);
+		}
+	}
+	else if (Transforms.Num())
+	{
+		Instances->BatchUpdateInstancesTransforms(0, Transforms, true, true, true);
+	}
+}
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "ProjectileManager.h"
+#include "ProjectileReplicator.generated.h"
+
+/**
+ * Spawned by the server's projectile manager to replicate the spawn events of projectiles in flight to clients, and used on
+ * every machine that renders projectiles to hold the instanced meshes they are drawn with.
+ */
+UCLASS(NotPlaceable, Transient)
+class SURVIVALGAME_API AProjectileReplicator : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	AProjectileReplicator();
+
+	virtual void GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/* [server] Replicate a projectile to clients until it is removed */
+	void AddProjectile(const FProjectileSpawnEvent& SpawnEvent);
+
+	/* [server] Stop replicating a projectile.  Clients stop simulating it when its detonation arrives or its fuse runs out */
+	void RemoveProjectile(const int32 ProjectileId);
+
+	/* Update the instances drawing the projectiles of a class.  Transforms are in world space */
+	void UpdateProjectileInstances(const int32 ClassIndex, class UStaticMesh* Mesh, const TArray<FTransform>& Transforms);
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	//The projectiles in flight
+	UPROPERTY(Replicated)
+	FProjectileSpawnArray Projectiles;
+
+	//An instanced mesh per throwable class, indexed the same as the projectile managers class infos
+	UPROPERTY(Transient)
+	TArray<class UInstancedStaticMeshComponent*> ProjectileInstances;
+
+};
@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RPCRateLimiter.h"
+#include "../SurvivalGame.h"
+#include "Engine/NetConnection.h"
+#include "Engine/World.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("RPC Limiter Allowed"), STAT_RPCLimiterAllowed, STATGROUP_SurvivalGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RPC Limiter Dropped"), STAT_RPCLimiterDropped, STATGROUP_SurvivalGame);
+
+static TAutoConsoleVariable<int32> CVarRPCLimiterEnabled(
+	TEXT("Weapon.RPCLimiter.Enabled"),
+	1,
+	TEXT("If enabled, weapon server RPCs sent faster than the weapon allows are dropped."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarRPCLimiterTolerance(
+	TEXT("Weapon.RPCLimiter.Tolerance"),
+	1.25f,
+	TEXT("Multiplier on the legitimate RPC rate, to allow for timing differences between client and server."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarRPCLimiterBurst(
+	TEXT("Weapon.RPCLimiter.Burst"),
+	4.f,
+	TEXT("How many RPCs can arrive at once, to allow for packets that were held up and arrive together."),
+	ECVF_Default);
+
+static void DumpRPCLimiterStats(UWorld* World)
+{
+	if (World)
+	{
+		if (URPCRateLimiter* RPCLimiter = World->GetSubsystem<URPCRateLimiter>())
+		{
+			RPCLimiter->DumpStats();
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorld DumpRPCLimiterStatsCommand(
+	TEXT("Weapon.RPCLimiter.DumpStats"),
+	TEXT("Logs the allowed and dropped weapon RPCs of every connection."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&DumpRPCLimiterStats));
+
+bool URPCRateLimiter::ConsumeToken(const AActor* RPCActor, const ERateLimitedRPC RPC, const float CallsPerSecond)
+{
+	UNetConnection* Connection = RPCActor ? RPCActor->GetNetConnection() : nullptr;
+
+	//Local players and AI don't send RPCs over the network
+	if (!Connection || CVarRPCLimiterEnabled.GetValueOnGameThread() == 0)
+	{
+		return true;
+	}
+
+	FConnectionBuckets* Buckets = ConnectionBuckets.Find(Connection);
+
+	if (!Buckets)
+	{
+		//Forget about connections that have gone before adding a new one
+		for (auto It = ConnectionBuckets.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		Buckets = &ConnectionBuckets.Add(Connection);
+	}
+
+	if (!ConsumeBucketToken(Buckets->Buckets[(uint8)RPC], GetWorld()->GetTimeSeconds(), CallsPerSecond))
+	{
+		INC_DWORD_STAT(STAT_RPCLimiterDropped);
+		return false;
+	}
+
+	INC_DWORD_STAT(STAT_RPCLimiterAllowed);
+	return true;
+}
+
+bool URPCRateLimiter::ConsumeBucketToken(FRPCBucket& Bucket, const float Now, const float CallsPerSecond)
+{
+	const float BurstSize = FMath::Max(CVarRPCLimiterBurst.GetValueOnGameThread(), 1.f);
+
+	if (!Bucket.bInitialized)
+	{
+		Bucket.Tokens = BurstSize;
+		Bucket.LastRefillTime = Now;
+		Bucket.bInitialized = true;
+	}
+
+	const float RefillRate = FMath::Max(CallsPerSecond, 0.f) * CVarRPCLimiterTolerance.GetValueOnGameThread();
+	Bucket.Tokens = FMath::Min(Bucket.Tokens + (Now - Bucket.LastRefillTime) * RefillRate, BurstSize);
+	Bucket.LastRefillTime = Now;
+
+	if (Bucket.Tokens < 1.f)
+	{
+		++Bucket.Dropped;
+		return false;
+	}
+
+	Bucket.Tokens -= 1.f;
+	++Bucket.Allowed;
+	return true;
+}
+
+void URPCRateLimiter::DumpStats() const
+{
+	const UEnum* RPCEnum = StaticEnum<ERateLimitedRPC>();
+
+	for (const auto& Pair : ConnectionBuckets)
+	{
+		const UNetConnection* Connection = Pair.Key.Get();
+
+		if (!Connection)
+		{
+			continue;
+		}
+
+		for (uint8 i = 0; i < (uint8)ERateLimitedRPC::RLR_MAX; ++i)
+		{
+			const FRPCBucket& Bucket = Pair.Value.Buckets[i];
+
+			if (Bucket.bInitialized)
+			{
+				UE_LOG(LogTemp, Log, TEXT("RPC limiter: %s %s allowed %d dropped %d"), *Connection->LowLevelGetRemoteAddress(true), *RPCEnum->GetNameStringByIndex(i), Bucket.Allowed, Bucket.Dropped);
+			}
+		}
+	}
+}
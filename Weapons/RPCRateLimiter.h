@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "RPCRateLimiter.generated.h"
+
+class UNetConnection;
+
+//The server RPCs that are rate limited.  Each gets its own bucket per connection
+UENUM()
+enum class ERateLimitedRPC : uint8
+{
+	RLR_StartFire,
+	RLR_HandleFiring,
+	RLR_HandleHit,
+	RLR_StartReload,
+	RLR_MAX UMETA(Hidden)
+};
+
+/**
+ * Token bucket rate limiting for the weapon server RPCs, per client connection.  Each RPC refills its bucket at the rate the
+ * weapon can legitimately send it (derived from its time between shots) with some tolerance for network jitter.  Calls with an
+ * empty bucket are dropped before the RPC does any work, and counted so abuse shows up in the stats and Weapon.RPCLimiter.DumpStats.
+ */
+UCLASS()
+class SURVIVALGAME_API URPCRateLimiter : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	/* [server] Take a token for an RPC sent by the connection owning RPCActor.  Returns false if the RPC is over its rate and should be dropped.
+	@param CallsPerSecond the rate the RPC can legitimately be sent at */
+	bool ConsumeToken(const AActor* RPCActor, const ERateLimitedRPC RPC, const float CallsPerSecond);
+
+	/* Log every connections allowed and dropped calls */
+	void DumpStats() const;
+
+	struct FRPCBucket
+	{
+		float Tokens = 0.f;
+		float LastRefillTime = 0.f;
+		bool bInitialized = false;
+
+		int32 Allowed = 0;
+		int32 Dropped = 0;
+	};
+
+	/* Refill a bucket up to Now and take a token from it.  Returns false if it was empty and the call should be dropped */
+	static bool ConsumeBucketToken(FRPCBucket& Bucket, const float Now, const float CallsPerSecond);
+
+protected:
+
+	struct FConnectionBuckets
+	{
+		FRPCBucket Buckets[(uint8)ERateLimitedRPC::RLR_MAX];
+	};
+
+	TMap<TWeakObjectPtr<UNetConnection>, FConnectionBuckets> ConnectionBuckets;
+};
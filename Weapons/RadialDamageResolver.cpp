@@ -0,0 +1,233 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RadialDamageResolver.h"
+#include "../SurvivalGame.h"
+#include "../Player/SurvivalCharacter.h"
+#include "../Items/GearItem.h"
+#include "DamageQueueSubsystem.h"
+#include "GameFramework/DamageType.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Radial Damage Start"), STAT_RadialDamageStart, STATGROUP_SurvivalGame);
+DECLARE_CYCLE_STAT(TEXT("Radial Damage Resolve"), STAT_RadialDamageResolve, STATGROUP_SurvivalGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Radial Damage Traces"), STAT_RadialDamageTraces, STATGROUP_SurvivalGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Radial Damage Cached Traces"), STAT_RadialDamageCachedTraces, STATGROUP_SurvivalGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Radial Damage Retraces"), STAT_RadialDamageRetraces, STATGROUP_SurvivalGame);
+
+static TAutoConsoleVariable<float> CVarRadialDamageOcclusionCellSize(
+	TEXT("Weapon.RadialDamage.OcclusionCellSize"),
+	50.f,
+	TEXT("Explosions this close together in the same frame share their line of sight traces."),
+	ECVF_Default);
+
+void URadialDamageResolver::Deinitialize()
+{
+	Super::Deinitialize();
+
+	PendingExplosions.Empty();
+	InFlightExplosions.Empty();
+	InFlightVictims.Empty();
+	InFlightTraces.Empty();
+	OcclusionCache.Empty();
+}
+
+void URadialDamageResolver::Tick(float DeltaTime)
+{
+	//Resolve last frames explosions first, so this frames ones can reuse the arrays
+	ResolveInFlightExplosions();
+	StartPendingExplosions();
+}
+
+bool URadialDamageResolver::IsTickable() const
+{
+	return !IsTemplate() && (PendingExplosions.Num() > 0 || InFlightExplosions.Num() > 0);
+}
+
+TStatId URadialDamageResolver::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(URadialDamageResolver, STATGROUP_Tickables);
+}
+
+UWorld* URadialDamageResolver::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+void URadialDamageResolver::QueueExplosion(const FRadialDamageExplosion& Explosion)
+{
+	if (Explosion.Params.OuterRadius > 0.f && Explosion.Params.BaseDamage > 0.f)
+	{
+		PendingExplosions.Add(Explosion);
+	}
+}
+
+void URadialDamageResolver::StartPendingExplosions()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RadialDamageStart);
+
+	if (PendingExplosions.Num() == 0)
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+
+	InFlightExplosions = MoveTemp(PendingExplosions);
+	PendingExplosions.Reset();
+
+	const float CellSize = FMath::Max(CVarRadialDamageOcclusionCellSize.GetValueOnGameThread(), 1.f);
+
+	TArray<FOverlapResult> Overlaps;
+
+	for (int32 ExplosionIndex = 0; ExplosionIndex < InFlightExplosions.Num(); ++ExplosionIndex)
+	{
+		const FRadialDamageExplosion& Explosion = InFlightExplosions[ExplosionIndex];
+		const FIntVector EpicenterCell(Explosion.Epicenter / CellSize);
+
+		//One overlap per explosion to find everyone in range
+		Overlaps.Reset();
+		FCollisionQueryParams OverlapParams(SCENE_QUERY_STAT(RadialDamageOverlap), false);
+		World->OverlapMultiByObjectType(Overlaps, Explosion.Epicenter, FQuat::Identity, FCollisionObjectQueryParams(ECC_Pawn), FCollisionShape::MakeSphere(Explosion.Params.OuterRadius), OverlapParams);
+
+		const int32 FirstVictim = InFlightVictims.Num();
+
+		for (const FOverlapResult& Overlap : Overlaps)
+		{
+			ASurvivalCharacter* Character = Cast<ASurvivalCharacter>(Overlap.GetActor());
+
+			if (!Character)
+			{
+				continue;
+			}
+
+			//A character overlaps once per component, only count it once per explosion
+			bool bAlreadyAdded = false;
+			for (int32 i = FirstVictim; i < InFlightVictims.Num(); ++i)
+			{
+				if (InFlightVictims[i].Character == Character)
+				{
+					bAlreadyAdded = true;
+					break;
+				}
+			}
+
+			if (bAlreadyAdded)
+			{
+				continue;
+			}
+
+			const FVector VictimLocation = Character->GetActorLocation();
+
+			FRadialDamageVictim& Victim = InFlightVictims.AddDefaulted_GetRef();
+			Victim.ExplosionIndex = ExplosionIndex;
+			Victim.Character = Character;
+			Victim.Distance = FVector::Dist(Explosion.Epicenter, VictimLocation);
+
+			//Explosions in the same cell this frame can see the same victims, share the trace
+			const TPair<FIntVector, const AActor*> CacheKey(EpicenterCell, Character);
+
+			if (const int32* CachedTraceIndex = OcclusionCache.Find(CacheKey))
+			{
+				Victim.TraceIndex = *CachedTraceIndex;
+				INC_DWORD_STAT(STAT_RadialDamageCachedTraces);
+				continue;
+			}
+
+			FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(RadialDamageOcclusion), false);
+			TraceParams.AddIgnoredActor(Character);
+
+			if (AActor* DamageCauser = Explosion.DamageCauser.Get())
+			{
+				TraceParams.AddIgnoredActor(DamageCauser);
+			}
+
+			Victim.TraceIndex = InFlightTraces.Add(World->AsyncLineTraceByChannel(EAsyncTraceType::Test, Explosion.Epicenter, VictimLocation, ECC_Visibility, TraceParams));
+			OcclusionCache.Add(CacheKey, Victim.TraceIndex);
+
+			INC_DWORD_STAT(STAT_RadialDamageTraces);
+		}
+	}
+
+	//The cache is only good for explosions started in the same frame
+	OcclusionCache.Reset();
+}
+
+void URadialDamageResolver::ResolveInFlightExplosions()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RadialDamageResolve);
+
+	if (InFlightExplosions.Num() == 0)
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	UDamageQueueSubsystem* DamageQueue = World->GetSubsystem<UDamageQueueSubsystem>();
+
+	//Read every trace back first.  A trace whose result didn't come back is retraced below rather than treated as clear
+	TArray<ETraceResult, TInlineAllocator<32>> TraceResults;
+	TraceResults.Init(ETraceResult::Missing, InFlightTraces.Num());
+
+	for (int32 i = 0; i < InFlightTraces.Num(); ++i)
+	{
+		FTraceDatum TraceDatum;
+		if (World->QueryTraceData(InFlightTraces[i], TraceDatum))
+		{
+			TraceResults[i] = FHitResult::GetFirstBlockingHit(TraceDatum.OutHits) ? ETraceResult::Blocked : ETraceResult::Clear;
+		}
+	}
+
+	//Then one pass to work out and apply the damage
+	for (const FRadialDamageVictim& Victim : InFlightVictims)
+	{
+		ASurvivalCharacter* Character = Victim.Character.Get();
+
+		if (!Character)
+		{
+			continue;
+		}
+
+		const FRadialDamageExplosion& Explosion = InFlightExplosions[Victim.ExplosionIndex];
+
+		if (TraceResults[Victim.TraceIndex] == ETraceResult::Missing)
+		{
+			FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(RadialDamageOcclusionRetrace), false);
+			TraceParams.AddIgnoredActor(Character);
+
+			if (AActor* DamageCauser = Explosion.DamageCauser.Get())
+			{
+				TraceParams.AddIgnoredActor(DamageCauser);
+			}
+
+			const bool bBlocked = World->LineTraceTestByChannel(Explosion.Epicenter, Character->GetActorLocation(), ECC_Visibility, TraceParams);
+			TraceResults[Victim.TraceIndex] = bBlocked ? ETraceResult::Blocked : ETraceResult::Clear;
+
+			INC_DWORD_STAT(STAT_RadialDamageRetraces);
+		}
+
+		if (TraceResults[Victim.TraceIndex] == ETraceResult::Blocked)
+		{
+			continue;
+		}
+
+		//Checked here to skip victims out of range, the victim applies the falloff itself when it takes the damage
+		if (Explosion.Params.GetDamageScale(Victim.Distance) <= 0.f && Explosion.Params.MinimumDamage <= 0.f)
+		{
+			continue;
+		}
+
+		const float BaseDamage = Explosion.Params.BaseDamage * (1.f - UGearItem::GetTotalDamageDefence(Character));
+
+		const FVector HitDirection = (Character->GetActorLocation() - Explosion.Epicenter).GetSafeNormal();
+
+		const FHitResult Hit(Character, Character->GetCapsuleComponent(), Character->GetActorLocation(), -HitDirection);
+
+		DamageQueue->QueueRadialDamage(Character, BaseDamage, Explosion.Epicenter, Explosion.Params, Hit, Explosion.InstigatedBy.Get(), Explosion.DamageCauser.Get(), Explosion.DamageTypeClass);
+	}
+
+	InFlightExplosions.Reset();
+	InFlightVictims.Reset();
+	InFlightTraces.Reset();
+}
@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Engine/EngineTypes.h"
+#include "WorldCollision.h"
+#include "RadialDamageResolver.generated.h"
+
+class AController;
+class UDamageType;
+
+//An explosion waiting to have its damage resolved
+USTRUCT()
+struct FRadialDamageExplosion
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY()
+	FVector Epicenter = FVector::ZeroVector;
+
+	UPROPERTY()
+	FRadialDamageParams Params;
+
+	UPROPERTY()
+	TSubclassOf<UDamageType> DamageTypeClass;
+
+	UPROPERTY()
+	TWeakObjectPtr<AController> InstigatedBy;
+
+	UPROPERTY()
+	TWeakObjectPtr<AActor> DamageCauser;
+};
+
+/**
+ * Resolves explosion damage on the server in batches.  Each explosion does one overlap to find the characters in range, then the line
+ * of sight checks for every explosion this frame go out as async traces.  Explosions in the same place this frame share their line of
+ * sight results.  The next frame the results are read back and gear defence is applied in one pass over the victims, which take
+ * the damage as a radial damage event and apply the falloff themselves, as they would from UGameplayStatics::ApplyRadialDamage.
+ */
+UCLASS()
+class SURVIVALGAME_API URadialDamageResolver : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Deinitialize() override;
+
+	//FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+	/* [server] Queue an explosion.  Its damage is applied a frame later, once its line of sight traces come back */
+	void QueueExplosion(const FRadialDamageExplosion& Explosion);
+
+protected:
+
+	//A character caught in an explosion, and the trace that decides whether the explosion can see it
+	struct FRadialDamageVictim
+	{
+		int32 ExplosionIndex = INDEX_NONE;
+		TWeakObjectPtr<class ASurvivalCharacter> Character;
+		int32 TraceIndex = INDEX_NONE;
+		float Distance = 0.f;
+	};
+
+	enum class ETraceResult : uint8
+	{
+		//The async trace result didn't come back, so it has to be traced again
+		Missing,
+		Clear,
+		Blocked
+	};
+
+	/* Find the victims of the queued explosions, and start their line of sight traces */
+	void StartPendingExplosions();
+
+	/* Read back the line of sight traces and damage every victim that could be seen */
+	void ResolveInFlightExplosions();
+
+	TArray<FRadialDamageExplosion> PendingExplosions;
+
+	//Explosions whose traces were started last frame
+	TArray<FRadialDamageExplosion> InFlightExplosions;
+	TArray<FRadialDamageVictim> InFlightVictims;
+	TArray<FTraceHandle> InFlightTraces;
+
+	//Occlusion traces started this frame, keyed by the explosions grid cell and the victim, so nearby explosions can share them
+	TMap<TPair<FIntVector, const AActor*>, int32> OcclusionCache;
+};
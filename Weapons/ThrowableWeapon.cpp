@@ -1,20 +1,88 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "ThrowableWeapon.h"
-#include <GameFramework/ProjectileMovementComponent.h>
-#include <Components/StaticMeshComponent.h>
-
-// Sets default values
-AThrowableWeapon::AThrowableWeapon()
-{
-    ThrowableMesh = CreateDefaultSubobject<UStaticMeshComponent>("ThrowableMesh");
-    SetRootComponent(ThrowableMesh);
-
-    ThrowableMovement = CreateDefaultSubobject<UProjectileMovementComponent>("ThrowableMovement");
-    ThrowableMovement->InitialSpeed = 1000.0f;
-
-    SetReplicates(true);
-    SetReplicatingMovement(true);
-}
-
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ThrowableWeapon.h"
+#include <GameFramework/ProjectileMovementComponent.h>
+#include <Components/StaticMeshComponent.h>
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "ProjectileManager.h"
+#include "RadialDamageResolver.h"
+
+// Sets default values
+AThrowableWeapon::AThrowableWeapon()
+{
+    ThrowableMesh = CreateDefaultSubobject<UStaticMeshComponent>("ThrowableMesh");
+    SetRootComponent(ThrowableMesh);
+
+    ThrowableMovement = CreateDefaultSubobject<UProjectileMovementComponent>("ThrowableMovement");
+    ThrowableMovement->InitialSpeed = 1000.0f;
+
+    FuseTime = 3.f;
+    DetonatedLifeSpan = 5.f;
+    ProjectileId = INDEX_NONE;
+    bDetonated = false;
+
+    //Throwables are simulated by the projectile manager while in flight and only spawned where they detonate,
+    //so the spawn location is all the movement clients need
+    SetReplicates(true);
+    SetReplicatingMovement(false);
+}
+
+void AThrowableWeapon::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    FDoRepLifetimeParams Params;
+    Params.bIsPushBased = true;
+
+    DOREPLIFETIME_WITH_PARAMS_FAST(AThrowableWeapon, bDetonated, Params);
+
+    Params.Condition = COND_InitialOnly;
+    DOREPLIFETIME_WITH_PARAMS_FAST(AThrowableWeapon, ProjectileId, Params);
+}
+
+void AThrowableWeapon::Detonate()
+{
+    if (HasAuthority() && !bDetonated)
+    {
+        bDetonated = true;
+        MARK_PROPERTY_DIRTY_FROM_NAME(AThrowableWeapon, bDetonated, this);
+
+        OnRep_Detonated();
+        SetLifeSpan(DetonatedLifeSpan);
+
+        if (ExplosionDamage.BaseDamage > 0.f)
+        {
+            if (URadialDamageResolver* RadialDamageResolver = GetWorld()->GetSubsystem<URadialDamageResolver>())
+            {
+                FRadialDamageExplosion Explosion;
+                Explosion.Epicenter = GetActorLocation();
+                Explosion.Params = ExplosionDamage;
+                Explosion.DamageTypeClass = ExplosionDamageType;
+                Explosion.InstigatedBy = GetInstigatorController();
+                Explosion.DamageCauser = this;
+
+                RadialDamageResolver->QueueExplosion(Explosion);
+            }
+        }
+    }
+}
+
+void AThrowableWeapon::OnRep_Detonated()
+{
+    if (bDetonated)
+    {
+        //A detonated throwable doesn't move anymore
+        ThrowableMovement->StopMovementImmediately();
+        ThrowableMovement->Deactivate();
+
+        //The detonation takes over from our simulated copy of the projectile
+        if (UProjectileManager* ProjectileManager = GetWorld()->GetSubsystem<UProjectileManager>())
+        {
+            ProjectileManager->RemoveProjectile(ProjectileId);
+        }
+
+        OnDetonate();
+    }
+}
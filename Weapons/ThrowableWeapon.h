@@ -1,25 +1,63 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/Actor.h"
-#include "ThrowableWeapon.generated.h"
-
-UCLASS()
-class SURVIVALGAME_API AThrowableWeapon : public AActor
-{
-	GENERATED_BODY()
-	
-public:	
-	// Sets default values for this actor's properties
-	AThrowableWeapon();
-
-protected:
-	UPROPERTY(EditDefaultsOnly, Category = "Components")
-	class UStaticMeshComponent* ThrowableMesh;
-
-	UPROPERTY(EditDefaultsOnly, Category = "Components")
-	class UProjectileMovementComponent* ThrowableMovement;
-
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "ThrowableWeapon.generated.h"
+
+UCLASS()
+class SURVIVALGAME_API AThrowableWeapon : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this actor's properties
+	AThrowableWeapon();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/* [server] Blow up.  Thrown projectiles are simulated by the projectile manager, which spawns this actor where the fuse runs out and detonates it */
+	virtual void Detonate();
+
+	FORCEINLINE class UStaticMeshComponent* GetThrowableMesh() const { return ThrowableMesh; }
+	FORCEINLINE class UProjectileMovementComponent* GetThrowableMovement() const { return ThrowableMovement; }
+	FORCEINLINE float GetFuseTime() const { return FuseTime; }
+
+	/* The managed projectile this actor was spawned for, so clients can remove their simulated copy */
+	UPROPERTY(Transient, Replicated)
+	int32 ProjectileId;
+
+protected:
+	UPROPERTY(EditDefaultsOnly, Category = "Components")
+	class UStaticMeshComponent* ThrowableMesh;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Components")
+	class UProjectileMovementComponent* ThrowableMovement;
+
+	//How long after being thrown the throwable detonates
+	UPROPERTY(EditDefaultsOnly, Category = "Throwable", meta = (ClampMin = 0.0))
+	float FuseTime;
+
+	//How long the actor sticks around after detonating, so its effects can finish
+	UPROPERTY(EditDefaultsOnly, Category = "Throwable", meta = (ClampMin = 0.0))
+	float DetonatedLifeSpan;
+
+	//The damage dealt around the throwable when it detonates.  Leave the base damage at 0 for throwables that don't do damage
+	UPROPERTY(EditDefaultsOnly, Category = "Throwable")
+	FRadialDamageParams ExplosionDamage;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Throwable")
+	TSubclassOf<class UDamageType> ExplosionDamageType;
+
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_Detonated)
+	bool bDetonated;
+
+	UFUNCTION()
+	void OnRep_Detonated();
+
+	/* Play the detonation effects and apply any gameplay effects (server) */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Throwable")
+	void OnDetonate();
+
+};
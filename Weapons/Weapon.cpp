@@ -1,870 +1,1413 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "Weapon.h"
-#include "../SurvivalGame.h"
-#include "../Player/SurvivalPlayerController.h"
-#include "../Player/SurvivalCharacter.h"
-#include <Components/SkeletalMeshComponent.h>
-#include "Components/AudioComponent.h"
-#include "../Components/InventoryComponent.h"
-#include "Curves/CurveVector.h"
-#include "Kismet/GameplayStatics.h"
-#include "Particles/ParticleSystemComponent.h"
-#include "Sound/SoundCue.h"
-#include "Net/UnrealNetwork.h"
-#include "../Items/EquippableItem.h"
-#include "../Items/AmmoItem.h"
-#include "DrawDebugHelpers.h"
-#include "Camera/CameraShake.h"
-
-// Sets default values
-AWeapon::AWeapon()
-{
-	WeaponMesh = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("WeaponMesh"));
-	WeaponMesh->bReceivesDecals = false;
-	WeaponMesh->SetCollisionObjectType(ECC_WorldDynamic);
-	WeaponMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	WeaponMesh->SetCollisionResponseToAllChannels(ECR_Ignore);
-	RootComponent = WeaponMesh;
-
-	bLoopedMuzzleFX = false;
-	bLoopedFireAnim = false;
-	bPlayingFireAnim = false;
-	bIsEquipped = false;
-	bWantsToFire = false;
-	bPendingReload = false;
-	bPendingEquip = false;
-	CurrentState = EWeaponState::Idle;
-	AttachSocket1P = FName("GripPoint");
-	AttachSocket3P = FName("GripPoint");
-
-	CurrentAmmoInClip = 0;
-	BurstCounter = 0;
-	LastFireTime = 0.0f;
-
-	ADSTime = 0.5f;
-	RecoilResetSpeed = 5.0f;
-	RecoilSpeed = 10.0f;
-
-	PrimaryActorTick.bCanEverTick = true;
-	PrimaryActorTick.TickGroup = TG_PrePhysics;
-	bReplicates = true;
-	bNetUseOwnerRelevancy = true;
-}
-
-void AWeapon::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
-{
-	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-
-	DOREPLIFETIME(AWeapon, PawnOwner);
-	DOREPLIFETIME_CONDITION(AWeapon, CurrentAmmoInClip, COND_OwnerOnly);
-	DOREPLIFETIME_CONDITION(AWeapon, BurstCounter, COND_SkipOwner);
-	DOREPLIFETIME_CONDITION(AWeapon, bPendingReload, COND_SkipOwner);
-	DOREPLIFETIME_CONDITION(AWeapon, Item, COND_InitialOnly);
-}
-
-void AWeapon::PostInitializeComponents()
-{
-	Super::PostInitializeComponents();
-}
-
-// Called when the game starts or when spawned
-void AWeapon::BeginPlay()
-{
-	Super::BeginPlay();
-	
-	if (HasAuthority())
-	{
-		PawnOwner = Cast<ASurvivalCharacter>(GetOwner());
-	}
-}
-
-void AWeapon::Destroyed()
-{
-	Super::Destroyed();
-
-	StopSimulatingWeaponFire();
-}
-
-void AWeapon::UseClipAmmo()
-{
-	if (HasAuthority())
-	{
-		--CurrentAmmoInClip;
-	}
-}
-
-void AWeapon::ConsumeAmmo(const int32 Amount)
-{
-	if (HasAuthority() && PawnOwner)
-	{
-		if (UInventoryComponent* Inventory = PawnOwner->PlayerInventory)
-		{
-			if (UItem* AmmoItem = Inventory->FindItemByClass(WeaponConfig.AmmoClass))
-			{
-				Inventory->TryAddItemFromClass(WeaponConfig.AmmoClass, CurrentAmmoInClip);
-			}
-		}
-	}
-}
-
-void AWeapon::ReturnAmmoToInventory()
-{
-	//When the weapon is unequipped, try to return the players ammo to their inventory
-	if (HasAuthority())
-	{
-		if (PawnOwner && CurrentAmmoInClip > 0)
-		{
-			if (UInventoryComponent* Inventory = PawnOwner->PlayerInventory)
-			{
-				Inventory->TryAddItemFromClass(WeaponConfig.AmmoClass, CurrentAmmoInClip);
-			}
-		}
-	}
-}
-
-void AWeapon::OnEquip()
-{
-	AttachMeshToPawn();
-
-	bPendingEquip = true;
-	DetermineWeaponState();
-
-	OnEquipFinished();
-
-	if (PawnOwner && PawnOwner->IsLocallyControlled())
-	{
-		PlayWeaponSound(EquipSound);
-	}
-}
-
-void AWeapon::OnEquipFinished()
-{
-	AttachMeshToPawn();
-
-	bIsEquipped = true;
-	bPendingEquip = false;
-
-	//Determine the state so that the can reload checks will work
-	DetermineWeaponState();
-
-	if (PawnOwner)
-	{
-		//Try to reload empty clip
-		if (PawnOwner->IsLocallyControlled() && CurrentAmmoInClip <= 0 && CanReload())
-		{
-			StartReload();
-		}
-	}
-}
-
-void AWeapon::OnUnEquip()
-{
-	bIsEquipped = false;
-	StopFire();
-
-	if (bPendingReload)
-	{
-		StopWeaponAnimation(ReloadAnim);
-		bPendingReload = false;
-
-		GetWorldTimerManager().ClearTimer(TimerHandle_StopReload);
-		GetWorldTimerManager().ClearTimer(TimerHandle_ReloadWeapon);
-	}
-
-	if (bPendingEquip)
-	{
-		StopWeaponAnimation(EquipAnim);
-		bPendingEquip = false;
-
-		GetWorldTimerManager().ClearTimer(TimerHandle_OnEquipFinished);
-	}
-
-	ReturnAmmoToInventory();
-	DetermineWeaponState();
-}
-
-bool AWeapon::IsEquipped() const
-{
-	return bIsEquipped;
-}
-
-bool AWeapon::IsAttachedToPawn() const
-{
-	return bIsEquipped || bPendingEquip;
-}
-
-void AWeapon::StartFire()
-{
-	if (GetLocalRole() < ROLE_Authority)
-	{
-		ServerStartFire();
-	}
-
-	if (!bWantsToFire)
-	{
-		bWantsToFire = true;
-		DetermineWeaponState();
-	}
-}
-
-void AWeapon::StopFire()
-{
-	if ((GetLocalRole() < ROLE_Authority) && PawnOwner && PawnOwner->IsLocallyControlled())
-	{
-		ServerStopFire();
-	}
-
-	if (bWantsToFire)
-	{
-		bWantsToFire = false;
-		DetermineWeaponState();
-	}
-}
-
-void AWeapon::StartReload(bool bFromReplication /*= false*/)
-{
-	if (!bFromReplication && GetLocalRole() < ROLE_Authority)
-	{
-		ServerStartReload();
-	}
-
-	if (bFromReplication || CanReload())
-	{
-		bPendingReload = true;
-		DetermineWeaponState();
-
-		float AnimDuration = PlayWeaponAnimation(ReloadAnim);
-		if (AnimDuration <= 0.0f)
-		{
-			AnimDuration = 0.5f;
-		}
-
-		GetWorldTimerManager().SetTimer(TimerHandle_StopReload, this, &AWeapon::StopReload, AnimDuration, false);
-		if (HasAuthority())
-		{
-			GetWorldTimerManager().SetTimer(TimerHandle_ReloadWeapon, this, &AWeapon::ReloadWeapon, FMath::Max(0.1f, AnimDuration - 0.1f), false);
-		}
-
-		if (PawnOwner && PawnOwner->IsLocallyControlled())
-		{
-			PlayWeaponSound(ReloadSound);
-		}
-	}
-}
-
-void AWeapon::StopReload()
-{
-	if (CurrentState == EWeaponState::Reloading)
-	{
-		bPendingReload = false;
-		DetermineWeaponState();
-		StopWeaponAnimation(ReloadAnim);
-	}
-}
-
-void AWeapon::ReloadWeapon()
-{
-	const int32 ClipDelta = FMath::Min(WeaponConfig.AmmoPerClip - CurrentAmmoInClip, GetCurrentAmmo());
-
-	if (ClipDelta > 0)
-	{
-		CurrentAmmoInClip += ClipDelta;
-		ConsumeAmmo(ClipDelta);
-	}
-	else
-	{
-		UE_LOG(LogTemp, Warning, TEXT("Didn't have enough ammo for a reload."));
-	}
-}
-
-void AWeapon::ClientStartReload_Implementation()
-{
-	StartReload();
-}
-
-bool AWeapon::CanFire() const
-{
-	bool bCanFire = PawnOwner != nullptr;
-	bool bStateOKToFire = ((CurrentState == EWeaponState::Idle) || (CurrentState == EWeaponState::Firing));
-	return ((bCanFire == true) && (bStateOKToFire == true) && (bPendingReload == false));
-}
-
-bool AWeapon::CanReload() const
-{
-	bool bCanReload = PawnOwner != nullptr;
-	bool bGotAmmo = (CurrentAmmoInClip < WeaponConfig.AmmoPerClip) && (GetCurrentAmmo() > 0);
-	bool bStateOKToReload = ((CurrentState == EWeaponState::Idle) || (CurrentState == EWeaponState::Firing));
-	return ((bCanReload == true) && (bGotAmmo == true) && (bStateOKToReload == true));
-}
-
-EWeaponState AWeapon::GetCurrentState() const
-{
-	return CurrentState;
-}
-
-int32 AWeapon::GetCurrentAmmo() const
-{
-	if (PawnOwner)
-	{
-		if (UInventoryComponent* Inventory = PawnOwner->PlayerInventory)
-		{
-			if (UItem* Ammo = Inventory->FindItemByClass(WeaponConfig.AmmoClass))
-			{
-				return Ammo->GetQuantity();
-			}
-		}
-	}
-
-	return 0;
-}
-
-int32 AWeapon::GetCurrentAmmoInClip() const
-{
-	return CurrentAmmoInClip;
-}
-
-int32 AWeapon::GetAmmoPerClip() const
-{
-	return WeaponConfig.AmmoPerClip;
-}
-
-USkeletalMeshComponent* AWeapon::GetWeaponMesh() const
-{
-	return WeaponMesh;
-}
-
-class ASurvivalCharacter* AWeapon::GetPawnOwner() const
-{
-	return PawnOwner;
-}
-
-void AWeapon::SetPawnOwner(ASurvivalCharacter* SurvivalCharacter)
-{
-	if (PawnOwner != SurvivalCharacter)
-	{
-		SetInstigator(SurvivalCharacter);
-		PawnOwner = SurvivalCharacter;
-		// net owner for RPC calls
-		SetOwner(SurvivalCharacter);
-	}
-}
-
-float AWeapon::GetEquipStartedTime() const
-{
-	return EquipStartedTime;
-}
-
-float AWeapon::GetEquipDuration() const
-{
-	return EquipDuration;
-}
-
-void AWeapon::ServerStartFire_Implementation()
-{
-	StartFire();
-}
-
-bool AWeapon::ServerStartFire_Validate()
-{
-	return true;
-}
-
-void AWeapon::ServerStopFire_Implementation()
-{
-	StopFire();
-}
-
-bool AWeapon::ServerStopFire_Validate()
-{
-	return true;
-}
-
-void AWeapon::ServerStartReload_Implementation()
-{
-	StartReload();
-}
-
-bool AWeapon::ServerStartReload_Validate()
-{
-	return true;
-}
-
-void AWeapon::ServerStopReload_Implementation()
-{
-	StopReload();
-}
-
-bool AWeapon::ServerStopReload_Validate()
-{
-	return true;
-}
-
-void AWeapon::OnRep_PawnOwner()
-{
-
-}
-
-void AWeapon::OnRep_BurstCounter()
-{
-	if (BurstCounter > 0)
-	{
-		SimulateWeaponFire();
-	}
-	else
-	{
-		StopSimulatingWeaponFire();
-	}
-}
-
-void AWeapon::OnRep_Reload()
-{
-	if (bPendingReload)
-	{
-		StartReload();
-	}
-	else
-	{
-		StopReload();
-	}
-}
-
-void AWeapon::SimulateWeaponFire()
-{
-	if (HasAuthority() && CurrentState != EWeaponState::Firing)
-	{
-		return;
-	}
-
-	if (MuzzleFX)
-	{
-		if (!bLoopedMuzzleFX || MuzzlePSC == nullptr)
-		{
-			//Split screen requires we create 2 effects.  One that we see and one that the other player sees
-			if ((PawnOwner != nullptr) &&(PawnOwner->IsLocallyControlled() == true))
-			{
-				AController* PlayerCon = PawnOwner->GetController();
-				if (PlayerCon != nullptr)
-				{
-					WeaponMesh->GetSocketLocation(MuzzleAttachPoint);
-					MuzzlePSC = UGameplayStatics::SpawnEmitterAttached(MuzzleFX, WeaponMesh, MuzzleAttachPoint);
-					MuzzlePSC->bOwnerNoSee = false;
-					MuzzlePSC->bOnlyOwnerSee = true;
-				}
-			}
-			else
-			{
-				MuzzlePSC = UGameplayStatics::SpawnEmitterAttached(MuzzleFX, WeaponMesh, MuzzleAttachPoint);
-			}
-		}
-	}
-
-	if (!bLoopedFireAnim || bPlayingFireAnim)
-	{
-		FWeaponAnim AnimToPlay = FireAnim; //PawnOwner->IsAiming() || PawnOwner->IsLocallyControlled() ? FireAimingAnim : FireAnim;
-		PlayWeaponAnimation(FireAnim);
-		bPlayingFireAnim = true;
-	}
-
-	if (bLoopedFireSound)
-	{
-		if (FireAC == nullptr)
-		{
-			FireAC = PlayWeaponSound(FireLoopSound);
-		}
-	}
-	else
-	{
-		PlayWeaponSound(FireSound);
-	}
-
-	ASurvivalPlayerController* PC = (PawnOwner != nullptr) ? Cast<ASurvivalPlayerController>(PawnOwner->Controller) : nullptr;
-	if (PC != nullptr && PC->IsLocalController())
-	{
-		if (FireCameraShake != nullptr)
-		{
-			PC->ClientPlayCameraShake(FireCameraShake, 1);
-		}
-		if (FireForceFeedback != nullptr)
-		{
-			FForceFeedbackParameters FFParams;
-			FFParams.Tag = "Weapon";
-			PC->ClientPlayForceFeedback(FireForceFeedback, FFParams);
-		}
-	}
-}
-
-void AWeapon::StopSimulatingWeaponFire()
-{
-	if (bLoopedMuzzleFX)
-	{
-		if (MuzzlePSC != nullptr)
-		{
-			MuzzlePSC->DeactivateSystem();
-			MuzzlePSC = nullptr;
-		}
-		if (MuzzlePSCSecondary != nullptr)
-		{
-			MuzzlePSCSecondary->DeactivateSystem();
-			MuzzlePSCSecondary = nullptr;
-		}
-	}
-
-	if (bLoopedFireAnim && bPlayingFireAnim)
-	{
-		StopWeaponAnimation(FireAimingAnim);
-		StopWeaponAnimation(FireAnim);
-		bPlayingFireAnim = false;
-	}
-
-	if (FireAC)
-	{
-		FireAC->FadeOut(0.1f, 0.0f);
-		FireAC = nullptr;
-
-		PlayWeaponSound(FireFinishedSound);
-	}
-}
-
-void AWeapon::HandleHit(const FHitResult& Hit, class ASurvivalCharacter* HitPlayer /*= nullptr*/)
-{
-	if (Hit.GetActor())
-	{
-		UE_LOG(LogTemp, Warning, TEXT("Hit actor %s"), *Hit.GetActor()->GetName());
-	}
-
-	ServerHandleHit(Hit, HitPlayer);
-
-	if (HitPlayer && PawnOwner)
-	{
-		if (ASurvivalPlayerController* PC = Cast<ASurvivalPlayerController>(PawnOwner->GetController()))
-		{
-			PC->OnHitPlayer();
-		}
-	}
-}
-
-void AWeapon::ServerHandleHit_Implementation(const FHitResult& Hit, class ASurvivalCharacter* HitPlayer /*= nullptr*/)
-{
-	if (PawnOwner)
-	{
-		float DamageMultiplier = 1.0f;
-
-		/* Certain bones like head might give extra damage if hit.  Apply those. */
-		for (auto& BoneDamageModifier : HitScanConfig.BoneDamageModifiers)
-		{
-			DamageMultiplier = BoneDamageModifier.Value;
-			break;
-		}
-
-		if (HitPlayer)
-		{
-			UGameplayStatics::ApplyPointDamage(HitPlayer, HitScanConfig.Damage * DamageMultiplier, (Hit.TraceStart - Hit.TraceEnd).GetSafeNormal(), Hit, PawnOwner->GetController(), this, HitScanConfig.DamageType);
-		}
-	}
-
-	
-}
-
-bool AWeapon::ServerHandleHit_Validate(const FHitResult& Hit, class ASurvivalCharacter* HitPlayer /*= nullptr*/)
-{
-	return true;
-}
-
-void AWeapon::FireShot()
-{
-	if (PawnOwner)
-	{
-		if (ASurvivalPlayerController* PC = Cast<ASurvivalPlayerController>(PawnOwner->GetController()))
-		{
-			if (RecoilCurve)
-			{
-				const FVector2D RecoilAmount(RecoilCurve->GetVectorValue(FMath::RandRange(0.f, 1.f)).X, RecoilCurve->GetVectorValue(FMath::RandRange(0.f, 1.f)).Y);
-				PC->ApplyRecoil(RecoilAmount, RecoilSpeed, RecoilResetSpeed, FireCameraShake);
-			}
-
-			FVector CamLoc;
-			FRotator CamRot;
-			PC->GetPlayerViewPoint(CamLoc, CamRot);
-
-			FHitResult Hit;
-			FCollisionQueryParams QueryParams;
-			QueryParams.AddIgnoredActor(this);
-			QueryParams.AddIgnoredActor(PawnOwner);
-
-			FVector FireDir = CamRot.Vector();//PawnOwner->IsAiming() ? CamRot.Vector() : FMath::VRandCone(CamRot.Vector(), FMath::DegreesToRadians(PawnOwner->IsAiming() ? 0.f : 5.f));
-			FVector TraceStart = CamLoc;
-			FVector TraceEnd = (FireDir * HitScanConfig.Distance) + CamLoc;
-
-			if (GetWorld()->LineTraceSingleByChannel(Hit, TraceStart, TraceEnd, COLLISION_WEAPON, QueryParams))
-			{
-				ASurvivalCharacter* HitChar = Cast<ASurvivalCharacter>(Hit.GetActor());
-
-				HandleHit(Hit, HitChar);
-
-				FColor PointColor = FColor::Red;
-				DrawDebugPoint(GetWorld(), Hit.ImpactPoint, 5.f, PointColor, false, 30.f);
-			}
-		}
-	}
-}
-
-void AWeapon::HandleReFiring()
-{
-	UWorld* MyWorld = GetWorld();
-
-	float SlackTimeThisFrame = FMath::Max(0.0f, (MyWorld->TimeSeconds - LastFireTime) - WeaponConfig.TimeBetweenShots);
-
-	if (bAllowAutomaticCatchup)
-	{
-		TimerIntervalAdjustment -= SlackTimeThisFrame;
-	}
-
-	HandleFiring();
-}
-
-void AWeapon::HandleFiring()
-{
-	if ((CurrentAmmoInClip>0) && CanFire())
-	{
-		if (GetNetMode() != NM_DedicatedServer)
-		{
-			SimulateWeaponFire();
-		}
-
-		if (PawnOwner && PawnOwner->IsLocallyControlled())
-		{
-			FireShot();
-			UseClipAmmo();
-
-			// update firing FX on remote clients if function was called on server
-			BurstCounter++;
-		}
-	}
-	else if (CanReload())
-	{
-		StartReload();
-	}
-	else if (PawnOwner && PawnOwner->IsLocallyControlled())
-	{
-		if (GetCurrentAmmo() == 0 && !bRefiring)
-		{
-			PlayWeaponSound(OutOfAmmoSound);
-			ASurvivalPlayerController* MyPC = Cast<ASurvivalPlayerController>(PawnOwner->Controller);
-		}
-	}
-
-	// stop weapon fire FX, but stay in firing state
-	if (BurstCounter > 0)
-	{
-		OnBurstFinished();
-	}
-
-	if (PawnOwner && PawnOwner->IsLocallyControlled())
-	{
-		// local client will notify server
-		if (GetLocalRole() < ROLE_Authority)
-		{
-			ServerHandleFiring();
-		}
-
-		// reload after firing last round
-		if (CurrentAmmoInClip <= 0 && CanReload())
-		{
-			StartReload();
-		}
-
-		// setup refire timer
-		bRefiring = (CurrentState == EWeaponState::Firing && WeaponConfig.TimeBetweenShots > 0.0f);
-		if (bRefiring)
-		{
-			GetWorldTimerManager().SetTimer(TimerHandle_HandleFiring, this, &AWeapon::HandleReFiring, FMath::Max<float>(WeaponConfig.TimeBetweenShots + TimerIntervalAdjustment, SMALL_NUMBER), false);
-			TimerIntervalAdjustment = 0.f;
-		}
-	}
-
-	LastFireTime = GetWorld()->GetTimeSeconds();
-}
-
-void AWeapon::OnBurstStarted()
-{
-	// start firing, can be delayed to satisfy TimeBetweenShots
-	const float GameTime = GetWorld()->GetTimeSeconds();
-	if (LastFireTime > 0 && WeaponConfig.TimeBetweenShots > 0.0f && LastFireTime + WeaponConfig.TimeBetweenShots > GameTime)
-	{
-		GetWorldTimerManager().SetTimer(TimerHandle_HandleFiring, this, &AWeapon::HandleFiring, LastFireTime + WeaponConfig.TimeBetweenShots - GameTime, false);
-	}
-	else
-	{
-		HandleFiring();
-	}
-}
-
-void AWeapon::OnBurstFinished()
-{
-	// stop firing FX on remote clients
-	BurstCounter = 0;
-
-	// stop firing FX locally, unless it's a dedicated server
-	if (GetNetMode() != NM_DedicatedServer)
-	{
-		StopSimulatingWeaponFire();
-	}
-
-	GetWorldTimerManager().ClearTimer(TimerHandle_HandleFiring);
-	bRefiring = false;
-
-	// reset firing interval adjustment
-	TimerIntervalAdjustment = 0.0f;
-}
-
-void AWeapon::SetWeaponState(EWeaponState NewState)
-{
-	const EWeaponState PrevState = CurrentState;
-
-	if (PrevState == EWeaponState::Firing && NewState != EWeaponState::Firing)
-	{
-		OnBurstFinished();
-	}
-
-	CurrentState = NewState;
-
-	if (PrevState != EWeaponState::Firing && NewState == EWeaponState::Firing)
-	{
-		OnBurstStarted();
-	}
-}
-
-void AWeapon::DetermineWeaponState()
-{
-	EWeaponState NewState = EWeaponState::Idle;
-
-	if (bIsEquipped)
-	{
-		if (bPendingReload)
-		{
-			if (CanReload() == false)
-			{
-				NewState = CurrentState;
-			}
-			else
-			{
-				NewState = EWeaponState::Reloading;
-			}
-		}
-		else if ((bPendingReload == false) && (bWantsToFire == true) && (CanFire() == true))
-		{
-			NewState = EWeaponState::Firing;
-		}
-	}
-	else if (bPendingEquip)
-	{
-		NewState = EWeaponState::Equipping;
-	}
-
-	SetWeaponState(NewState);
-}
-
-void AWeapon::AttachMeshToPawn()
-{
-	if (PawnOwner)
-	{
-		if (const USkeletalMeshComponent* PawnMesh = PawnOwner->GetMesh())
-		{
-			const FName AttachSocket = PawnOwner->IsLocallyControlled() ? AttachSocket1P : AttachSocket3P;
-			AttachToComponent(PawnOwner->GetMesh(), FAttachmentTransformRules::SnapToTargetIncludingScale, AttachSocket);
-		}
-	}
-}
-
-UAudioComponent* AWeapon::PlayWeaponSound(USoundCue* Sound)
-{
-	UAudioComponent* AC = nullptr;
-	if (Sound && PawnOwner)
-	{
-		AC = UGameplayStatics::SpawnSoundAttached(Sound, PawnOwner->GetRootComponent());
-	}
-
-	return AC;
-}
-
-float AWeapon::PlayWeaponAnimation(const FWeaponAnim& Animation)
-{
-	float Duration = 0.0f;
-	if (PawnOwner)
-	{
-		UAnimMontage* UseAnim = PawnOwner->IsLocallyControlled() ? Animation.Pawn1P : Animation.Pawn3P;
-		if (UseAnim)
-		{
-			Duration = PawnOwner->PlayAnimMontage(UseAnim);
-		}
-	}
-
-	return Duration;
-}
-
-void AWeapon::StopWeaponAnimation(const FWeaponAnim& Animation)
-{
-	if (PawnOwner)
-	{
-		UAnimMontage* UseAnim = PawnOwner->IsLocallyControlled() ? Animation.Pawn1P : Animation.Pawn3P;
-		if (UseAnim)
-		{
-			PawnOwner->StopAnimMontage(UseAnim);
-		}
-	}
-}
-
-FVector AWeapon::GetCameraAim() const
-{
-	ASurvivalPlayerController* const PlayerController = GetInstigator() ? Cast<ASurvivalPlayerController>(GetInstigator()->Controller) : nullptr;
-	FVector FinalAim = FVector::ZeroVector;
-
-	if (PlayerController)
-	{
-		FVector CamLoc;
-		FRotator CamRot;
-		PlayerController->GetPlayerViewPoint(CamLoc, CamRot);
-		FinalAim = CamRot.Vector();
-	}
-	else if (GetInstigator())
-	{
-		FinalAim = GetInstigator()->GetBaseAimRotation().Vector();
-	}
-
-	return FinalAim;
-}
-
-FHitResult AWeapon::WeaponTrace(const FVector& StartTrace, const FVector& EndTrace) const
-{
-	// Performs trade to retrieve hit info
-	FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(WeaponTrace), true, GetInstigator());
-	TraceParams.bReturnPhysicalMaterial = true;
-
-	FHitResult Hit(ForceInit);
-	GetWorld()->LineTraceSingleByChannel(Hit, StartTrace, EndTrace, COLLISION_WEAPON, TraceParams);
-
-	return Hit;
-}
-
-void AWeapon::ServerHandleFiring_Implementation()
-{
-	const bool bShouldUpdateAmmo = (CurrentAmmoInClip > 0 && CanFire());
-
-	HandleFiring();
-
-	if (bShouldUpdateAmmo)
-	{
-		// update ammo
-		UseClipAmmo();
-
-		// update firing FX on remote clients
-		BurstCounter++;
-	}
-}
-
-bool AWeapon::ServerHandleFiring_Validate()
-{
-	return true;
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Weapon.h"
+#include "../SurvivalGame.h"
+#include "../Player/SurvivalPlayerController.h"
+#include "../Player/SurvivalCharacter.h"
+#include <Components/SkeletalMeshComponent.h>
+#include "Components/AudioComponent.h"
+#include "../Components/InventoryComponent.h"
+#include "Curves/CurveVector.h"
+#include "Kismet/GameplayStatics.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Sound/SoundCue.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "GameFramework/GameStateBase.h"
+#include "../Items/EquippableItem.h"
+#include "../Items/AmmoItem.h"
+#include "DrawDebugHelpers.h"
+#include "Camera/CameraShake.h"
+#include "WeaponFXSubsystem.h"
+#include "WeaponProfile.h"
+#include "DamageQueueSubsystem.h"
+#include "WeaponFireEventRelay.h"
+#include "RPCRateLimiter.h"
+#include "WeaponLatencyTracer.h"
+
+DECLARE_CYCLE_STAT(TEXT("Weapon ServerHandleFiring"), STAT_WeaponServerHandleFiring, STATGROUP_SurvivalGame);
+DECLARE_CYCLE_STAT(TEXT("Weapon ServerHandleHit"), STAT_WeaponServerHandleHit, STATGROUP_SurvivalGame);
+
+//Reloads take at least a reload animation, so legitimate clients never get near this
+static const float MaxReloadRPCsPerSecond = 2.f;
+
+static TAutoConsoleVariable<float> CVarFireEventNearDistance(
+	TEXT("Weapon.FireEvents.NearDistance"),
+	2000.f,
+	TEXT("Remote players this close to a firing weapon are sent every shot as it happens."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarFireEventFarDistance(
+	TEXT("Weapon.FireEvents.FarDistance"),
+	10000.f,
+	TEXT("Remote players this far from a firing weapon get its shots batched for Weapon.FireEvents.MaxInterval."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarFireEventMaxInterval(
+	TEXT("Weapon.FireEvents.MaxInterval"),
+	0.5f,
+	TEXT("The longest time shots are batched for before being sent to remote clients. 0 sends every shot."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarFireEventMaxAge(
+	TEXT("Weapon.FireEvents.MaxAge"),
+	1.f,
+	TEXT("Fire events older than this when they arrive are not played."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarShotValidationSpreadTolerance(
+	TEXT("Weapon.ShotValidation.SpreadTolerance"),
+	0.5f,
+	TEXT("The most a hits direction can differ from the servers reproduction of the shot, as a fraction of the weapons spread."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarShotValidationMinAngle(
+	TEXT("Weapon.ShotValidation.MinAngle"),
+	1.f,
+	TEXT("The least a hits direction is allowed to differ from the servers reproduction of the shot, in degrees, for weapons with little or no spread.\n")
+	TEXT("The direction check is disabled if this and SpreadTolerance are both 0."),
+	ECVF_Default);
+
+// Sets default values
+AWeapon::AWeapon()
+{
+	WeaponMesh = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("WeaponMesh"));
+	WeaponMesh->bReceivesDecals = false;
+	WeaponMesh->SetCollisionObjectType(ECC_WorldDynamic);
+	WeaponMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	WeaponMesh->SetCollisionResponseToAllChannels(ECR_Ignore);
+	RootComponent = WeaponMesh;
+
+	bLoopedMuzzleFX = false;
+	bLoopedFireAnim = false;
+	bPlayingFireAnim = false;
+	bIsEquipped = false;
+	bWantsToFire = false;
+	bPendingReload = false;
+	bPendingEquip = false;
+	CurrentState = EWeaponState::Idle;
+	AttachSocket1P = FName("GripPoint");
+	AttachSocket3P = FName("GripPoint");
+
+	CurrentAmmoInClip = 0;
+	LocalActionSequence = 0;
+	PendingReloadSequence = 0;
+	ReserveAmmo = 0;
+	BurstCounter = 0;
+	PendingFireEventTime = 0.f;
+	PendingFireEventDirection = FVector::ForwardVector;
+	RemoteShotsToSimulate = 0;
+	RemoteFireDirection = FVector::ForwardVector;
+	LastFireTime = 0.0f;
+	ShotSeed = 0;
+	LastShotId = 0;
+	UnvalidatedShotId = 0;
+
+	ADSTime = 0.5f;
+	RecoilResetSpeed = 5.0f;
+	RecoilSpeed = 10.0f;
+
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+	bReplicates = true;
+	bNetUseOwnerRelevancy = true;
+}
+
+void AWeapon::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	//Everything is push based, so a weapon nobody is using costs nothing to consider for replication
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(AWeapon, PawnOwner, Params);
+
+	Params.Condition = COND_OwnerOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AWeapon, ActionAck, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AWeapon, ShotSeed, Params);
+
+	Params.Condition = COND_SkipOwner;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AWeapon, bPendingReload, Params);
+
+	Params.Condition = COND_InitialOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AWeapon, Item, Params);
+}
+
+void AWeapon::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	Profile = UWeaponProfileSubsystem::GetProfile(this);
+
+	//The profile holds the shared copy of the bone modifiers, so there is no need for every instance to keep its own
+	HitScanConfig.BoneDamageModifiers.Empty();
+}
+
+// Called when the game starts or when spawned
+void AWeapon::BeginPlay()
+{
+	Super::BeginPlay();
+	
+	if (HasAuthority())
+	{
+		PawnOwner = Cast<ASurvivalCharacter>(GetOwner());
+		ShotSeed = FMath::Rand();
+		MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, PawnOwner, this);
+		MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, ShotSeed, this);
+	}
+
+	BindAmmoLedger();
+}
+
+void AWeapon::Destroyed()
+{
+	//Whether our item threw the holstered weapon away or the owner destroyed it on unequip, the clip isn't lost
+	ReturnAmmoToInventory();
+
+	Super::Destroyed();
+
+	UnbindAmmoLedger();
+	StopSimulatingWeaponFire();
+}
+
+void AWeapon::UseClipAmmo()
+{
+	//The owning client predicts this too, the server corrects it through ActionAck if it disagrees
+	--CurrentAmmoInClip;
+}
+
+int32 AWeapon::ConsumeAmmo(const int32 Amount)
+{
+	if (HasAuthority() && PawnOwner)
+	{
+		if (UInventoryComponent* Inventory = PawnOwner->PlayerInventory)
+		{
+			return Inventory->ConsumeItemsByClass(Profile->WeaponConfig.AmmoClass, Amount);
+		}
+	}
+
+	return 0;
+}
+
+void AWeapon::BindAmmoLedger()
+{
+	UInventoryComponent* Inventory = PawnOwner ? PawnOwner->PlayerInventory : nullptr;
+
+	if (Inventory != LedgerInventory.Get())
+	{
+		UnbindAmmoLedger();
+
+		if (Inventory)
+		{
+			LedgerInventory = Inventory;
+			LedgerDelegateHandle = Inventory->OnItemQuantityChanged.AddUObject(this, &AWeapon::OnInventoryItemQuantityChanged);
+		}
+	}
+
+	RecountReserveAmmo();
+}
+
+void AWeapon::UnbindAmmoLedger()
+{
+	if (UInventoryComponent* Inventory = LedgerInventory.Get())
+	{
+		Inventory->OnItemQuantityChanged.Remove(LedgerDelegateHandle);
+	}
+
+	LedgerInventory.Reset();
+	LedgerDelegateHandle.Reset();
+}
+
+void AWeapon::RecountReserveAmmo()
+{
+	ReserveAmmo = 0;
+
+	if (UInventoryComponent* Inventory = LedgerInventory.Get())
+	{
+		for (UItem* InvItem : Inventory->GetItems())
+		{
+			if (InvItem && InvItem->GetClass() == Profile->WeaponConfig.AmmoClass)
+			{
+				ReserveAmmo += InvItem->GetQuantity();
+			}
+		}
+	}
+}
+
+void AWeapon::OnInventoryItemQuantityChanged(class UItem* ChangedItem, const int32 QuantityDelta)
+{
+	if (ChangedItem && ChangedItem->GetClass() != Profile->WeaponConfig.AmmoClass)
+	{
+		return;
+	}
+
+	//Clients can't rely on items and their quantities replicating in order, so they recount instead of applying the delta
+	if (ChangedItem && HasAuthority())
+	{
+		ReserveAmmo = FMath::Max(0, ReserveAmmo + QuantityDelta);
+	}
+	else
+	{
+		RecountReserveAmmo();
+	}
+}
+
+void AWeapon::ReturnAmmoToInventory()
+{
+	//When the weapon is unequipped, try to return the players ammo to their inventory
+	if (HasAuthority())
+	{
+		if (PawnOwner && CurrentAmmoInClip > 0)
+		{
+			if (UInventoryComponent* Inventory = PawnOwner->PlayerInventory)
+			{
+				Inventory->TryAddItemFromClass(Profile->WeaponConfig.AmmoClass, CurrentAmmoInClip);
+				CurrentAmmoInClip = 0;
+				AcknowledgeAction(ActionAck.Sequence);
+			}
+		}
+	}
+}
+
+void AWeapon::OnEquip()
+{
+	//The owner is a friend and may have set Item without going through SetItem, make sure it still replicates
+	if (HasAuthority())
+	{
+		MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, Item, this);
+	}
+
+	SetHolstered(false);
+	AttachMeshToPawn();
+
+	bPendingEquip = true;
+	DetermineWeaponState();
+
+	OnEquipFinished();
+
+	if (PawnOwner && PawnOwner->IsLocallyControlled())
+	{
+		PlayWeaponSound(EquipSound);
+	}
+}
+
+void AWeapon::OnEquipFinished()
+{
+	AttachMeshToPawn();
+
+	bIsEquipped = true;
+	bPendingEquip = false;
+
+	//Determine the state so that the can reload checks will work
+	DetermineWeaponState();
+
+	if (PawnOwner)
+	{
+		//Try to reload empty clip
+		if (PawnOwner->IsLocallyControlled() && CurrentAmmoInClip <= 0 && CanReload())
+		{
+			StartReload();
+		}
+	}
+}
+
+void AWeapon::OnUnEquip()
+{
+	bIsEquipped = false;
+	StopFire();
+
+	if (bPendingReload)
+	{
+		StopWeaponAnimation(ReloadAnim);
+		bPendingReload = false;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, bPendingReload, this);
+
+		GetWorldTimerManager().ClearTimer(TimerHandle_StopReload);
+		GetWorldTimerManager().ClearTimer(TimerHandle_ReloadWeapon);
+
+		//The reload won't complete now, let the owner know so it drops its prediction
+		if (HasAuthority())
+		{
+			AcknowledgeAction(PendingReloadSequence);
+		}
+	}
+
+	if (bPendingEquip)
+	{
+		StopWeaponAnimation(EquipAnim);
+		bPendingEquip = false;
+
+		GetWorldTimerManager().ClearTimer(TimerHandle_OnEquipFinished);
+	}
+
+	//The clip stays in the weapon while it's holstered, it only goes back to the inventory when the weapon is destroyed
+	DetermineWeaponState();
+	SetHolstered(true);
+}
+
+void AWeapon::SetHolstered(const bool bHolstered)
+{
+	SetActorHiddenInGame(bHolstered);
+	SetActorTickEnabled(!bHolstered);
+
+	if (bHolstered)
+	{
+		DetachFromActor(FDetachmentTransformRules::KeepRelativeTransform);
+	}
+
+	if (HasAuthority())
+	{
+		//Nothing about a holstered weapon changes, so stop considering it for replication until it comes back out
+		SetNetDormancy(bHolstered ? DORM_DormantAll : DORM_Awake);
+	}
+}
+
+bool AWeapon::IsEquipped() const
+{
+	return bIsEquipped;
+}
+
+bool AWeapon::IsAttachedToPawn() const
+{
+	return bIsEquipped || bPendingEquip;
+}
+
+void AWeapon::StartFire()
+{
+	if (PawnOwner && PawnOwner->IsLocallyControlled())
+	{
+		//Traced as the shot we're about to fire, so the time until it fires can be measured
+		FWeaponLatencyTracer::RecordStage(FWeaponLatencyTracer::MakeTraceId(this, GetNextShotId()), EWeaponTraceStage::StartFire);
+	}
+
+	if (GetLocalRole() < ROLE_Authority)
+	{
+		ServerStartFire();
+	}
+
+	if (!bWantsToFire)
+	{
+		bWantsToFire = true;
+		DetermineWeaponState();
+	}
+}
+
+void AWeapon::StopFire()
+{
+	if ((GetLocalRole() < ROLE_Authority) && PawnOwner && PawnOwner->IsLocallyControlled())
+	{
+		ServerStopFire();
+	}
+
+	if (bWantsToFire)
+	{
+		bWantsToFire = false;
+		DetermineWeaponState();
+	}
+}
+
+void AWeapon::StartReload(bool bFromReplication /*= false*/)
+{
+	if (!bFromReplication && GetLocalRole() < ROLE_Authority)
+	{
+		//Only ask the server for reloads we can predict, it will tell us if it disagrees
+		if (!CanReload())
+		{
+			return;
+		}
+
+		ServerStartReload(RecordPredictedAction(0, true));
+	}
+
+	if (bFromReplication || CanReload())
+	{
+		bPendingReload = true;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, bPendingReload, this);
+		DetermineWeaponState();
+
+		float AnimDuration = PlayWeaponAnimation(ReloadAnim);
+		if (AnimDuration <= 0.0f)
+		{
+			AnimDuration = 0.5f;
+		}
+
+		GetWorldTimerManager().SetTimer(TimerHandle_StopReload, this, &AWeapon::StopReload, AnimDuration, false);
+		if (HasAuthority() || (!bFromReplication && PawnOwner && PawnOwner->IsLocallyControlled()))
+		{
+			GetWorldTimerManager().SetTimer(TimerHandle_ReloadWeapon, this, &AWeapon::ReloadWeapon, FMath::Max(0.1f, AnimDuration - 0.1f), false);
+		}
+
+		if (PawnOwner && PawnOwner->IsLocallyControlled())
+		{
+			PlayWeaponSound(ReloadSound);
+		}
+	}
+}
+
+void AWeapon::StopReload()
+{
+	if (CurrentState == EWeaponState::Reloading)
+	{
+		bPendingReload = false;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, bPendingReload, this);
+		DetermineWeaponState();
+		StopWeaponAnimation(ReloadAnim);
+	}
+}
+
+void AWeapon::ReloadWeapon()
+{
+	const int32 ClipDelta = FMath::Min(Profile->WeaponConfig.AmmoPerClip - CurrentAmmoInClip, GetCurrentAmmo());
+
+	if (ClipDelta > 0)
+	{
+		if (HasAuthority())
+		{
+			CurrentAmmoInClip += ConsumeAmmo(ClipDelta);
+		}
+		else
+		{
+			//Predict the full clip.  The reserve ammo catches up when the server consumes it from our inventory
+			CurrentAmmoInClip += ClipDelta;
+
+			for (int32 i = PendingActions.Num() - 1; i >= 0; --i)
+			{
+				if (PendingActions[i].bReload)
+				{
+					PendingActions[i].ClipDelta = ClipDelta;
+					break;
+				}
+			}
+		}
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Didn't have enough ammo for a reload."));
+	}
+
+	if (HasAuthority())
+	{
+		AcknowledgeAction(PendingReloadSequence);
+	}
+}
+
+void AWeapon::ClientStartReload_Implementation()
+{
+	StartReload();
+}
+
+bool AWeapon::CanFire() const
+{
+	bool bCanFire = PawnOwner != nullptr;
+	bool bStateOKToFire = ((CurrentState == EWeaponState::Idle) || (CurrentState == EWeaponState::Firing));
+	return ((bCanFire == true) && (bStateOKToFire == true) && (bPendingReload == false));
+}
+
+bool AWeapon::CanReload() const
+{
+	bool bCanReload = PawnOwner != nullptr;
+	bool bGotAmmo = (CurrentAmmoInClip < Profile->WeaponConfig.AmmoPerClip) && (GetCurrentAmmo() > 0);
+	bool bStateOKToReload = ((CurrentState == EWeaponState::Idle) || (CurrentState == EWeaponState::Firing));
+	return ((bCanReload == true) && (bGotAmmo == true) && (bStateOKToReload == true));
+}
+
+EWeaponState AWeapon::GetCurrentState() const
+{
+	return CurrentState;
+}
+
+int32 AWeapon::GetCurrentAmmo() const
+{
+	return ReserveAmmo;
+}
+
+int32 AWeapon::GetCurrentAmmoInClip() const
+{
+	return CurrentAmmoInClip;
+}
+
+int32 AWeapon::GetAmmoPerClip() const
+{
+	return Profile->WeaponConfig.AmmoPerClip;
+}
+
+USkeletalMeshComponent* AWeapon::GetWeaponMesh() const
+{
+	return WeaponMesh;
+}
+
+class ASurvivalCharacter* AWeapon::GetPawnOwner() const
+{
+	return PawnOwner;
+}
+
+void AWeapon::SetPawnOwner(ASurvivalCharacter* SurvivalCharacter)
+{
+	if (PawnOwner != SurvivalCharacter)
+	{
+		SetInstigator(SurvivalCharacter);
+		PawnOwner = SurvivalCharacter;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, PawnOwner, this);
+		// net owner for RPC calls
+		SetOwner(SurvivalCharacter);
+
+		BindAmmoLedger();
+	}
+}
+
+void AWeapon::SetItem(class UWeaponItem* NewItem)
+{
+	if (HasAuthority() && Item != NewItem)
+	{
+		Item = NewItem;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, Item, this);
+	}
+}
+
+float AWeapon::GetEquipStartedTime() const
+{
+	return EquipStartedTime;
+}
+
+float AWeapon::GetEquipDuration() const
+{
+	return EquipDuration;
+}
+
+void AWeapon::ServerStartFire_Implementation()
+{
+	if (ConsumeRPCToken(ERateLimitedRPC::RLR_StartFire, GetShotsPerSecond()))
+	{
+		StartFire();
+	}
+}
+
+bool AWeapon::ServerStartFire_Validate()
+{
+	return true;
+}
+
+void AWeapon::ServerStopFire_Implementation()
+{
+	StopFire();
+}
+
+bool AWeapon::ServerStopFire_Validate()
+{
+	return true;
+}
+
+void AWeapon::ServerStartReload_Implementation(const uint16 Sequence)
+{
+	if (!ConsumeRPCToken(ERateLimitedRPC::RLR_StartReload, MaxReloadRPCsPerSecond))
+	{
+		return;
+	}
+
+	PendingReloadSequence = Sequence;
+	StartReload();
+
+	//A reload that started is acknowledged when it completes, one that couldn't start is acknowledged now
+	if (!bPendingReload)
+	{
+		AcknowledgeAction(Sequence);
+	}
+}
+
+bool AWeapon::ServerStartReload_Validate(const uint16 Sequence)
+{
+	return true;
+}
+
+void AWeapon::ServerStopReload_Implementation()
+{
+	StopReload();
+}
+
+bool AWeapon::ServerStopReload_Validate()
+{
+	return true;
+}
+
+bool AWeapon::ConsumeRPCToken(const ERateLimitedRPC RPC, const float CallsPerSecond) const
+{
+	if (URPCRateLimiter* RPCLimiter = GetWorld()->GetSubsystem<URPCRateLimiter>())
+	{
+		return RPCLimiter->ConsumeToken(this, RPC, CallsPerSecond);
+	}
+
+	return true;
+}
+
+float AWeapon::GetShotsPerSecond() const
+{
+	return Profile->GetShotsPerSecond();
+}
+
+void AWeapon::OnRep_ActionAck()
+{
+	//Everything up to the acknowledged action is already in the servers clip, reapply what's left on top of it
+	PendingActions.RemoveAll([this](const FPendingWeaponAction& Action)
+	{
+		return !IsNewerSequence(Action.Sequence, ActionAck.Sequence);
+	});
+
+	int32 PredictedAmmoInClip = ActionAck.AmmoInClip;
+
+	for (const FPendingWeaponAction& Action : PendingActions)
+	{
+		PredictedAmmoInClip += Action.ClipDelta;
+	}
+
+	CurrentAmmoInClip = FMath::Clamp(PredictedAmmoInClip, 0, Profile->WeaponConfig.AmmoPerClip);
+}
+
+uint16 AWeapon::RecordPredictedAction(const int32 ClipDelta, const bool bReload /*= false*/)
+{
+	FPendingWeaponAction& Action = PendingActions.AddDefaulted_GetRef();
+	Action.Sequence = ++LocalActionSequence;
+	Action.ClipDelta = ClipDelta;
+	Action.bReload = bReload;
+
+	return Action.Sequence;
+}
+
+void AWeapon::AcknowledgeAction(const uint16 Sequence)
+{
+	if (IsNewerSequence(Sequence, ActionAck.Sequence))
+	{
+		ActionAck.Sequence = Sequence;
+	}
+
+	ActionAck.AmmoInClip = CurrentAmmoInClip;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, ActionAck, this);
+}
+
+void AWeapon::OnRep_PawnOwner()
+{
+	BindAmmoLedger();
+}
+
+void AWeapon::RecordFireEvent()
+{
+	PendingFireEventTime = GetWorld()->GetTimeSeconds();
+	PendingFireEventDirection = GetCameraAim();
+
+	//Only remote players get fire events, and the owner simulates its own shots
+	const AController* OwnerController = PawnOwner ? PawnOwner->GetController() : nullptr;
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+
+		if (!PC || PC == OwnerController || PC->IsLocalController() || !IsNetRelevantFor(PC, PC->GetViewTarget(), PC->GetFocalLocation()))
+		{
+			continue;
+		}
+
+		FFireEventObserver* Observer = FireEventObservers.FindByPredicate([PC](const FFireEventObserver& FireEventObserver) { return FireEventObserver.PlayerController == PC; });
+
+		if (!Observer)
+		{
+			Observer = &FireEventObservers.AddDefaulted_GetRef();
+			Observer->PlayerController = PC;
+		}
+
+		Observer->PendingShots = FMath::Min<int32>(Observer->PendingShots + 1, MAX_uint8);
+	}
+
+	FlushFireEvents();
+}
+
+void AWeapon::FlushFireEvents()
+{
+	GetWorldTimerManager().ClearTimer(TimerHandle_FlushFireEvents);
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	float NextFlushDelay = MAX_FLT;
+
+	FWeaponFireEvent FireEvent;
+	FireEvent.Timestamp = PendingFireEventTime;
+	FireEvent.MuzzleDirection = PendingFireEventDirection;
+
+	for (int32 i = FireEventObservers.Num() - 1; i >= 0; --i)
+	{
+		FFireEventObserver& Observer = FireEventObservers[i];
+		APlayerController* PC = Observer.PlayerController.Get();
+
+		//They left the game
+		if (!PC)
+		{
+			FireEventObservers.RemoveAtSwap(i);
+			continue;
+		}
+
+		if (Observer.PendingShots == 0)
+		{
+			continue;
+		}
+
+		const float TimeUntilDue = GetFireEventInterval(PC) - (Now - Observer.LastSendTime);
+
+		if (TimeUntilDue > 0.f)
+		{
+			NextFlushDelay = FMath::Min(NextFlushDelay, TimeUntilDue);
+			continue;
+		}
+
+		if (UWeaponFireEventRelay* Relay = UWeaponFireEventRelay::FindOrAddRelay(PC))
+		{
+			FireEvent.ShotCount = Observer.PendingShots;
+			Relay->ClientFireEvent(this, FireEvent);
+		}
+
+		Observer.PendingShots = 0;
+		Observer.LastSendTime = Now;
+	}
+
+	if (NextFlushDelay < MAX_FLT)
+	{
+		GetWorldTimerManager().SetTimer(TimerHandle_FlushFireEvents, this, &AWeapon::FlushFireEvents, NextFlushDelay, false);
+	}
+}
+
+float AWeapon::GetFireEventInterval(const class APlayerController* Observer) const
+{
+	const float MaxInterval = CVarFireEventMaxInterval.GetValueOnGameThread();
+
+	if (MaxInterval <= 0.f || !Observer)
+	{
+		return 0.f;
+	}
+
+	const float NearDistance = CVarFireEventNearDistance.GetValueOnGameThread();
+	const float FarDistance = FMath::Max(CVarFireEventFarDistance.GetValueOnGameThread(), NearDistance + 1.f);
+	const float Distance = FVector::Dist(Observer->GetFocalLocation(), GetActorLocation());
+
+	return MaxInterval * FMath::Clamp(FMath::GetRangePct(NearDistance, FarDistance, Distance), 0.f, 1.f);
+}
+
+void AWeapon::ReceiveFireEvent(const FWeaponFireEvent& FireEvent)
+{
+	//The server and the owner play these shots as they fire them
+	if (HasAuthority() || (PawnOwner && PawnOwner->IsLocallyControlled()))
+	{
+		return;
+	}
+
+	//Don't play shots that are long over by the time they arrive
+	if (const AGameStateBase* GameState = GetWorld()->GetGameState())
+	{
+		if (GameState->GetServerWorldTimeSeconds() - FireEvent.Timestamp > CVarFireEventMaxAge.GetValueOnGameThread())
+		{
+			return;
+		}
+	}
+
+	RemoteFireDirection = FireEvent.MuzzleDirection;
+	RemoteShotsToSimulate += FireEvent.ShotCount;
+
+	if (!GetWorldTimerManager().IsTimerActive(TimerHandle_SimulateRemoteShot))
+	{
+		SimulateRemoteShot();
+	}
+}
+
+void AWeapon::SimulateRemoteShot()
+{
+	if (RemoteShotsToSimulate > 0)
+	{
+		--RemoteShotsToSimulate;
+		SimulateWeaponFire();
+
+		//Play the batched shots back at the weapons fire rate.  If no more arrive by the time they run out, stop firing
+		GetWorldTimerManager().SetTimer(TimerHandle_SimulateRemoteShot, this, &AWeapon::SimulateRemoteShot, FMath::Max(Profile->WeaponConfig.TimeBetweenShots, 0.05f), false);
+	}
+	else
+	{
+		StopSimulatingWeaponFire();
+	}
+}
+
+void AWeapon::OnRep_Reload()
+{
+	if (bPendingReload)
+	{
+		StartReload(true);
+	}
+	else
+	{
+		StopReload();
+	}
+}
+
+void AWeapon::SimulateWeaponFire()
+{
+	if (HasAuthority() && CurrentState != EWeaponState::Firing)
+	{
+		return;
+	}
+
+	UWeaponFXSubsystem* WeaponFX = GetWorld()->GetSubsystem<UWeaponFXSubsystem>();
+	const bool bLocallyControlled = PawnOwner != nullptr && PawnOwner->IsLocallyControlled();
+
+	//Our own shots always get full FX, other players shots are scaled back if they're far away or off screen
+	const EWeaponFXSignificance Significance = (WeaponFX && !bLocallyControlled) ? WeaponFX->GetShotSignificance(PawnOwner) : EWeaponFXSignificance::WFS_Full;
+
+	if (MuzzleFX)
+	{
+		if (!bLoopedMuzzleFX || MuzzlePSC == nullptr)
+		{
+			//Split screen requires we create 2 effects.  One that we see and one that the other player sees
+			if (bLocallyControlled)
+			{
+				AController* PlayerCon = PawnOwner->GetController();
+				if (PlayerCon != nullptr)
+				{
+					WeaponMesh->GetSocketLocation(MuzzleAttachPoint);
+					MuzzlePSC = UGameplayStatics::SpawnEmitterAttached(MuzzleFX, WeaponMesh, MuzzleAttachPoint);
+					MuzzlePSC->bOwnerNoSee = false;
+					MuzzlePSC->bOnlyOwnerSee = true;
+				}
+			}
+			else if (Significance == EWeaponFXSignificance::WFS_Full)
+			{
+				//One shot muzzle flashes come from the pool, looped ones stay around until we stop firing so they get their own component
+				if (!bLoopedMuzzleFX && WeaponFX)
+				{
+					WeaponFX->SpawnEmitterAttached(MuzzleFX, WeaponMesh, MuzzleAttachPoint);
+				}
+				else
+				{
+					MuzzlePSC = UGameplayStatics::SpawnEmitterAttached(MuzzleFX, WeaponMesh, MuzzleAttachPoint);
+				}
+			}
+		}
+	}
+
+	if (WeaponFX && Significance != EWeaponFXSignificance::WFS_Full)
+	{
+		WeaponFX->RecordCulledShot(MuzzleFX != nullptr, Significance == EWeaponFXSignificance::WFS_Culled);
+	}
+
+	if (!bLoopedFireAnim || bPlayingFireAnim)
+	{
+		FWeaponAnim AnimToPlay = FireAnim; //PawnOwner->IsAiming() || PawnOwner->IsLocallyControlled() ? FireAimingAnim : FireAnim;
+		PlayWeaponAnimation(FireAnim);
+		bPlayingFireAnim = true;
+	}
+
+	if (bLoopedFireSound)
+	{
+		if (FireAC == nullptr)
+		{
+			FireAC = PlayWeaponSound(FireLoopSound);
+		}
+	}
+	else if (Significance != EWeaponFXSignificance::WFS_Culled)
+	{
+		PlayPooledWeaponSound(FireSound);
+	}
+
+	ASurvivalPlayerController* PC = (PawnOwner != nullptr) ? Cast<ASurvivalPlayerController>(PawnOwner->Controller) : nullptr;
+	if (PC != nullptr && PC->IsLocalController())
+	{
+		if (FireCameraShake != nullptr)
+		{
+			PC->ClientPlayCameraShake(FireCameraShake, 1);
+		}
+		if (FireForceFeedback != nullptr)
+		{
+			FForceFeedbackParameters FFParams;
+			FFParams.Tag = "Weapon";
+			PC->ClientPlayForceFeedback(FireForceFeedback, FFParams);
+		}
+	}
+}
+
+void AWeapon::StopSimulatingWeaponFire()
+{
+	if (bLoopedMuzzleFX)
+	{
+		if (MuzzlePSC != nullptr)
+		{
+			MuzzlePSC->DeactivateSystem();
+			MuzzlePSC = nullptr;
+		}
+		if (MuzzlePSCSecondary != nullptr)
+		{
+			MuzzlePSCSecondary->DeactivateSystem();
+			MuzzlePSCSecondary = nullptr;
+		}
+	}
+
+	if (bLoopedFireAnim && bPlayingFireAnim)
+	{
+		StopWeaponAnimation(FireAimingAnim);
+		StopWeaponAnimation(FireAnim);
+		bPlayingFireAnim = false;
+	}
+
+	if (FireAC)
+	{
+		FireAC->FadeOut(0.1f, 0.0f);
+		FireAC = nullptr;
+
+		PlayWeaponSound(FireFinishedSound);
+	}
+}
+
+void AWeapon::HandleHit(const FHitResult& Hit, class ASurvivalCharacter* HitPlayer /*= nullptr*/)
+{
+	if (Hit.GetActor())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Hit actor %s"), *Hit.GetActor()->GetName());
+	}
+
+	//The hit marker is shown once the server confirms the hit did damage, see ClientConfirmHit
+	ServerHandleHit(Hit, HitPlayer, LastShotId);
+}
+
+void AWeapon::ClientConfirmHit_Implementation(const uint16 ShotId, const float ServerProcessingTime)
+{
+	FWeaponLatencyTracer::RecordStage(FWeaponLatencyTracer::MakeTraceId(this, ShotId), EWeaponTraceStage::HitConfirm, ServerProcessingTime);
+
+	if (PawnOwner)
+	{
+		if (ASurvivalPlayerController* PC = Cast<ASurvivalPlayerController>(PawnOwner->GetController()))
+		{
+			PC->OnHitPlayer();
+		}
+	}
+}
+
+void AWeapon::ServerHandleHit_Implementation(const FHitResult& Hit, class ASurvivalCharacter* HitPlayer /*= nullptr*/, const uint16 ShotId /*= 0*/)
+{
+	//Every shot can hit at most once, so hits can't come in faster than shots
+	if (!ConsumeRPCToken(ERateLimitedRPC::RLR_HandleHit, GetShotsPerSecond()))
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_WeaponServerHandleHit);
+
+	FWeaponLatencyTracer::RecordStage(FWeaponLatencyTracer::MakeTraceId(this, ShotId), EWeaponTraceStage::ServerHandleHit);
+
+	if (PawnOwner)
+	{
+		if (HitPlayer && IsValidShotDirection(Hit, ShotId))
+		{
+			//A shot only gets one hit
+			UnvalidatedShotId = 0;
+
+			/* Certain bones like head might give extra damage if hit.  Apply those. */
+			const float DamageMultiplier = Profile->GetBoneDamageMultiplier(HitPlayer->GetMesh(), Hit.BoneName);
+
+			//Queued rather than applied now, so every hit on this player this frame is applied together
+			if (UDamageQueueSubsystem* DamageQueue = GetWorld()->GetSubsystem<UDamageQueueSubsystem>())
+			{
+				DamageQueue->QueueDamage(HitPlayer, Profile->HitScanConfig.Damage * DamageMultiplier, Hit, (Hit.TraceStart - Hit.TraceEnd).GetSafeNormal(), PawnOwner->GetController(), this, Profile->HitScanConfig.DamageType, ShotId);
+			}
+		}
+	}
+}
+
+bool AWeapon::ServerHandleHit_Validate(const FHitResult& Hit, class ASurvivalCharacter* HitPlayer /*= nullptr*/, const uint16 ShotId /*= 0*/)
+{
+	return true;
+}
+
+bool AWeapon::IsValidShotDirection(const FHitResult& Hit, const uint16 ShotId) const
+{
+	AController* OwnerController = PawnOwner ? PawnOwner->GetController() : nullptr;
+
+	if (!OwnerController)
+	{
+		return false;
+	}
+
+	//Our own players shots never went through ServerHandleFiring, and there's nothing to check them against
+	if (OwnerController->IsLocalController())
+	{
+		return true;
+	}
+
+	//The owner sends each hit straight after the shot it came from, so it has to be for the last shot we accepted.  This stops a
+	//client from skipping ahead to the shot ids with the spread it wants, or hitting with a shot the rate limiter dropped
+	if (ShotId == 0 || ShotId != UnvalidatedShotId)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s rejected a hit from shot %d, the shot waiting for a hit was %d"), *GetName(), ShotId, UnvalidatedShotId);
+		return false;
+	}
+
+	//Our view of the owners aim is a little behind theirs.  Wider spread makes a shot less sensitive to where exactly it was aimed,
+	//so it gets more tolerance, but even perfectly accurate weapons get a little
+	const float MaxAngle = FMath::Max(Profile->HitScanConfig.Spread * CVarShotValidationSpreadTolerance.GetValueOnGameThread(), CVarShotValidationMinAngle.GetValueOnGameThread());
+
+	if (MaxAngle <= 0.f)
+	{
+		return true;
+	}
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	OwnerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	const FVector ExpectedDirection = Profile->GetShotDirection(ShotSeed, ShotId, ViewRotation.Vector());
+	const FVector HitDirection = (Hit.TraceEnd - Hit.TraceStart).GetSafeNormal();
+
+	if ((ExpectedDirection | HitDirection) < FMath::Cos(FMath::DegreesToRadians(MaxAngle)))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s rejected a hit from shot %d that didn't match the shots spread"), *GetName(), ShotId);
+		return false;
+	}
+
+	return true;
+}
+
+void AWeapon::FireShot()
+{
+	if (PawnOwner)
+	{
+		if (ASurvivalPlayerController* PC = Cast<ASurvivalPlayerController>(PawnOwner->GetController()))
+		{
+			LastShotId = GetNextShotId();
+			FWeaponLatencyTracer::RecordStage(FWeaponLatencyTracer::MakeTraceId(this, LastShotId), EWeaponTraceStage::FireShot);
+
+			if (Profile->HasRecoil())
+			{
+				const FVector2D RecoilAmount = Profile->GetRecoil(ShotSeed, LastShotId);
+				PC->ApplyRecoil(RecoilAmount, Profile->RecoilSpeed, Profile->RecoilResetSpeed, FireCameraShake);
+			}
+
+			FVector CamLoc;
+			FRotator CamRot;
+			PC->GetPlayerViewPoint(CamLoc, CamRot);
+
+			FHitResult Hit;
+			FCollisionQueryParams QueryParams;
+			QueryParams.AddIgnoredActor(this);
+			QueryParams.AddIgnoredActor(PawnOwner);
+
+			//Spread comes from the shot id, so the server can reproduce it
+			FVector FireDir = Profile->GetShotDirection(ShotSeed, LastShotId, CamRot.Vector());
+			FVector TraceStart = CamLoc;
+			FVector TraceEnd = (FireDir * Profile->HitScanConfig.Distance) + CamLoc;
+
+			if (GetWorld()->LineTraceSingleByChannel(Hit, TraceStart, TraceEnd, COLLISION_WEAPON, QueryParams))
+			{
+				ASurvivalCharacter* HitChar = Cast<ASurvivalCharacter>(Hit.GetActor());
+
+				HandleHit(Hit, HitChar);
+
+				FColor PointColor = FColor::Red;
+				DrawDebugPoint(GetWorld(), Hit.ImpactPoint, 5.f, PointColor, false, 30.f);
+			}
+		}
+	}
+}
+
+void AWeapon::HandleReFiring()
+{
+	UWorld* MyWorld = GetWorld();
+
+	TimerIntervalAdjustment += Profile->GetRefireAdjustment(MyWorld->TimeSeconds - LastFireTime);
+
+	HandleFiring();
+}
+
+void AWeapon::HandleFiring()
+{
+	if ((CurrentAmmoInClip>0) && CanFire())
+	{
+		if (GetNetMode() != NM_DedicatedServer)
+		{
+			SimulateWeaponFire();
+		}
+
+		if (PawnOwner && PawnOwner->IsLocallyControlled())
+		{
+			// local client will notify server of the shot it predicted, before the shots hit so the server has accepted the shot by the time the hit arrives
+			if (GetLocalRole() < ROLE_Authority)
+			{
+				ServerHandleFiring(RecordPredictedAction(-1), GetNextShotId());
+			}
+
+			FireShot();
+			UseClipAmmo();
+
+			// update firing FX on remote clients if function was called on server
+			BurstCounter++;
+
+			if (HasAuthority())
+			{
+				RecordFireEvent();
+			}
+		}
+	}
+	else if (CanReload() && PawnOwner && PawnOwner->IsLocallyControlled())
+	{
+		// the owner decides when to reload, the server follows its ServerStartReload
+		StartReload();
+	}
+	else if (PawnOwner && PawnOwner->IsLocallyControlled())
+	{
+		if (GetCurrentAmmo() == 0 && !bRefiring)
+		{
+			PlayWeaponSound(OutOfAmmoSound);
+			ASurvivalPlayerController* MyPC = Cast<ASurvivalPlayerController>(PawnOwner->Controller);
+		}
+	}
+
+	// stop weapon fire FX, but stay in firing state
+	if (BurstCounter > 0)
+	{
+		OnBurstFinished();
+	}
+
+	if (PawnOwner && PawnOwner->IsLocallyControlled())
+	{
+		// reload after firing last round
+		if (CurrentAmmoInClip <= 0 && CanReload())
+		{
+			StartReload();
+		}
+
+		// setup refire timer
+		bRefiring = (CurrentState == EWeaponState::Firing && Profile->WeaponConfig.TimeBetweenShots > 0.0f);
+		if (bRefiring)
+		{
+			GetWorldTimerManager().SetTimer(TimerHandle_HandleFiring, this, &AWeapon::HandleReFiring, Profile->GetRefireDelay(TimerIntervalAdjustment), false);
+			TimerIntervalAdjustment = 0.f;
+		}
+	}
+
+	LastFireTime = GetWorld()->GetTimeSeconds();
+}
+
+void AWeapon::OnBurstStarted()
+{
+	// start firing, can be delayed to satisfy TimeBetweenShots
+	const float GameTime = GetWorld()->GetTimeSeconds();
+	if (LastFireTime > 0 && Profile->WeaponConfig.TimeBetweenShots > 0.0f && LastFireTime + Profile->WeaponConfig.TimeBetweenShots > GameTime)
+	{
+		GetWorldTimerManager().SetTimer(TimerHandle_HandleFiring, this, &AWeapon::HandleFiring, LastFireTime + Profile->WeaponConfig.TimeBetweenShots - GameTime, false);
+	}
+	else
+	{
+		HandleFiring();
+	}
+}
+
+void AWeapon::OnBurstFinished()
+{
+	// stop firing FX on remote clients
+	BurstCounter = 0;
+
+	// stop firing FX locally, unless it's a dedicated server
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		StopSimulatingWeaponFire();
+	}
+
+	GetWorldTimerManager().ClearTimer(TimerHandle_HandleFiring);
+	bRefiring = false;
+
+	// reset firing interval adjustment
+	TimerIntervalAdjustment = 0.0f;
+}
+
+void AWeapon::SetWeaponState(EWeaponState NewState)
+{
+	const EWeaponState PrevState = CurrentState;
+
+	if (PrevState == EWeaponState::Firing && NewState != EWeaponState::Firing)
+	{
+		OnBurstFinished();
+	}
+
+	CurrentState = NewState;
+
+	if (PrevState != EWeaponState::Firing && NewState == EWeaponState::Firing)
+	{
+		OnBurstStarted();
+	}
+}
+
+void AWeapon::DetermineWeaponState()
+{
+	EWeaponState NewState = EWeaponState::Idle;
+
+	if (bIsEquipped)
+	{
+		if (bPendingReload)
+		{
+			if (CanReload() == false)
+			{
+				NewState = CurrentState;
+			}
+			else
+			{
+				NewState = EWeaponState::Reloading;
+			}
+		}
+		else if ((bPendingReload == false) && (bWantsToFire == true) && (CanFire() == true))
+		{
+			NewState = EWeaponState::Firing;
+		}
+	}
+	else if (bPendingEquip)
+	{
+		NewState = EWeaponState::Equipping;
+	}
+
+	SetWeaponState(NewState);
+}
+
+void AWeapon::AttachMeshToPawn()
+{
+	if (PawnOwner)
+	{
+		if (const USkeletalMeshComponent* PawnMesh = PawnOwner->GetMesh())
+		{
+			const FName AttachSocket = PawnOwner->IsLocallyControlled() ? AttachSocket1P : AttachSocket3P;
+			AttachToComponent(PawnOwner->GetMesh(), FAttachmentTransformRules::SnapToTargetIncludingScale, AttachSocket);
+		}
+	}
+}
+
+UAudioComponent* AWeapon::PlayWeaponSound(USoundCue* Sound)
+{
+	UAudioComponent* AC = nullptr;
+	if (Sound && PawnOwner)
+	{
+		AC = UGameplayStatics::SpawnSoundAttached(Sound, PawnOwner->GetRootComponent());
+	}
+
+	return AC;
+}
+
+void AWeapon::PlayPooledWeaponSound(USoundCue* Sound)
+{
+	if (Sound && PawnOwner)
+	{
+		if (UWeaponFXSubsystem* WeaponFX = GetWorld()->GetSubsystem<UWeaponFXSubsystem>())
+		{
+			WeaponFX->SpawnSoundAttached(Sound, PawnOwner->GetRootComponent());
+		}
+		else
+		{
+			PlayWeaponSound(Sound);
+		}
+	}
+}
+
+float AWeapon::PlayWeaponAnimation(const FWeaponAnim& Animation)
+{
+	float Duration = 0.0f;
+	if (PawnOwner)
+	{
+		UAnimMontage* UseAnim = PawnOwner->IsLocallyControlled() ? Animation.Pawn1P : Animation.Pawn3P;
+		if (UseAnim)
+		{
+			Duration = PawnOwner->PlayAnimMontage(UseAnim);
+		}
+	}
+
+	return Duration;
+}
+
+void AWeapon::StopWeaponAnimation(const FWeaponAnim& Animation)
+{
+	if (PawnOwner)
+	{
+		UAnimMontage* UseAnim = PawnOwner->IsLocallyControlled() ? Animation.Pawn1P : Animation.Pawn3P;
+		if (UseAnim)
+		{
+			PawnOwner->StopAnimMontage(UseAnim);
+		}
+	}
+}
+
+FVector AWeapon::GetCameraAim() const
+{
+	ASurvivalPlayerController* const PlayerController = GetInstigator() ? Cast<ASurvivalPlayerController>(GetInstigator()->Controller) : nullptr;
+	FVector FinalAim = FVector::ZeroVector;
+
+	if (PlayerController)
+	{
+		FVector CamLoc;
+		FRotator CamRot;
+		PlayerController->GetPlayerViewPoint(CamLoc, CamRot);
+		FinalAim = CamRot.Vector();
+	}
+	else if (GetInstigator())
+	{
+		FinalAim = GetInstigator()->GetBaseAimRotation().Vector();
+	}
+
+	return FinalAim;
+}
+
+FHitResult AWeapon::WeaponTrace(const FVector& StartTrace, const FVector& EndTrace) const
+{
+	// Performs trade to retrieve hit info
+	FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(WeaponTrace), true, GetInstigator());
+	TraceParams.bReturnPhysicalMaterial = true;
+
+	FHitResult Hit(ForceInit);
+	GetWorld()->LineTraceSingleByChannel(Hit, StartTrace, EndTrace, COLLISION_WEAPON, TraceParams);
+
+	return Hit;
+}
+
+void AWeapon::ServerHandleFiring_Implementation(const uint16 Sequence, const uint16 ShotId)
+{
+	//Whatever shot was waiting for a hit missed, and this one can only hit if we accept it
+	UnvalidatedShotId = 0;
+
+	//The owner gives every shot it fires the next id, including ones we drop, so it can't pick ids with the spread it wants
+	const bool bExpectedShotId = (ShotId == GetNextShotId());
+	if (!bExpectedShotId)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s got shot %d, expected shot %d"), *GetName(), ShotId, GetNextShotId());
+	}
+	LastShotId = ShotId;
+
+	//Dropped shots aren't acknowledged, the owner gets corrected by the next one we accept
+	if (!ConsumeRPCToken(ERateLimitedRPC::RLR_HandleFiring, GetShotsPerSecond()))
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_WeaponServerHandleFiring);
+
+	const bool bShouldUpdateAmmo = (CurrentAmmoInClip > 0 && CanFire());
+
+	HandleFiring();
+
+	if (bShouldUpdateAmmo)
+	{
+		// update ammo
+		UseClipAmmo();
+
+		// update firing FX on remote clients
+		BurstCounter++;
+		RecordFireEvent();
+
+		if (bExpectedShotId)
+		{
+			UnvalidatedShotId = ShotId;
+		}
+	}
+
+	// tell the owner whether the shot it predicted was accepted
+	AcknowledgeAction(Sequence);
+}
+
+bool AWeapon::ServerHandleFiring_Validate(const uint16 Sequence, const uint16 ShotId)
+{
+	return true;
 }
\ No newline at end of file
@@ -1,472 +1,665 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/Actor.h"
-#include "Weapon.generated.h"
-
-class UAnimMontage;
-class ASurvivalCharacter;
-class UAudioComponent;
-class UParticleSystem;
-class UCameraShake;
-class UForceFeedbackEffect;
-class USoundCue;
-
-UENUM(BlueprintType)
-enum class EWeaponState : uint8
-{
-	Idle,
-	Firing,
-	Reloading,
-	Equipping
-};
-
-USTRUCT(BlueprintType)
-struct FWeaponData
-{
-	GENERATED_USTRUCT_BODY()
-
-	//Magazine size
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Ammo)
-	int32 AmmoPerClip;
-
-	//The item that this weapon uses as ammo
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Ammo)
-	TSubclassOf<class UAmmoItem> AmmoClass;
-
-	//The time between two consecutive shots
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = WeaponStat)
-	float TimeBetweenShots;
-
-	/** defaults **/
-	FWeaponData() 
-	{
-		AmmoPerClip = 20;
-		TimeBetweenShots = 0.2f;
-	}
-};
-
-USTRUCT()
-struct FWeaponAnim
-{
-	GENERATED_USTRUCT_BODY()
-
-	/* animation played on pawn (1st person view) */
-	UPROPERTY(EditDefaultsOnly, Category = Animation)
-	UAnimMontage* Pawn1P;
-
-	/* animation played on pawn (3rd person view) */
-	UPROPERTY(EditDefaultsOnly, Category = Animation)
-	UAnimMontage* Pawn3P;
-};
-
-USTRUCT(BlueprintType)
-struct FHitScanConfiguration
-{
-	GENERATED_BODY()
-
-	FHitScanConfiguration()
-	{
-		Distance = 10000.f;
-		Damage = 25.f;
-		Radius = 0.f;
-		DamageType = UDamageType::StaticClass();
-	}
-
-	/* A map of bone -> damage amount.  If the bone is a child of the given bond, it will use this damage amount.
-	A value of 2 would mean double damage etc. */
-	UPROPERTY(EditDefaultsOnly, Category = "Trace Info")
-	TMap<FName, float> BoneDamageModifiers;
-
-	/* How far the hitscan traces for a hit */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Trace Info")
-	float Distance;
-
-	/* The amount of damage to deal when we hit a player with the hitscan */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Trace Info")
-	float Damage;
-
-	/* Optional trace radius.  A value of zero is just a linetrace, anything higher is a spheretrace */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Trace Info")
-	float Radius;
-
-	/* type of damage */
-	UPROPERTY(EditDefaultsOnly, Category = WeaponStat)
-	TSubclassOf<UDamageType> DamageType;
-
-};
-
-UCLASS()
-class SURVIVALGAME_API AWeapon : public AActor
-{
-	GENERATED_BODY()
-
-	friend class ASurvivalCharacter;
-	
-public:	
-	// Sets default values for this actor's properties
-	AWeapon();
-
-	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
-	virtual void PostInitializeComponents() override;
-	virtual void BeginPlay() override;
-	virtual void Destroyed() override;
-
-protected:
-	/* consume a bullet */
-	void UseClipAmmo();
-
-	/* consume ammo from the inventory */
-	void ConsumeAmmo(const int32 Amount);
-
-	/* [server] return ammo to the inventory when the weapon is unequipped */
-	void ReturnAmmoToInventory();
-
-	/* weapon is being equipped by owner pawn */
-	virtual void OnEquip();
-
-	/* weapon is now equipped by owner pawn */
-	virtual void OnEquipFinished();
-
-	/* weapon is holstered by owner pawn */
-	virtual void OnUnEquip();
-
-	/* check if it's currently equipped */
-	bool IsEquipped() const;
-
-	/* check if mesh is already attached */
-	bool IsAttachedToPawn() const;
-
-	///////////////////////////////////////////////
-	// Input
-
-	/* [local + server] start weapon fire */
-	virtual void StartFire();
-
-	/* [local + server] stop weapon fire */
-	virtual void StopFire();
-
-	/* [all] start weapon reload */
-	virtual void StartReload(bool bFromReplication = false);
-
-	/* [local + server] interrupt weapon reload */
-	virtual void StopReload();
-
-	/* [server] performs actual reload */
-	virtual void ReloadWeapon();
-
-	/* trigger reload from server */
-	UFUNCTION(Reliable, client)
-	void ClientStartReload();
-
-	bool CanFire() const;
-	bool CanReload() const;
-
-	UFUNCTION(BlueprintPure, Category = "Weapon")
-	EWeaponState GetCurrentState() const;
-
-	/* get current ammo amount (total) */
-	UFUNCTION(BlueprintPure, Category = "Weapon")
-	int32 GetCurrentAmmo() const;
-
-	/* get current ammo amount (clip) */
-	UFUNCTION(BlueprintPure, Category = "Weapon")
-	int32 GetCurrentAmmoInClip() const;
-
-	/* get clip size */
-	int32 GetAmmoPerClip() const;
-
-	/* get weapon mesh (needs pawn owner to determine variant) */
-	UFUNCTION(BlueprintPure, Category = "Weapon")
-	USkeletalMeshComponent* GetWeaponMesh() const;
-
-	/* get pawn owner */
-	UFUNCTION(BlueprintCallable, Category = "Weapon")
-	class ASurvivalCharacter* GetPawnOwner() const;
-
-	/* set the weapon's owning pawn */
-	void SetPawnOwner(ASurvivalCharacter* SurvivalCharacter);
-
-	/* gets last time when this weapon was switched to */
-	float GetEquipStartedTime() const;
-
-	/* gets the duration of equipping weapon */
-	float GetEquipDuration() const;
-
-protected:
-	//The weapon item in the players inventory
-	UPROPERTY(Replicated, BlueprintReadOnly, Transient)
-	class UWeaponItem* Item;
-
-	/* pawn owner */
-	UPROPERTY(Transient, ReplicatedUsing = OnRep_PawnOwner)
-	class ASurvivalCharacter* PawnOwner;
-
-	/* weapon data */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Config)
-	FWeaponData WeaponConfig;
-
-	/* Line trace data.  Will be used if projectile class is null */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Config)
-	FHitScanConfiguration HitScanConfig;
-
-public:
-	/* weapon mesh */
-	UPROPERTY(EditAnywhere, Category = Components)
-	USkeletalMeshComponent* WeaponMesh;
-
-protected:
-	/* Adjustment to handle frame rate affecting actual timer interval. */
-	UPROPERTY(Transient)
-	float TimerIntervalAdjustment;
-
-	/* Whether to allow automatic weapons to catch up with shorter refire cycles */
-	UPROPERTY(Config)
-	bool bAllowAutomaticCatchup = true;
-	
-	/* firing audio (bLoopedFireSound set) */
-	UPROPERTY(Transient)
-	UAudioComponent* FireAC;
-
-	/* name of bone/socket for muzzle in weapon mesh */
-	UPROPERTY(EditDefaultsOnly, Category = Effects)
-	FName MuzzleAttachPoint;
-
-	/* Name of the socket to attach to the character on */
-	UPROPERTY(EditDefaultsOnly, Category = Effects)
-	FName AttachSocket1P;
-
-	/* Name of the socket to attach to the character on */
-	UPROPERTY(EditDefaultsOnly, Category = Effects)
-	FName AttachSocket3P;
-	
-	/* FX for muzzle flash */
-	UPROPERTY(EditDefaultsOnly, Category = Effects)
-	UParticleSystem* MuzzleFX;
-
-	/* Spawned component for muzzle FX */
-	UPROPERTY(Transient)
-	UParticleSystemComponent* MuzzlePSC;
-
-	/* Spawned component for second muzzle FX (Needed for split screen) */
-	UPROPERTY(Transient)
-	UParticleSystemComponent* MuzzlePSCSecondary;
-
-	/* Camera shake on firing */
-	UPROPERTY(EditDefaultsOnly, Category = Effects)
-	TSubclassOf<UCameraShake> FireCameraShake;
-
-	//The time it takes to aim down the sights, in seconds
-	UPROPERTY(EditDefaultsOnly, Category = Weapon)
-	float ADSTime;
-
-	/* The amount of recoil to apply.  We choose a random point from 0-1 on the curve and use it to drive recoil.
-	This means designers get lots of control over the recoil pattern. */
-	UPROPERTY(EditDefaultsOnly, Category = Recoil)
-	class UCurveVector* RecoilCurve;
-
-	//The speed at which the recoil bumps up per second
-	UPROPERTY(EditDefaultsOnly, Category = Recoil)
-	float RecoilSpeed;
-
-	//The speed at which the recoil resets per second
-	UPROPERTY(EditDefaultsOnly, Category = Recoil)
-	float RecoilResetSpeed;
-
-	/* force feedback effect to play when the weapon is fired */
-	UPROPERTY(EditDefaultsOnly, Category = Effects)
-	UForceFeedbackEffect* FireForceFeedback;
-
-	/* single fire sound (bLoopedFireSound not set) */
-	UPROPERTY(EditDefaultsOnly, Category = Sound)
-	USoundCue* FireSound;
-
-	/* looped fire sound (bLoopedFireSound set) */
-	UPROPERTY(EditDefaultsOnly, Category = Sound)
-	USoundCue* FireLoopSound;
-
-	/* finished burst sound (bLoopedFiredSound set) */
-	UPROPERTY(EditDefaultsOnly, Category = Sound)
-	USoundCue* FireFinishedSound;
-
-	/* out of ammo sound */
-	UPROPERTY(EditDefaultsOnly, Category = Sound)
-	USoundCue* OutOfAmmoSound;
-
-	/* reload sound */
-	UPROPERTY(EditDefaultsOnly, Category = Sound)
-	USoundCue* ReloadSound;
-
-	/* reload animations */
-	UPROPERTY(EditDefaultsOnly, Category = Animation)
-	FWeaponAnim ReloadAnim;
-
-	/* equip sound */
-	UPROPERTY(EditDefaultsOnly, Category = Sound)
-	USoundCue* EquipSound;
-
-	/* equip animations */
-	UPROPERTY(EditDefaultsOnly, Category = Animation)
-	FWeaponAnim EquipAnim;
-
-	/* fire animations */
-	UPROPERTY(EditDefaultsOnly, Category = Animation)
-	FWeaponAnim FireAnim;
-
-	/* fire animations */
-	UPROPERTY(EditDefaultsOnly, Category = Animation)
-	FWeaponAnim FireAimingAnim;
-
-	/* is muzzle FX looped? */
-	UPROPERTY(EditDefaultsOnly, Category = Effects)
-	uint32 bLoopedMuzzleFX : 1;
-
-	/* is fire sound looped? */
-	UPROPERTY(EditDefaultsOnly, Category = Sound)
-	uint32 bLoopedFireSound: 1;
-
-	/* is fire animation looped */
-	UPROPERTY(EditDefaultsOnly, Category = Animation)
-	uint32 bLoopedFireAnim : 1;
-
-	/* is fire animation playing? */
-	uint32 bPlayingFireAnim : 1;
-
-	/* is weapon currently equipped */
-	uint32 bIsEquipped : 1;
-
-	/* is weapon fire active */
-	uint32 bWantsToFire : 1;
-
-	/* is reload animation playing? */
-	UPROPERTY(Transient, ReplicatedUsing = OnRep_Reload)
-	uint32 bPendingReload : 1;
-
-	/* is equip animation playing */
-	uint32 bPendingEquip : 1;
-
-	/* weapon refiring */
-	uint32 bRefiring;
-
-	/* current weapon state */
-	EWeaponState CurrentState;
-
-	/* time of last successful weapon fire */
-	float LastFireTime;
-
-	/* last time when this weapon was switched to */
-	float EquipStartedTime;
-
-	/* how much time weapon needs to be equipped */
-	float EquipDuration;
-
-	/* current ammo inside the magazine */
-	UPROPERTY(Transient, Replicated)
-	int32 CurrentAmmoInClip;
-
-	/* bust counter, used for replicating fire events to remote clients */
-	UPROPERTY(Transient, ReplicatedUsing = OnRep_BurstCounter)
-	int32 BurstCounter;
-
-	/* Handle for efficient manager of OnEquippedFinished timer */
-	FTimerHandle TimerHandle_OnEquipFinished;
-
-	/* Handle for efficient manager of StopReload timer */
-	FTimerHandle TimerHandle_StopReload;
-
-	/* Handle for efficient management of ReloadWeapon timer */
-	FTimerHandle TimerHandle_ReloadWeapon;
-
-	/* Handle for efficient management of HandleFiring timer */
-	FTimerHandle TimerHandle_HandleFiring;
-
-	////////////////////////////////////////////////////////////
-	// Input - server side
-
-	UFUNCTION(Reliable, Server, WithValidation)
-	void ServerStartFire();
-
-	UFUNCTION(Reliable, Server, WithValidation)
-	void ServerStopFire();
-
-	UFUNCTION(Reliable, Server, WithValidation)
-	void ServerStartReload();
-
-	UFUNCTION(Reliable, Server, WithValidation)
-	void ServerStopReload();
-
-	////////////////////////////////////////////////////////////
-	// Replication & effects
-
-	UFUNCTION()
-	void OnRep_PawnOwner();
-
-	UFUNCTION()
-	void OnRep_BurstCounter();
-
-	UFUNCTION()
-	void OnRep_Reload();
-
-	/* Called in network play to do the cosmetic FX for firing */
-	virtual void SimulateWeaponFire();
-
-	/* Called in network play to stop cosmetic FS (e.g. for a looping shot). */
-	virtual void StopSimulatingWeaponFire();
-
-	///////////////////////////////////////////////////////
-	//// Weapon usage
-
-	/* Hand hit locally before asking server to process hit */
-	void HandleHit(const FHitResult& Hit, class ASurvivalCharacter* HitPlayer = nullptr);
-
-	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerHandleHit(const FHitResult& Hit, class ASurvivalCharacter* HitPlayer = nullptr);
-
-	/* [local] weapon specific fire implementation */
-	virtual void FireShot();
-
-	/* [server] fire & update ammo */
-	UFUNCTION(Reliable, Server, WithValidation)
-	void ServerHandleFiring();
-
-	/* [local + server] handle weapon refire, compensating for slack time if the timer can't sample fast enough  */
-	void HandleReFiring();
-
-	/* [local + server] handle weapon fire */
-	void HandleFiring();
-
-	/* [local + server] firing started */
-	virtual void OnBurstStarted();
-
-	/* [local + server] firing finished */
-	virtual void OnBurstFinished();
-
-	/* updated weapon state */
-	void SetWeaponState(EWeaponState NewState);
-
-	/* determine current weapon state */
-	void DetermineWeaponState();
-
-	/* attaches weapon mesh to pawn's mesh */
-	void AttachMeshToPawn();
-
-	///////////////////////////////////////////////////////
-	//// Weapon usage helpers
-
-	/* play weapon sounds */
-	UAudioComponent* PlayWeaponSound(USoundCue* Sound);
-
-	/* play weapon animations */
-	float PlayWeaponAnimation(const FWeaponAnim& Animation);
-
-	/* stop playing weapon animations */
-	void StopWeaponAnimation(const FWeaponAnim& Animation);
-
-	/* Get the aim of the camera */
-	FVector GetCameraAim() const;
-
-	/* find hit */
-	FHitResult WeaponTrace(const FVector& StartTrace, const FVector& EndTrace) const;
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Weapon.generated.h"
+
+class UAnimMontage;
+class ASurvivalCharacter;
+class UAudioComponent;
+class UParticleSystem;
+class UCameraShake;
+class UForceFeedbackEffect;
+class USoundCue;
+struct FWeaponProfile;
+enum class ERateLimitedRPC : uint8;
+
+UENUM(BlueprintType)
+enum class EWeaponState : uint8
+{
+	Idle,
+	Firing,
+	Reloading,
+	Equipping
+};
+
+USTRUCT(BlueprintType)
+struct FWeaponData
+{
+	GENERATED_USTRUCT_BODY()
+
+	//Magazine size
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Ammo)
+	int32 AmmoPerClip;
+
+	//The item that this weapon uses as ammo
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Ammo)
+	TSubclassOf<class UAmmoItem> AmmoClass;
+
+	//The time between two consecutive shots
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = WeaponStat)
+	float TimeBetweenShots;
+
+	/** defaults **/
+	FWeaponData() 
+	{
+		AmmoPerClip = 20;
+		TimeBetweenShots = 0.2f;
+	}
+};
+
+USTRUCT()
+struct FWeaponAnim
+{
+	GENERATED_USTRUCT_BODY()
+
+	/* animation played on pawn (1st person view) */
+	UPROPERTY(EditDefaultsOnly, Category = Animation)
+	UAnimMontage* Pawn1P;
+
+	/* animation played on pawn (3rd person view) */
+	UPROPERTY(EditDefaultsOnly, Category = Animation)
+	UAnimMontage* Pawn3P;
+};
+
+USTRUCT(BlueprintType)
+struct FHitScanConfiguration
+{
+	GENERATED_BODY()
+
+	FHitScanConfiguration()
+	{
+		Distance = 10000.f;
+		Damage = 25.f;
+		Radius = 0.f;
+		Spread = 0.f;
+		DamageType = UDamageType::StaticClass();
+	}
+
+	/* A map of bone -> damage amount.  If the bone is a child of the given bond, it will use this damage amount.
+	A value of 2 would mean double damage etc. */
+	UPROPERTY(EditDefaultsOnly, Category = "Trace Info")
+	TMap<FName, float> BoneDamageModifiers;
+
+	/* How far the hitscan traces for a hit */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Trace Info")
+	float Distance;
+
+	/* The amount of damage to deal when we hit a player with the hitscan */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Trace Info")
+	float Damage;
+
+	/* Optional trace radius.  A value of zero is just a linetrace, anything higher is a spheretrace */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Trace Info")
+	float Radius;
+
+	/* Half angle of the cone shots are randomly spread in, in degrees */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Trace Info", meta = (ClampMin = 0, ClampMax = 45))
+	float Spread;
+
+	/* type of damage */
+	UPROPERTY(EditDefaultsOnly, Category = WeaponStat)
+	TSubclassOf<UDamageType> DamageType;
+
+};
+
+/* The servers answer to the owning clients predicted fire and reload actions */
+USTRUCT()
+struct FWeaponActionAck
+{
+	GENERATED_BODY()
+
+	/* the newest action the server has processed */
+	UPROPERTY()
+	uint16 Sequence = 0;
+
+	/* the servers clip after processing it */
+	UPROPERTY()
+	int32 AmmoInClip = 0;
+};
+
+/* A batch of shots sent to remote clients so they can play the firing cosmetics */
+USTRUCT()
+struct FWeaponFireEvent
+{
+	GENERATED_BODY()
+
+	/* how many shots were fired since the last event */
+	UPROPERTY()
+	uint8 ShotCount = 0;
+
+	/* server world time of the last shot */
+	UPROPERTY()
+	float Timestamp = 0.f;
+
+	/* the direction the last shot was fired in */
+	UPROPERTY()
+	FVector_NetQuantizeNormal MuzzleDirection;
+};
+
+/* A fire or reload the owning client predicted, waiting for the server to acknowledge it */
+struct FPendingWeaponAction
+{
+	uint16 Sequence = 0;
+
+	/* how much the action changed the clip by on the client */
+	int32 ClipDelta = 0;
+
+	bool bReload = false;
+};
+
+UCLASS()
+class SURVIVALGAME_API AWeapon : public AActor
+{
+	GENERATED_BODY()
+
+	friend class ASurvivalCharacter;
+	friend struct FWeaponProfile;
+	friend class FWeaponFireRateTest;
+	
+public:	
+	// Sets default values for this actor's properties
+	AWeapon();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PostInitializeComponents() override;
+	virtual void BeginPlay() override;
+	virtual void Destroyed() override;
+
+protected:
+	/* consume a bullet */
+	void UseClipAmmo();
+
+	/* [server] take ammo out of the inventory, returning how much we actually got */
+	int32 ConsumeAmmo(const int32 Amount);
+
+	/* start tracking the reserve ammo in our owners inventory */
+	void BindAmmoLedger();
+
+	/* stop tracking our owners inventory */
+	void UnbindAmmoLedger();
+
+	/* count up the reserve ammo from scratch */
+	void RecountReserveAmmo();
+
+	/* keeps the reserve ammo count up to date as our owners inventory changes */
+	void OnInventoryItemQuantityChanged(class UItem* ChangedItem, const int32 QuantityDelta);
+
+	/* [server] return the ammo in the clip to the inventory when the weapon is destroyed */
+	void ReturnAmmoToInventory();
+
+	/* weapon is being equipped by owner pawn */
+	virtual void OnEquip();
+
+	/* weapon is now equipped by owner pawn */
+	virtual void OnEquipFinished();
+
+	/* weapon is holstered by owner pawn */
+	virtual void OnUnEquip();
+
+	/* hide the weapon and let it go dormant while holstered, so it can be kept around for the next time it's equipped */
+	void SetHolstered(const bool bHolstered);
+
+	/* check if it's currently equipped */
+	bool IsEquipped() const;
+
+	/* check if mesh is already attached */
+	bool IsAttachedToPawn() const;
+
+	///////////////////////////////////////////////
+	// Input
+
+	/* [local + server] start weapon fire */
+	virtual void StartFire();
+
+	/* [local + server] stop weapon fire */
+	virtual void StopFire();
+
+	/* [all] start weapon reload */
+	virtual void StartReload(bool bFromReplication = false);
+
+	/* [local + server] interrupt weapon reload */
+	virtual void StopReload();
+
+	/* [server + owning client] performs actual reload.  The owning client predicts the new clip, the server consumes the ammo */
+	virtual void ReloadWeapon();
+
+	/* trigger reload from server */
+	UFUNCTION(Reliable, client)
+	void ClientStartReload();
+
+	bool CanFire() const;
+	bool CanReload() const;
+
+	UFUNCTION(BlueprintPure, Category = "Weapon")
+	EWeaponState GetCurrentState() const;
+
+	/* get current ammo amount (total) */
+	UFUNCTION(BlueprintPure, Category = "Weapon")
+	int32 GetCurrentAmmo() const;
+
+	/* get current ammo amount (clip) */
+	UFUNCTION(BlueprintPure, Category = "Weapon")
+	int32 GetCurrentAmmoInClip() const;
+
+	/* get clip size */
+	int32 GetAmmoPerClip() const;
+
+	/* get weapon mesh (needs pawn owner to determine variant) */
+	UFUNCTION(BlueprintPure, Category = "Weapon")
+	USkeletalMeshComponent* GetWeaponMesh() const;
+
+	/* get pawn owner */
+	UFUNCTION(BlueprintCallable, Category = "Weapon")
+	class ASurvivalCharacter* GetPawnOwner() const;
+
+	/* set the weapon's owning pawn */
+	void SetPawnOwner(ASurvivalCharacter* SurvivalCharacter);
+
+	/* [server] set the weapon item in the players inventory this weapon belongs to */
+	void SetItem(class UWeaponItem* NewItem);
+
+	/* gets last time when this weapon was switched to */
+	float GetEquipStartedTime() const;
+
+	/* gets the duration of equipping weapon */
+	float GetEquipDuration() const;
+
+private:
+	//The weapon item in the players inventory.  Push model replicated, so only ever set it through SetItem
+	UPROPERTY(Replicated, BlueprintReadOnly, Transient, meta = (AllowPrivateAccess = "true"))
+	class UWeaponItem* Item;
+
+protected:
+	/* pawn owner */
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_PawnOwner)
+	class ASurvivalCharacter* PawnOwner;
+
+	/* weapon data */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Config)
+	FWeaponData WeaponConfig;
+
+	/* Line trace data.  Will be used if projectile class is null */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Config)
+	FHitScanConfiguration HitScanConfig;
+
+	/* Tuning compiled from WeaponConfig, HitScanConfig and the recoil settings, shared by every weapon of this class.  Read this instead of the config properties at runtime. */
+	TSharedPtr<const FWeaponProfile> Profile;
+
+public:
+	/* weapon mesh */
+	UPROPERTY(EditAnywhere, Category = Components)
+	USkeletalMeshComponent* WeaponMesh;
+
+protected:
+	/* Adjustment to handle frame rate affecting actual timer interval. */
+	UPROPERTY(Transient)
+	float TimerIntervalAdjustment;
+
+	/* Whether to allow automatic weapons to catch up with shorter refire cycles */
+	UPROPERTY(Config)
+	bool bAllowAutomaticCatchup = true;
+	
+	/* firing audio (bLoopedFireSound set) */
+	UPROPERTY(Transient)
+	UAudioComponent* FireAC;
+
+	/* name of bone/socket for muzzle in weapon mesh */
+	UPROPERTY(EditDefaultsOnly, Category = Effects)
+	FName MuzzleAttachPoint;
+
+	/* Name of the socket to attach to the character on */
+	UPROPERTY(EditDefaultsOnly, Category = Effects)
+	FName AttachSocket1P;
+
+	/* Name of the socket to attach to the character on */
+	UPROPERTY(EditDefaultsOnly, Category = Effects)
+	FName AttachSocket3P;
+	
+	/* FX for muzzle flash */
+	UPROPERTY(EditDefaultsOnly, Category = Effects)
+	UParticleSystem* MuzzleFX;
+
+	/* Spawned component for muzzle FX */
+	UPROPERTY(Transient)
+	UParticleSystemComponent* MuzzlePSC;
+
+	/* Spawned component for second muzzle FX (Needed for split screen) */
+	UPROPERTY(Transient)
+	UParticleSystemComponent* MuzzlePSCSecondary;
+
+	/* Camera shake on firing */
+	UPROPERTY(EditDefaultsOnly, Category = Effects)
+	TSubclassOf<UCameraShake> FireCameraShake;
+
+	//The time it takes to aim down the sights, in seconds
+	UPROPERTY(EditDefaultsOnly, Category = Weapon)
+	float ADSTime;
+
+	/* The amount of recoil to apply.  We choose a random point from 0-1 on the curve and use it to drive recoil.
+	This means designers get lots of control over the recoil pattern. */
+	UPROPERTY(EditDefaultsOnly, Category = Recoil)
+	class UCurveVector* RecoilCurve;
+
+	//The speed at which the recoil bumps up per second
+	UPROPERTY(EditDefaultsOnly, Category = Recoil)
+	float RecoilSpeed;
+
+	//The speed at which the recoil resets per second
+	UPROPERTY(EditDefaultsOnly, Category = Recoil)
+	float RecoilResetSpeed;
+
+	/* force feedback effect to play when the weapon is fired */
+	UPROPERTY(EditDefaultsOnly, Category = Effects)
+	UForceFeedbackEffect* FireForceFeedback;
+
+	/* single fire sound (bLoopedFireSound not set) */
+	UPROPERTY(EditDefaultsOnly, Category = Sound)
+	USoundCue* FireSound;
+
+	/* looped fire sound (bLoopedFireSound set) */
+	UPROPERTY(EditDefaultsOnly, Category = Sound)
+	USoundCue* FireLoopSound;
+
+	/* finished burst sound (bLoopedFiredSound set) */
+	UPROPERTY(EditDefaultsOnly, Category = Sound)
+	USoundCue* FireFinishedSound;
+
+	/* out of ammo sound */
+	UPROPERTY(EditDefaultsOnly, Category = Sound)
+	USoundCue* OutOfAmmoSound;
+
+	/* reload sound */
+	UPROPERTY(EditDefaultsOnly, Category = Sound)
+	USoundCue* ReloadSound;
+
+	/* reload animations */
+	UPROPERTY(EditDefaultsOnly, Category = Animation)
+	FWeaponAnim ReloadAnim;
+
+	/* equip sound */
+	UPROPERTY(EditDefaultsOnly, Category = Sound)
+	USoundCue* EquipSound;
+
+	/* equip animations */
+	UPROPERTY(EditDefaultsOnly, Category = Animation)
+	FWeaponAnim EquipAnim;
+
+	/* fire animations */
+	UPROPERTY(EditDefaultsOnly, Category = Animation)
+	FWeaponAnim FireAnim;
+
+	/* fire animations */
+	UPROPERTY(EditDefaultsOnly, Category = Animation)
+	FWeaponAnim FireAimingAnim;
+
+	/* is muzzle FX looped? */
+	UPROPERTY(EditDefaultsOnly, Category = Effects)
+	uint32 bLoopedMuzzleFX : 1;
+
+	/* is fire sound looped? */
+	UPROPERTY(EditDefaultsOnly, Category = Sound)
+	uint32 bLoopedFireSound: 1;
+
+	/* is fire animation looped */
+	UPROPERTY(EditDefaultsOnly, Category = Animation)
+	uint32 bLoopedFireAnim : 1;
+
+	/* is fire animation playing? */
+	uint32 bPlayingFireAnim : 1;
+
+	/* is weapon currently equipped */
+	uint32 bIsEquipped : 1;
+
+	/* is weapon fire active */
+	uint32 bWantsToFire : 1;
+
+	/* is reload animation playing? */
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_Reload)
+	uint32 bPendingReload : 1;
+
+	/* is equip animation playing */
+	uint32 bPendingEquip : 1;
+
+	/* weapon refiring */
+	uint32 bRefiring;
+
+	/* current weapon state */
+	EWeaponState CurrentState;
+
+	/* time of last successful weapon fire */
+	float LastFireTime;
+
+	/* last time when this weapon was switched to */
+	float EquipStartedTime;
+
+	/* how much time weapon needs to be equipped */
+	float EquipDuration;
+
+	/* ammo for this weapon in our owners inventory, kept up to date by the inventory so we don't need to search it */
+	int32 ReserveAmmo;
+
+	/* the inventory ReserveAmmo is tracking */
+	TWeakObjectPtr<class UInventoryComponent> LedgerInventory;
+
+	/* handle for our binding to LedgerInventory's quantity changes */
+	FDelegateHandle LedgerDelegateHandle;
+
+	/* current ammo inside the magazine.  Predicted on the owning client, which reconciles it with ActionAck */
+	int32 CurrentAmmoInClip;
+
+	/* [server] the last fire/reload action processed and the clip after it, replicated to the owner to reconcile its prediction */
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_ActionAck)
+	FWeaponActionAck ActionAck;
+
+	/* [owning client] the sequence number of our last predicted action */
+	uint16 LocalActionSequence;
+
+	/* [owning client] actions the server hasn't acknowledged yet, oldest first */
+	TArray<FPendingWeaponAction> PendingActions;
+
+	/* [server] the sequence of the reload in progress, acknowledged once the reload completes */
+	uint16 PendingReloadSequence;
+
+	/* seed for this weapons spread and recoil, picked when the weapon is spawned on equip.  Together with a shot id it lets the
+	server reproduce the spread and recoil of any shot */
+	UPROPERTY(Transient, Replicated)
+	int32 ShotSeed;
+
+	/* [local] id of the last shot fired, sent with its hit so the server can reproduce its spread and FWeaponLatencyTracer can follow it.  Never 0.
+	[server] for a remote owner, the id of the last shot it told us about */
+	uint16 LastShotId;
+
+	/* [server] id of the last shot we accepted from the owner, until its hit comes in.  0 if there isn't one */
+	uint16 UnvalidatedShotId;
+
+	/* bust counter, shots fired since the burst started */
+	int32 BurstCounter;
+
+	/* [server] a remote player we send fire events to, with the shots they haven't been sent yet */
+	struct FFireEventObserver
+	{
+		TWeakObjectPtr<class APlayerController> PlayerController;
+		uint8 PendingShots = 0;
+		float LastSendTime = -BIG_NUMBER;
+	};
+
+	/* [server] every remote player that has seen this weapon fire.  Each is batched for separately, based on their own distance */
+	TArray<FFireEventObserver> FireEventObservers;
+
+	/* [server] when and where the last recorded shot was fired */
+	float PendingFireEventTime;
+	FVector PendingFireEventDirection;
+
+	/* [remote clients] shots from fire events we still have to play the cosmetics for */
+	int32 RemoteShotsToSimulate;
+
+	/* [remote clients] the direction of the last shot in the last fire event */
+	FVector RemoteFireDirection;
+
+	/* Handle for sending batched fire events */
+	FTimerHandle TimerHandle_FlushFireEvents;
+
+	/* Handle for playing back shots from fire events */
+	FTimerHandle TimerHandle_SimulateRemoteShot;
+
+	/* Handle for efficient manager of OnEquippedFinished timer */
+	FTimerHandle TimerHandle_OnEquipFinished;
+
+	/* Handle for efficient manager of StopReload timer */
+	FTimerHandle TimerHandle_StopReload;
+
+	/* Handle for efficient management of ReloadWeapon timer */
+	FTimerHandle TimerHandle_ReloadWeapon;
+
+	/* Handle for efficient management of HandleFiring timer */
+	FTimerHandle TimerHandle_HandleFiring;
+
+	////////////////////////////////////////////////////////////
+	// Input - server side
+
+	UFUNCTION(Reliable, Server, WithValidation)
+	void ServerStartFire();
+
+	UFUNCTION(Reliable, Server, WithValidation)
+	void ServerStopFire();
+
+	UFUNCTION(Reliable, Server, WithValidation)
+	void ServerStartReload(const uint16 Sequence);
+
+	UFUNCTION(Reliable, Server, WithValidation)
+	void ServerStopReload();
+
+	////////////////////////////////////////////////////////////
+	// Replication & effects
+
+	UFUNCTION()
+	void OnRep_PawnOwner();
+
+	/* [server] record a shot for the remote players it is relevant to, sent to each now or batched with the next shots depending on
+	how far away they are */
+	void RecordFireEvent();
+
+	/* [server] send every remote player whose batch is due the shots recorded for them since their last fire event, and wait for
+	the next batch that isn't due yet */
+	void FlushFireEvents();
+
+	/* [server] how long shots are batched for a remote player, based on how far they are from us */
+	float GetFireEventInterval(const class APlayerController* Observer) const;
+
+	/* [remote clients] play the cosmetics for the next shot from a fire event, and stop them once there aren't any left */
+	void SimulateRemoteShot();
+
+	UFUNCTION()
+	void OnRep_Reload();
+
+	UFUNCTION()
+	void OnRep_ActionAck();
+
+	/* [owning client] remember an action we predicted, returning the sequence number to send to the server with it */
+	uint16 RecordPredictedAction(const int32 ClipDelta, const bool bReload = false);
+
+	/* [server] acknowledge an action, sending the owner our clip so it can correct its prediction */
+	void AcknowledgeAction(const uint16 Sequence);
+
+	/* [server] take a token from the rate limiter for an RPC from our owner, returns false if the RPC should be dropped */
+	bool ConsumeRPCToken(const ERateLimitedRPC RPC, const float CallsPerSecond) const;
+
+	/* the most shots a second this weapon can fire */
+	float GetShotsPerSecond() const;
+
+	/* is sequence A newer than sequence B, allowing for wrap around */
+	static FORCEINLINE bool IsNewerSequence(const uint16 A, const uint16 B) { return static_cast<int16>(A - B) > 0; }
+
+	/* the id the next shot will get, skipping 0 which means no shot */
+	FORCEINLINE uint16 GetNextShotId() const { return LastShotId == MAX_uint16 ? 1 : LastShotId + 1; }
+
+	/* Called in network play to do the cosmetic FX for firing */
+	virtual void SimulateWeaponFire();
+
+	/* Called in network play to stop cosmetic FS (e.g. for a looping shot). */
+	virtual void StopSimulatingWeaponFire();
+
+public:
+
+	/* The direction remote clients last saw this weapon fire in, e.g. for tracers */
+	FORCEINLINE FVector GetRemoteFireDirection() const { return RemoteFireDirection; }
+
+	/* [remote clients] play the cosmetics for a batch of shots, sent to us through our player controllers fire event relay */
+	void ReceiveFireEvent(const FWeaponFireEvent& FireEvent);
+
+protected:
+
+	///////////////////////////////////////////////////////
+	//// Weapon usage
+
+	/* Hand hit locally before asking server to process hit */
+	void HandleHit(const FHitResult& Hit, class ASurvivalCharacter* HitPlayer = nullptr);
+
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerHandleHit(const FHitResult& Hit, class ASurvivalCharacter* HitPlayer = nullptr, const uint16 ShotId = 0);
+
+	/* [server] is a hit from the shot we're waiting on a hit for, and does its direction match the spread of that shot fired along
+	our view of the owners aim */
+	bool IsValidShotDirection(const FHitResult& Hit, const uint16 ShotId) const;
+
+public:
+
+	/* [owning client] The server applied damage from our shots this frame, show the hit marker.  ShotId is the last shot
+	that did damage, and ServerProcessingTime how long the server took from receiving its hit to confirming it */
+	UFUNCTION(Client, Unreliable)
+	void ClientConfirmHit(const uint16 ShotId, const float ServerProcessingTime);
+
+protected:
+
+	/* [local] weapon specific fire implementation */
+	virtual void FireShot();
+
+	/* [server] fire & update ammo.  ShotId is the id the owner gave the shot, which its hit will be sent with */
+	UFUNCTION(Reliable, Server, WithValidation)
+	void ServerHandleFiring(const uint16 Sequence, const uint16 ShotId);
+
+	/* [local + server] handle weapon refire, compensating for slack time if the timer can't sample fast enough  */
+	void HandleReFiring();
+
+	/* [local + server] handle weapon fire */
+	void HandleFiring();
+
+	/* [local + server] firing started */
+	virtual void OnBurstStarted();
+
+	/* [local + server] firing finished */
+	virtual void OnBurstFinished();
+
+	/* updated weapon state */
+	void SetWeaponState(EWeaponState NewState);
+
+	/* determine current weapon state */
+	void DetermineWeaponState();
+
+	/* attaches weapon mesh to pawn's mesh */
+	void AttachMeshToPawn();
+
+	///////////////////////////////////////////////////////
+	//// Weapon usage helpers
+
+	/* play weapon sounds */
+	UAudioComponent* PlayWeaponSound(USoundCue* Sound);
+
+	/* play a one shot weapon sound using the world's pooled audio components */
+	void PlayPooledWeaponSound(USoundCue* Sound);
+
+	/* play weapon animations */
+	float PlayWeaponAnimation(const FWeaponAnim& Animation);
+
+	/* stop playing weapon animations */
+	void StopWeaponAnimation(const FWeaponAnim& Animation);
+
+	/* Get the aim of the camera */
+	FVector GetCameraAim() const;
+
+	/* find hit */
+	FHitResult WeaponTrace(const FVector& StartTrace, const FVector& EndTrace) const;
+};
@@ -0,0 +1,315 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WeaponFXSubsystem.h"
+#include "../SurvivalGame.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Components/AudioComponent.h"
+#include "Sound/SoundBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/WorldSettings.h"
+#include "Engine/World.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapon FX Particles Active"), STAT_WeaponFXParticlesActive, STATGROUP_SurvivalGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapon FX Particles Pooled"), STAT_WeaponFXParticlesPooled, STATGROUP_SurvivalGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapon FX Audio Active"), STAT_WeaponFXAudioActive, STATGROUP_SurvivalGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapon FX Audio Pooled"), STAT_WeaponFXAudioPooled, STATGROUP_SurvivalGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapon FX Culled Muzzle FX"), STAT_WeaponFXCulledMuzzleFX, STATGROUP_SurvivalGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapon FX Culled Sounds"), STAT_WeaponFXCulledSounds, STATGROUP_SurvivalGame);
+
+static TAutoConsoleVariable<int32> CVarWeaponFXSignificance(
+	TEXT("Weapon.FX.Significance"),
+	1,
+	TEXT("If enabled, shots from distant or off screen players get reduced or no cosmetics."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarWeaponFXMuzzleCullDistance(
+	TEXT("Weapon.FX.MuzzleCullDistance"),
+	5000.f,
+	TEXT("Shots further than this from every local player don't spawn muzzle FX."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarWeaponFXSoundCullDistance(
+	TEXT("Weapon.FX.SoundCullDistance"),
+	15000.f,
+	TEXT("Shots further than this from every local player don't play any sound."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarWeaponFXMaxPoolSize(
+	TEXT("Weapon.FX.MaxPoolSize"),
+	64,
+	TEXT("The maximum number of free particle/audio components kept around for reuse."),
+	ECVF_Default);
+
+static void DumpWeaponFXStats(UWorld* World)
+{
+	if (World)
+	{
+		if (UWeaponFXSubsystem* WeaponFX = World->GetSubsystem<UWeaponFXSubsystem>())
+		{
+			const FWeaponFXPoolStats Stats = WeaponFX->GetPoolStats();
+
+			UE_LOG(LogTemp, Log, TEXT("Weapon FX pool: particles created %d reused %d active %d, audio created %d reused %d active %d, culled muzzle FX %d, culled sounds %d"),
+				Stats.ParticleComponentsCreated, Stats.ParticleComponentsReused, Stats.ParticleComponentsActive,
+				Stats.AudioComponentsCreated, Stats.AudioComponentsReused, Stats.AudioComponentsActive,
+				Stats.MuzzleFXCulled, Stats.SoundsCulled);
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorld DumpWeaponFXStatsCommand(
+	TEXT("Weapon.FX.DumpStats"),
+	TEXT("Logs the weapon FX pool and culling counters."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&DumpWeaponFXStats));
+
+bool UWeaponFXSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	//Dedicated servers never simulate weapon cosmetics
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UWeaponFXSubsystem::Deinitialize()
+{
+	for (UParticleSystemComponent* PSC : FreeParticleComponents)
+	{
+		if (IsValid(PSC))
+		{
+			PSC->DestroyComponent();
+		}
+	}
+
+	for (UParticleSystemComponent* PSC : ActiveParticleComponents)
+	{
+		if (IsValid(PSC))
+		{
+			PSC->DestroyComponent();
+		}
+	}
+
+	for (UAudioComponent* AC : FreeAudioComponents)
+	{
+		if (IsValid(AC))
+		{
+			AC->DestroyComponent();
+		}
+	}
+
+	for (UAudioComponent* AC : ActiveAudioComponents)
+	{
+		if (IsValid(AC))
+		{
+			AC->DestroyComponent();
+		}
+	}
+
+	FreeParticleComponents.Empty();
+	ActiveParticleComponents.Empty();
+	FreeAudioComponents.Empty();
+	ActiveAudioComponents.Empty();
+
+	Super::Deinitialize();
+}
+
+EWeaponFXSignificance UWeaponFXSubsystem::GetShotSignificance(const AActor* Shooter) const
+{
+	UWorld* World = GetWorld();
+
+	if (!Shooter || !World || CVarWeaponFXSignificance.GetValueOnGameThread() == 0)
+	{
+		return EWeaponFXSignificance::WFS_Full;
+	}
+
+	//Find the local player closest to the shot
+	const FVector ShotLocation = Shooter->GetActorLocation();
+	float ClosestDistanceSq = MAX_flt;
+
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+
+		if (PC && PC->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+			ClosestDistanceSq = FMath::Min(ClosestDistanceSq, FVector::DistSquared(ViewLocation, ShotLocation));
+		}
+	}
+
+	if (ClosestDistanceSq > FMath::Square(CVarWeaponFXSoundCullDistance.GetValueOnGameThread()))
+	{
+		return EWeaponFXSignificance::WFS_Culled;
+	}
+
+	//Nobody can see a muzzle flash on a shooter that is miles away or hasn't been rendered recently
+	if (ClosestDistanceSq > FMath::Square(CVarWeaponFXMuzzleCullDistance.GetValueOnGameThread()) || !Shooter->WasRecentlyRendered(0.2f))
+	{
+		return EWeaponFXSignificance::WFS_Reduced;
+	}
+
+	return EWeaponFXSignificance::WFS_Full;
+}
+
+UParticleSystemComponent* UWeaponFXSubsystem::SpawnEmitterAttached(UParticleSystem* EmitterTemplate, USceneComponent* AttachToComponent, const FName AttachPointName /*= NAME_None*/)
+{
+	UWorld* World = GetWorld();
+
+	if (!EmitterTemplate || !AttachToComponent || !World)
+	{
+		return nullptr;
+	}
+
+	UParticleSystemComponent* PSC = nullptr;
+
+	while (!PSC && FreeParticleComponents.Num())
+	{
+		PSC = FreeParticleComponents.Pop(false);
+
+		if (!IsValid(PSC))
+		{
+			PSC = nullptr;
+		}
+	}
+
+	if (PSC)
+	{
+		++Stats.ParticleComponentsReused;
+	}
+	else
+	{
+		PSC = NewObject<UParticleSystemComponent>(World->GetWorldSettings());
+		PSC->bAutoDestroy = false;
+		PSC->bAutoActivate = false;
+		PSC->bAllowRecycling = true;
+		PSC->SecondsBeforeInactive = 0.f;
+		PSC->OnSystemFinished.AddUniqueDynamic(this, &UWeaponFXSubsystem::OnParticleComponentFinished);
+		PSC->RegisterComponentWithWorld(World);
+
+		++Stats.ParticleComponentsCreated;
+	}
+
+	PSC->SetTemplate(EmitterTemplate);
+	PSC->AttachToComponent(AttachToComponent, FAttachmentTransformRules::SnapToTargetIncludingScale, AttachPointName);
+	PSC->ActivateSystem(true);
+
+	ActiveParticleComponents.Add(PSC);
+	Stats.ParticleComponentsActive = ActiveParticleComponents.Num();
+
+	INC_DWORD_STAT(STAT_WeaponFXParticlesActive);
+	SET_DWORD_STAT(STAT_WeaponFXParticlesPooled, FreeParticleComponents.Num());
+
+	return PSC;
+}
+
+UAudioComponent* UWeaponFXSubsystem::SpawnSoundAttached(USoundBase* Sound, USceneComponent* AttachToComponent)
+{
+	UWorld* World = GetWorld();
+
+	if (!Sound || !AttachToComponent || !World)
+	{
+		return nullptr;
+	}
+
+	UAudioComponent* AC = nullptr;
+
+	while (!AC && FreeAudioComponents.Num())
+	{
+		AC = FreeAudioComponents.Pop(false);
+
+		if (!IsValid(AC))
+		{
+			AC = nullptr;
+		}
+	}
+
+	if (AC)
+	{
+		++Stats.AudioComponentsReused;
+	}
+	else
+	{
+		AC = NewObject<UAudioComponent>(World->GetWorldSettings());
+		AC->bAutoDestroy = false;
+		AC->bAutoActivate = false;
+		AC->bStopWhenOwnerDestroyed = false;
+		AC->OnAudioFinishedNative.AddUObject(this, &UWeaponFXSubsystem::OnAudioComponentFinished);
+		AC->RegisterComponentWithWorld(World);
+
+		++Stats.AudioComponentsCreated;
+	}
+
+	AC->SetSound(Sound);
+	AC->AttachToComponent(AttachToComponent, FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+	AC->Play();
+
+	ActiveAudioComponents.Add(AC);
+	Stats.AudioComponentsActive = ActiveAudioComponents.Num();
+
+	INC_DWORD_STAT(STAT_WeaponFXAudioActive);
+	SET_DWORD_STAT(STAT_WeaponFXAudioPooled, FreeAudioComponents.Num());
+
+	return AC;
+}
+
+void UWeaponFXSubsystem::RecordCulledShot(const bool bCulledMuzzleFX, const bool bCulledSound)
+{
+	if (bCulledMuzzleFX)
+	{
+		++Stats.MuzzleFXCulled;
+		INC_DWORD_STAT(STAT_WeaponFXCulledMuzzleFX);
+	}
+
+	if (bCulledSound)
+	{
+		++Stats.SoundsCulled;
+		INC_DWORD_STAT(STAT_WeaponFXCulledSounds);
+	}
+}
+
+FWeaponFXPoolStats UWeaponFXSubsystem::GetPoolStats() const
+{
+	return Stats;
+}
+
+void UWeaponFXSubsystem::OnParticleComponentFinished(UParticleSystemComponent* PSC)
+{
+	if (ActiveParticleComponents.RemoveSwap(PSC) > 0)
+	{
+		DEC_DWORD_STAT(STAT_WeaponFXParticlesActive);
+		Stats.ParticleComponentsActive = ActiveParticleComponents.Num();
+
+		if (FreeParticleComponents.Num() < CVarWeaponFXMaxPoolSize.GetValueOnGameThread())
+		{
+			PSC->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+			FreeParticleComponents.Add(PSC);
+		}
+		else
+		{
+			PSC->DestroyComponent();
+		}
+
+		SET_DWORD_STAT(STAT_WeaponFXParticlesPooled, FreeParticleComponents.Num());
+	}
+}
+
+void UWeaponFXSubsystem::OnAudioComponentFinished(UAudioComponent* AC)
+{
+	if (ActiveAudioComponents.RemoveSwap(AC) > 0)
+	{
+		DEC_DWORD_STAT(STAT_WeaponFXAudioActive);
+		Stats.AudioComponentsActive = ActiveAudioComponents.Num();
+
+		if (FreeAudioComponents.Num() < CVarWeaponFXMaxPoolSize.GetValueOnGameThread())
+		{
+			AC->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+			FreeAudioComponents.Add(AC);
+		}
+		else
+		{
+			AC->DestroyComponent();
+		}
+
+		SET_DWORD_STAT(STAT_WeaponFXAudioPooled, FreeAudioComponents.Num());
+	}
+}
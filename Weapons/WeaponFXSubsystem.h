@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WeaponFXSubsystem.generated.h"
+
+class UParticleSystem;
+class UParticleSystemComponent;
+class UAudioComponent;
+class USoundBase;
+
+//How much of a shot's cosmetics the local players should get
+UENUM(BlueprintType)
+enum class EWeaponFXSignificance : uint8
+{
+	WFS_Full UMETA(DisplayName = "Full"),
+	WFS_Reduced UMETA(DisplayName = "Reduced"),
+	WFS_Culled UMETA(DisplayName = "Culled")
+};
+
+//Counters for the weapon FX pool, so we can see how much reuse and culling is going on
+USTRUCT(BlueprintType)
+struct FWeaponFXPoolStats
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintReadOnly, Category = "Weapon FX")
+	int32 ParticleComponentsCreated = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Weapon FX")
+	int32 ParticleComponentsReused = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Weapon FX")
+	int32 ParticleComponentsActive = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Weapon FX")
+	int32 AudioComponentsCreated = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Weapon FX")
+	int32 AudioComponentsReused = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Weapon FX")
+	int32 AudioComponentsActive = 0;
+
+	//Shots that were far away or off screen, so didn't get a muzzle flash
+	UPROPERTY(BlueprintReadOnly, Category = "Weapon FX")
+	int32 MuzzleFXCulled = 0;
+
+	//Shots that were too far away to be heard, so didn't get a sound
+	UPROPERTY(BlueprintReadOnly, Category = "Weapon FX")
+	int32 SoundsCulled = 0;
+};
+
+/**
+ * Per-world pool of the short lived particle and audio components spawned by weapons when they fire.
+ * Also decides how significant a shot is to the local players, so distant or off screen shots can skip their FX.
+ */
+UCLASS()
+class SURVIVALGAME_API UWeaponFXSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/* Work out how much of a shot fired by Shooter the local players should see and hear */
+	EWeaponFXSignificance GetShotSignificance(const AActor* Shooter) const;
+
+	/* Play a one shot emitter using a pooled component.  The component goes back to the pool once the system finishes, so don't hold onto it */
+	UParticleSystemComponent* SpawnEmitterAttached(UParticleSystem* EmitterTemplate, USceneComponent* AttachToComponent, const FName AttachPointName = NAME_None);
+
+	/* Play a one shot sound using a pooled component.  The component goes back to the pool once the sound finishes, so don't hold onto it */
+	UAudioComponent* SpawnSoundAttached(USoundBase* Sound, USceneComponent* AttachToComponent);
+
+	/* Note that a shot skipped some of its cosmetics */
+	void RecordCulledShot(const bool bCulledMuzzleFX, const bool bCulledSound);
+
+	UFUNCTION(BlueprintPure, Category = "Weapon FX")
+	FWeaponFXPoolStats GetPoolStats() const;
+
+protected:
+
+	UFUNCTION()
+	void OnParticleComponentFinished(UParticleSystemComponent* PSC);
+
+	void OnAudioComponentFinished(UAudioComponent* AC);
+
+	UPROPERTY(Transient)
+	TArray<UParticleSystemComponent*> FreeParticleComponents;
+
+	UPROPERTY(Transient)
+	TArray<UParticleSystemComponent*> ActiveParticleComponents;
+
+	UPROPERTY(Transient)
+	TArray<UAudioComponent*> FreeAudioComponents;
+
+	UPROPERTY(Transient)
+	TArray<UAudioComponent*> ActiveAudioComponents;
+
+	FWeaponFXPoolStats Stats;
+};
@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WeaponFireEventRelay.h"
+#include "GameFramework/PlayerController.h"
+
+UWeaponFireEventRelay::UWeaponFireEventRelay()
+{
+	SetIsReplicatedByDefault(true);
+}
+
+UWeaponFireEventRelay* UWeaponFireEventRelay::FindOrAddRelay(class APlayerController* PlayerController)
+{
+	if (!PlayerController || !PlayerController->HasAuthority())
+	{
+		return nullptr;
+	}
+
+	if (UWeaponFireEventRelay* Relay = PlayerController->FindComponentByClass<UWeaponFireEventRelay>())
+	{
+		return Relay;
+	}
+
+	//Replicates to the owning client as a subobject of the controller, so our client RPCs have somewhere to arrive
+	UWeaponFireEventRelay* Relay = NewObject<UWeaponFireEventRelay>(PlayerController, TEXT("WeaponFireEventRelay"));
+	Relay->RegisterComponent();
+	return Relay;
+}
+
+void UWeaponFireEventRelay::ClientFireEvent_Implementation(class AWeapon* Weapon, const FWeaponFireEvent& FireEvent)
+{
+	//The weapon isn't relevant to us (anymore), so there's nothing to play the shots on
+	if (Weapon)
+	{
+		Weapon->ReceiveFireEvent(FireEvent);
+	}
+}
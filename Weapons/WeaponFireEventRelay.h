@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Weapon.h"
+#include "WeaponFireEventRelay.generated.h"
+
+/**
+ * Sends weapon fire events to one player.  Client RPCs only reach the connection that owns the actor, so the server adds one of
+ * these to every remote player controller the first time a weapon fires near it.  That lets each weapon batch its shots
+ * per player, sending every shot to the players close by and fewer, larger batches to the players far away.
+ */
+UCLASS()
+class SURVIVALGAME_API UWeaponFireEventRelay : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UWeaponFireEventRelay();
+
+	/* [server] Get the relay on a player controller, adding it if it doesn't have one yet */
+	static UWeaponFireEventRelay* FindOrAddRelay(class APlayerController* PlayerController);
+
+	/* Remote fire cosmetics for a weapon.  Unreliable, so it's dropped when the connection is saturated */
+	UFUNCTION(Client, Unreliable)
+	void ClientFireEvent(class AWeapon* Weapon, const FWeaponFireEvent& FireEvent);
+};
@@ -0,0 +1,302 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "AssetRegistryModule.h"
+#include "Engine/Blueprint.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/PackageName.h"
+#include "UObject/UObjectIterator.h"
+#include "../Player/SurvivalCharacter.h"
+#include "../Player/SurvivalPlayerController.h"
+#include "RPCRateLimiter.h"
+#include "Weapon.h"
+#include "WeaponProfile.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace WeaponFireRateTest
+{
+	//How many seconds each weapon fires for
+	static const float Duration = 10.f;
+
+	//The tick rate of the simulated server
+	static const float ServerTickRate = 30.f;
+
+	//The most extra latency a shot can get, as a fraction of the one way latency
+	static const float MaxJitter = 0.2f;
+
+	//A run fails if the client fire rate is off by more than this fraction
+	static const float MaxRateError = 0.02f;
+
+	//How many shots HandleFiring is timed over
+	static const int32 NumTimedShots = 1000;
+
+	//The budget for one HandleFiring call.  Far above what a shot costs in an empty world, so this only trips when the fire path
+	//has become a lot more expensive, i.e. something started allocating or tracing per shot
+	static const double MaxHandleFiringMicroseconds = 100.0;
+
+	static const float FrameRates[] = { 20.f, 30.f, 60.f, 120.f, 144.f, 240.f };
+	static const float Latencies[] = { 0.f, 0.05f, 0.1f, 0.2f };
+
+	/* Load every weapon Blueprint, so the class iterator sees the weapons that aren't loaded yet as well */
+	static void LoadWeaponBlueprints()
+	{
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+		AssetRegistry.SearchAllAssets(true);
+
+		TSet<FName> WeaponClassNames;
+		AssetRegistry.GetDerivedClassNames({ AWeapon::StaticClass()->GetFName() }, TSet<FName>(), WeaponClassNames);
+
+		FARFilter Filter;
+		Filter.ClassNames.Add(UBlueprint::StaticClass()->GetFName());
+		Filter.bRecursiveClasses = true;
+
+		TArray<FAssetData> Blueprints;
+		AssetRegistry.GetAssets(Filter, Blueprints);
+
+		for (const FAssetData& Blueprint : Blueprints)
+		{
+			FString GeneratedClassPath;
+
+			if (!Blueprint.GetTagValue(FBlueprintTags::GeneratedClassPath, GeneratedClassPath))
+			{
+				continue;
+			}
+
+			const FString ClassObjectPath = FPackageName::ExportTextPathToObjectPath(GeneratedClassPath);
+
+			if (WeaponClassNames.Contains(FName(*FPackageName::ObjectPathToObjectName(ClassObjectPath))))
+			{
+				LoadObject<UClass>(nullptr, *ClassObjectPath);
+			}
+		}
+	}
+
+	/* A standalone game world to fire weapons in, torn down when it goes out of scope */
+	struct FTestWorld
+	{
+		UWorld* World;
+
+		FTestWorld()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("WeaponFireRateTest"));
+			GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(World);
+			World->InitializeActorsForPlay(FURL());
+			World->BeginPlay();
+		}
+
+		~FTestWorld()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+	};
+
+	/* How many of the clients shots the servers rate limiter lets through, given when they were sent */
+	static int32 SimulateServerShots(const FWeaponProfile& Profile, const TArray<float>& ShotTimes, const float Latency)
+	{
+		const float ServerTickTime = 1.f / ServerTickRate;
+		const float OneWayLatency = Latency * 0.5f;
+
+		//Seeded so every run sees the same jitter
+		FRandomStream Jitter(1);
+
+		URPCRateLimiter::FRPCBucket Bucket;
+		float LastProcessTime = 0.f;
+		int32 AcceptedShots = 0;
+
+		for (const float ShotTime : ShotTimes)
+		{
+			const float ArrivalTime = ShotTime + OneWayLatency + Jitter.FRandRange(0.f, MaxJitter * OneWayLatency);
+
+			//Packets are read at the start of a server frame, and reliable RPCs run in the order they were sent
+			const float ProcessTime = FMath::Max(FMath::CeilToFloat(ArrivalTime / ServerTickTime) * ServerTickTime, LastProcessTime);
+			LastProcessTime = ProcessTime;
+
+			//The same bucket and rate AWeapon::ServerHandleFiring() takes its token with
+			if (URPCRateLimiter::ConsumeBucketToken(Bucket, ProcessTime, Profile.GetShotsPerSecond()))
+			{
+				++AcceptedShots;
+			}
+		}
+
+		return AcceptedShots;
+	}
+}
+
+/**
+ * Loads every weapon Blueprint, and fires each weapon class through its real fire path (StartFire, DetermineWeaponState,
+ * OnBurstStarted, HandleFiring and its refire timer) in a standalone world ticked at a range of frame rates.  Fails if:
+ * - a weapons fire rate depends on the frame rate
+ * - the server would drop any of its shots at a range of latencies, which desyncs the clients ammo
+ * - releasing and pulling the trigger again lets a weapon fire sooner than TimeBetweenShots
+ * - a HandleFiring call takes longer than MaxHandleFiringMicroseconds
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWeaponFireRateTest, "SurvivalGame.Weapon.FireRate", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FWeaponFireRateTest::RunTest(const FString& Parameters)
+{
+	using namespace WeaponFireRateTest;
+
+	LoadWeaponBlueprints();
+
+	FTestWorld TestWorld;
+	UWorld* World = TestWorld.World;
+
+	//HandleFiring only fires for a locally controlled owner
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	ASurvivalCharacter* Character = World->SpawnActor<ASurvivalCharacter>(ASurvivalCharacter::StaticClass(), FTransform::Identity, SpawnParams);
+	ASurvivalPlayerController* PC = World->SpawnActor<ASurvivalPlayerController>(ASurvivalPlayerController::StaticClass(), FTransform::Identity, SpawnParams);
+
+	if (!TestNotNull(TEXT("Test character"), Character) || !TestNotNull(TEXT("Test player controller"), PC))
+	{
+		return false;
+	}
+
+	PC->Possess(Character);
+
+	SpawnParams.Owner = Character;
+	SpawnParams.Instigator = Character;
+
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* WeaponClass = *It;
+
+		if (!WeaponClass->IsChildOf(AWeapon::StaticClass()) || WeaponClass->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated | CLASS_NewerVersionExists)
+			|| WeaponClass->GetName().StartsWith(TEXT("SKEL_")) || WeaponClass->GetName().StartsWith(TEXT("REINST_")))
+		{
+			continue;
+		}
+
+		for (const float FrameRate : FrameRates)
+		{
+			const float FrameTime = 1.f / FrameRate;
+			const FString FrameRateName = FString::Printf(TEXT("%s at %.0f fps"), *WeaponClass->GetName(), FrameRate);
+
+			AWeapon* Weapon = World->SpawnActor<AWeapon>(WeaponClass, FTransform::Identity, SpawnParams);
+
+			if (!TestNotNull(FrameRateName + TEXT(", spawned weapon"), Weapon))
+			{
+				continue;
+			}
+
+			const FWeaponProfile& Profile = *Weapon->Profile;
+			const float TimeBetweenShots = Profile.WeaponConfig.TimeBetweenShots;
+
+			//Enough ammo that the clip never runs out, so the weapon never stops to reload
+			const int32 StartingAmmo = FMath::CeilToInt((Duration + 1.f) * FrameRate) + NumTimedShots;
+			Weapon->CurrentAmmoInClip = StartingAmmo;
+			Weapon->OnEquip();
+
+			TestTrue(FrameRateName + TEXT(", equipped"), Weapon->IsEquipped());
+
+			//StartFire -> DetermineWeaponState -> SetWeaponState -> OnBurstStarted -> HandleFiring, then the refire timer
+			Weapon->StartFire();
+			TestTrue(FrameRateName + TEXT(", firing after StartFire"), Weapon->GetCurrentState() == EWeaponState::Firing);
+
+			TArray<float> ShotTimes;
+			int32 AmmoInClip = StartingAmmo;
+			const float StartTime = World->GetTimeSeconds();
+
+			while (true)
+			{
+				//Timers run at the end of the frame, so a shot fired during a frame was fired at its time
+				for (; AmmoInClip > Weapon->CurrentAmmoInClip; --AmmoInClip)
+				{
+					ShotTimes.Add(World->GetTimeSeconds());
+				}
+
+				if (World->GetTimeSeconds() > StartTime + Duration)
+				{
+					break;
+				}
+
+				World->Tick(LEVELTICK_All, FrameTime);
+			}
+
+			Weapon->StopFire();
+			TestTrue(FrameRateName + TEXT(", idle after StopFire"), Weapon->GetCurrentState() == EWeaponState::Idle);
+
+			if (!TestTrue(FrameRateName + TEXT(", fired"), ShotTimes.Num() > 0))
+			{
+				Weapon->CurrentAmmoInClip = 0;
+				Weapon->Destroy();
+				continue;
+			}
+
+			for (const float Latency : Latencies)
+			{
+				const FString RunName = FString::Printf(TEXT("%s and %.0f ms"), *FrameRateName, Latency * 1000.f);
+				TestEqual(RunName + TEXT(", shots accepted by the server"), SimulateServerShots(Profile, ShotTimes, Latency), ShotTimes.Num());
+			}
+
+			//Weapons that fire faster than the frame rate can't keep up by design, so only their ammo is checked
+			if (TimeBetweenShots > 0.f && TimeBetweenShots >= FrameTime && ShotTimes.Num() >= 2)
+			{
+				const float ClientShotsPerSecond = (ShotTimes.Num() - 1) / (ShotTimes.Last() - ShotTimes[0]);
+				const float FireRateError = FMath::Abs(ClientShotsPerSecond * TimeBetweenShots - 1.f);
+
+				if (FireRateError > MaxRateError)
+				{
+					AddError(FString::Printf(TEXT("%s fired %.2f shots/s, expected %.2f"), *FrameRateName, ClientShotsPerSecond, 1.f / TimeBetweenShots));
+				}
+			}
+
+			//Pulling the trigger again straight away has to wait out TimeBetweenShots, which OnBurstStarted delays the first shot for
+			if (TimeBetweenShots > FrameTime)
+			{
+				const float LastShotTime = ShotTimes.Last();
+				AmmoInClip = Weapon->CurrentAmmoInClip;
+				Weapon->StartFire();
+
+				while (Weapon->CurrentAmmoInClip == AmmoInClip && World->GetTimeSeconds() < LastShotTime + TimeBetweenShots * 2.f)
+				{
+					World->Tick(LEVELTICK_All, FrameTime);
+				}
+
+				TestTrue(FrameRateName + TEXT(", refired after pulling the trigger again"), Weapon->CurrentAmmoInClip < AmmoInClip);
+				TestTrue(FrameRateName + TEXT(", waited out TimeBetweenShots after pulling the trigger again"), World->GetTimeSeconds() >= LastShotTime + TimeBetweenShots - KINDA_SMALL_NUMBER);
+
+				Weapon->StopFire();
+			}
+
+			//Time the fire path itself, once per weapon class
+			if (FrameRate == FrameRates[0])
+			{
+				Weapon->StartFire();
+
+				const double TimingStartTime = FPlatformTime::Seconds();
+
+				for (int32 i = 0; i < NumTimedShots; ++i)
+				{
+					Weapon->HandleFiring();
+				}
+
+				const double MicrosecondsPerShot = (FPlatformTime::Seconds() - TimingStartTime) * 1000000.0 / NumTimedShots;
+
+				Weapon->StopFire();
+
+				AddInfo(FString::Printf(TEXT("%s HandleFiring took %.2f us a shot (budget %.2f us)"), *WeaponClass->GetName(), MicrosecondsPerShot, MaxHandleFiringMicroseconds));
+
+				if (MicrosecondsPerShot > MaxHandleFiringMicroseconds)
+				{
+					AddError(FString::Printf(TEXT("%s HandleFiring took %.2f us a shot, over the %.2f us budget"), *WeaponClass->GetName(), MicrosecondsPerShot, MaxHandleFiringMicroseconds));
+				}
+			}
+
+			//Don't hand the test ammo to the characters inventory
+			Weapon->CurrentAmmoInClip = 0;
+			Weapon->Destroy();
+		}
+	}
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
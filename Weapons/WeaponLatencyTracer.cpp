@@ -0,0 +1,275 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WeaponLatencyTracer.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+#include "Trace/Trace.inl"
+
+static TAutoConsoleVariable<int32> CVarWeaponLatencyTraceEnabled(
+	TEXT("Weapon.LatencyTrace.Enabled"),
+	0,
+	TEXT("If enabled, every shot is timestamped from the trigger being pulled to the hit being confirmed."),
+	ECVF_Default);
+
+static FAutoConsoleCommand DumpWeaponLatencyCommand(
+	TEXT("Weapon.LatencyTrace.Dump"),
+	TEXT("Logs histograms of where the latency of recently traced shots went."),
+	FConsoleCommandDelegate::CreateStatic(&FWeaponLatencyTracer::DumpHistograms));
+
+static FAutoConsoleCommand ResetWeaponLatencyCommand(
+	TEXT("Weapon.LatencyTrace.Reset"),
+	TEXT("Forgets every traced shot."),
+	FConsoleCommandDelegate::CreateStatic(&FWeaponLatencyTracer::Reset));
+
+#if UE_TRACE_ENABLED
+UE_TRACE_CHANNEL(WeaponLatencyChannel)
+
+UE_TRACE_EVENT_BEGIN(WeaponLatency, ShotStage)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, TraceId)
+	UE_TRACE_EVENT_FIELD(uint8, Stage)
+	UE_TRACE_EVENT_FIELD(float, ServerTime)
+UE_TRACE_EVENT_END()
+#endif
+
+namespace WeaponLatencyTracer
+{
+	struct FTraceEvent
+	{
+		double Time;
+		uint32 TraceId;
+		float ServerTime;
+		EWeaponTraceStage Stage;
+	};
+
+	//Only ever written by the thread that owns it, so writing needs no lock.  Once full, the oldest events are overwritten
+	struct FThreadBuffer
+	{
+		static constexpr uint32 Capacity = 4096;
+
+		FTraceEvent Events[Capacity];
+
+		//Events written since the buffer was created, published after the event itself is written
+		TAtomic<uint32> NumWritten { 0 };
+
+		//Events before this have been reset.  Only used by the reader
+		uint32 FirstUnread = 0;
+	};
+
+	//Every threads buffer.  Buffers live until shutdown, so the reader never sees one go away
+	static FCriticalSection BuffersLock;
+	static TArray<TUniquePtr<FThreadBuffer>> Buffers;
+
+	static thread_local FThreadBuffer* ThreadBuffer = nullptr;
+
+	static FThreadBuffer& GetThreadBuffer()
+	{
+		if (!ThreadBuffer)
+		{
+			FScopeLock Lock(&BuffersLock);
+			ThreadBuffer = Buffers.Add_GetRef(MakeUnique<FThreadBuffer>()).Get();
+		}
+
+		return *ThreadBuffer;
+	}
+
+	//Power of two buckets, in milliseconds
+	struct FHistogram
+	{
+		static constexpr int32 NumBuckets = 12;
+
+		int32 Buckets[NumBuckets] = {};
+		int32 Count = 0;
+		double Total = 0.0;
+		double Max = 0.0;
+
+		void Add(const double Seconds)
+		{
+			const double Milliseconds = FMath::Max(Seconds * 1000.0, 0.0);
+			const int32 Bucket = Milliseconds < 1.0 ? 0 : FMath::Min(FMath::FloorToInt(FMath::Log2(Milliseconds)) + 1, NumBuckets - 1);
+
+			++Buckets[Bucket];
+			++Count;
+			Total += Milliseconds;
+			Max = FMath::Max(Max, Milliseconds);
+		}
+
+		//The upper bound of the bucket the given fraction of samples falls in
+		double GetPercentile(const float Fraction) const
+		{
+			const int32 Target = FMath::CeilToInt(Count * Fraction);
+			int32 Seen = 0;
+
+			for (int32 i = 0; i < NumBuckets - 1; ++i)
+			{
+				Seen += Buckets[i];
+
+				if (Seen >= Target)
+				{
+					return (double)(1 << i);
+				}
+			}
+
+			return Max;
+		}
+
+		void Log(const TCHAR* Name) const
+		{
+			if (!Count)
+			{
+				UE_LOG(LogTemp, Log, TEXT("%s: no samples"), Name);
+				return;
+			}
+
+			FString BucketString;
+			for (int32 i = 0; i < NumBuckets; ++i)
+			{
+				if (i < NumBuckets - 1)
+				{
+					BucketString += FString::Printf(TEXT(" <%dms:%d"), 1 << i, Buckets[i]);
+				}
+				else
+				{
+					BucketString += FString::Printf(TEXT(" more:%d"), Buckets[i]);
+				}
+			}
+
+			UE_LOG(LogTemp, Log, TEXT("%s: %d samples, mean %.2fms, p50 <%.0fms, p95 <%.0fms, max %.2fms"), Name, Count, Total / Count, GetPercentile(0.5f), GetPercentile(0.95f), Max);
+			UE_LOG(LogTemp, Log, TEXT("   %s"), *BucketString);
+		}
+	};
+}
+
+bool FWeaponLatencyTracer::IsEnabled()
+{
+	return CVarWeaponLatencyTraceEnabled.GetValueOnAnyThread() != 0;
+}
+
+void FWeaponLatencyTracer::RecordStage(const uint32 TraceId, const EWeaponTraceStage Stage, const float ServerTime /*= 0.f*/)
+{
+	if (!IsEnabled())
+	{
+		return;
+	}
+
+	using namespace WeaponLatencyTracer;
+
+	FThreadBuffer& Buffer = GetThreadBuffer();
+	const uint32 EventIndex = Buffer.NumWritten.Load(EMemoryOrder::Relaxed);
+
+	FTraceEvent& Event = Buffer.Events[EventIndex % FThreadBuffer::Capacity];
+	Event.Time = FPlatformTime::Seconds();
+	Event.TraceId = TraceId;
+	Event.ServerTime = ServerTime;
+	Event.Stage = Stage;
+
+	Buffer.NumWritten.Store(EventIndex + 1);
+
+#if UE_TRACE_ENABLED
+	UE_TRACE_LOG(WeaponLatency, ShotStage, WeaponLatencyChannel)
+		<< ShotStage.Cycle(FPlatformTime::Cycles64())
+		<< ShotStage.TraceId(TraceId)
+		<< ShotStage.Stage((uint8)Stage)
+		<< ShotStage.ServerTime(ServerTime);
+#endif
+}
+
+void FWeaponLatencyTracer::DumpHistograms()
+{
+	using namespace WeaponLatencyTracer;
+
+	TArray<FTraceEvent> Events;
+
+	{
+		FScopeLock Lock(&BuffersLock);
+
+		for (const TUniquePtr<FThreadBuffer>& Buffer : Buffers)
+		{
+			//Events being overwritten while we copy them can be torn.  That only skews a sample or two, which is fine for a summary
+			const uint32 NumWritten = Buffer->NumWritten.Load();
+			const uint32 FirstEvent = FMath::Max(Buffer->FirstUnread, NumWritten > FThreadBuffer::Capacity ? NumWritten - FThreadBuffer::Capacity : 0u);
+
+			for (uint32 i = FirstEvent; i < NumWritten; ++i)
+			{
+				Events.Add(Buffer->Events[i % FThreadBuffer::Capacity]);
+			}
+		}
+	}
+
+	//Put every shots stages together, in the order they happened
+	Events.Sort([](const FTraceEvent& A, const FTraceEvent& B)
+	{
+		return A.TraceId != B.TraceId ? A.TraceId < B.TraceId : A.Time < B.Time;
+	});
+
+	FHistogram InputToShot;
+	FHistogram ShotToConfirm;
+	FHistogram ServerReceiveToDamage;
+	FHistogram ServerProcessing;
+	FHistogram Network;
+
+	int32 FirstEvent = 0;
+	for (int32 i = 1; i <= Events.Num(); ++i)
+	{
+		if (i < Events.Num() && Events[i].TraceId == Events[FirstEvent].TraceId)
+		{
+			continue;
+		}
+
+		//The first time we saw each stage of this shot
+		const FTraceEvent* Stages[(uint8)EWeaponTraceStage::MAX] = {};
+
+		for (int32 j = FirstEvent; j < i; ++j)
+		{
+			const FTraceEvent*& StageEvent = Stages[(uint8)Events[j].Stage];
+			StageEvent = StageEvent ? StageEvent : &Events[j];
+		}
+
+		const FTraceEvent* StartFire = Stages[(uint8)EWeaponTraceStage::StartFire];
+		const FTraceEvent* FireShot = Stages[(uint8)EWeaponTraceStage::FireShot];
+		const FTraceEvent* ServerHandleHit = Stages[(uint8)EWeaponTraceStage::ServerHandleHit];
+		const FTraceEvent* ApplyDamage = Stages[(uint8)EWeaponTraceStage::ApplyDamage];
+		const FTraceEvent* HitConfirm = Stages[(uint8)EWeaponTraceStage::HitConfirm];
+
+		if (StartFire && FireShot)
+		{
+			InputToShot.Add(FireShot->Time - StartFire->Time);
+		}
+
+		if (ServerHandleHit && ApplyDamage)
+		{
+			ServerReceiveToDamage.Add(ApplyDamage->Time - ServerHandleHit->Time);
+		}
+
+		if (FireShot && HitConfirm)
+		{
+			const double RoundTrip = HitConfirm->Time - FireShot->Time;
+
+			ShotToConfirm.Add(RoundTrip);
+			ServerProcessing.Add(HitConfirm->ServerTime);
+			Network.Add(RoundTrip - HitConfirm->ServerTime);
+		}
+
+		FirstEvent = i;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Weapon latency, %d stages recorded"), Events.Num());
+	InputToShot.Log(TEXT("Input to shot (frame time)"));
+	ShotToConfirm.Log(TEXT("Shot to hit confirm (round trip)"));
+	Network.Log(TEXT("  of which network and queueing"));
+	ServerProcessing.Log(TEXT("  of which server processing"));
+	ServerReceiveToDamage.Log(TEXT("Server hit to damage applied"));
+}
+
+void FWeaponLatencyTracer::Reset()
+{
+	using namespace WeaponLatencyTracer;
+
+	FScopeLock Lock(&BuffersLock);
+
+	for (const TUniquePtr<FThreadBuffer>& Buffer : Buffers)
+	{
+		Buffer->FirstUnread = Buffer->NumWritten.Load();
+	}
+}
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//The points in a shots life we timestamp, from the trigger being pulled to the owner seeing the hit marker
+enum class EWeaponTraceStage : uint8
+{
+	//[owning client] the trigger was pulled, traced with the id of the shot it will fire
+	StartFire,
+	//[owning client] the shot was fired and traced
+	FireShot,
+	//[server] the hit from the shot arrived
+	ServerHandleHit,
+	//[server] the damage queue applied the hit
+	ApplyDamage,
+	//[owning client] the server confirmed the hit did damage
+	HitConfirm,
+	MAX
+};
+
+/**
+ * Traces shots through the fire and hit path so we can see where their latency goes.  Every shot gets a trace id, which is
+ * sent along with its hit so each machine can timestamp the stages it sees.  Timestamps are written to per thread ring
+ * buffers without locking, and summarised into histograms by Weapon.LatencyTrace.Dump.  With the WeaponLatency trace
+ * channel enabled they also go to Unreal Insights.
+ *
+ * Enable with Weapon.LatencyTrace.Enabled 1.
+ */
+class SURVIVALGAME_API FWeaponLatencyTracer
+{
+public:
+
+	/* Make a trace id unique to a shot from a weapon.  Ids are only unique on the machine that made them */
+	static FORCEINLINE uint32 MakeTraceId(const UObject* Weapon, const uint16 ShotId) { return ((Weapon->GetUniqueID() & 0xFFFF) << 16) | ShotId; }
+
+	static bool IsEnabled();
+
+	/* Timestamp a stage of a shot.  ServerTime is how long the server spent on the shot, which only the hit confirm knows */
+	static void RecordStage(const uint32 TraceId, const EWeaponTraceStage Stage, const float ServerTime = 0.f);
+
+	/* Log histograms of the time spent between stages of every shot recorded since the last reset */
+	static void DumpHistograms();
+
+	/* Forget every shot recorded so far */
+	static void Reset();
+};
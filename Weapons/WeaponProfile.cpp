@@ -0,0 +1,166 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WeaponProfile.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "Curves/CurveVector.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
+
+#if WITH_EDITOR
+#include "Editor.h"
+#endif
+
+TSharedRef<const FWeaponProfile> FWeaponProfile::Create(const AWeapon* Weapon)
+{
+	check(Weapon);
+
+	//Always compile from the class defaults so every instance of a class ends up with identical tuning
+	return MakeShareable(new FWeaponProfile(Weapon->GetClass()->GetDefaultObject<AWeapon>()));
+}
+
+FWeaponProfile::FWeaponProfile(const AWeapon* Weapon)
+	: WeaponConfig(Weapon->WeaponConfig)
+	, HitScanConfig(Weapon->HitScanConfig)
+	, RecoilSpeed(Weapon->RecoilSpeed)
+	, RecoilResetSpeed(Weapon->RecoilResetSpeed)
+	, bAllowAutomaticCatchup(Weapon->bAllowAutomaticCatchup)
+	, bHasRecoil(Weapon->RecoilCurve != nullptr)
+{
+	for (int32 i = 0; i < RecoilTableSize; ++i)
+	{
+		if (bHasRecoil)
+		{
+			const FVector RecoilSample = Weapon->RecoilCurve->GetVectorValue((float)i / (RecoilTableSize - 1));
+			RecoilTable[i] = FVector2D(RecoilSample.X, RecoilSample.Y);
+		}
+		else
+		{
+			RecoilTable[i] = FVector2D::ZeroVector;
+		}
+	}
+}
+
+float FWeaponProfile::GetBoneDamageMultiplier(const USkinnedMeshComponent* HitMesh, const FName& HitBone) const
+{
+	if (HitBone != NAME_None)
+	{
+		for (const TPair<FName, float>& BoneDamageModifier : HitScanConfig.BoneDamageModifiers)
+		{
+			if (BoneDamageModifier.Key == HitBone || (HitMesh && HitMesh->BoneIsChildOf(HitBone, BoneDamageModifier.Key)))
+			{
+				return BoneDamageModifier.Value;
+			}
+		}
+	}
+
+	return 1.f;
+}
+
+FVector2D FWeaponProfile::GetRecoil(const int32 Seed, const int32 ShotIndex) const
+{
+	//X and Y are picked separately, the same way the recoil curve used to be sampled at two random points
+	const uint32 ShotHash = HashCombine(GetTypeHash(Seed), GetTypeHash(ShotIndex));
+	const int32 XIndex = ShotHash % RecoilTableSize;
+	const int32 YIndex = (ShotHash / RecoilTableSize) % RecoilTableSize;
+
+	return FVector2D(RecoilTable[XIndex].X, RecoilTable[YIndex].Y);
+}
+
+FVector FWeaponProfile::GetShotDirection(const int32 Seed, const int32 ShotIndex, const FVector& AimDirection) const
+{
+	if (HitScanConfig.Spread <= 0.f)
+	{
+		return AimDirection;
+	}
+
+	//A stream per shot rather than one advancing stream, so a shot the server never heard about doesn't throw off the ones after it
+	const FRandomStream ShotStream(HashCombine(GetTypeHash(Seed), GetTypeHash(ShotIndex)));
+	return ShotStream.VRandCone(AimDirection, FMath::DegreesToRadians(HitScanConfig.Spread));
+}
+
+float FWeaponProfile::GetShotsPerSecond() const
+{
+	//Weapons without a fire rate are limited to 10 shots a second
+	return WeaponConfig.TimeBetweenShots > 0.f ? 1.f / WeaponConfig.TimeBetweenShots : 10.f;
+}
+
+float FWeaponProfile::GetRefireAdjustment(const float TimeSinceLastShot) const
+{
+	if (!bAllowAutomaticCatchup)
+	{
+		return 0.f;
+	}
+
+	const float SlackTimeThisFrame = FMath::Max(0.0f, TimeSinceLastShot - WeaponConfig.TimeBetweenShots);
+	return -SlackTimeThisFrame;
+}
+
+float FWeaponProfile::GetRefireDelay(const float TimerIntervalAdjustment) const
+{
+	return FMath::Max<float>(WeaponConfig.TimeBetweenShots + TimerIntervalAdjustment, SMALL_NUMBER);
+}
+
+void UWeaponProfileSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	//Blueprint reinstancing and hot reload replace classes and their defaults, which our profiles were compiled from
+	ObjectsReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddUObject(this, &UWeaponProfileSubsystem::OnObjectsReplaced);
+
+#if WITH_EDITOR
+	if (GEditor)
+	{
+		BlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddUObject(this, &UWeaponProfileSubsystem::FlushProfiles);
+	}
+#endif
+}
+
+void UWeaponProfileSubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::OnObjectsReplaced.Remove(ObjectsReplacedHandle);
+
+#if WITH_EDITOR
+	if (GEditor)
+	{
+		GEditor->OnBlueprintCompiled().Remove(BlueprintCompiledHandle);
+	}
+#endif
+
+	Profiles.Empty();
+
+	Super::Deinitialize();
+}
+
+TSharedRef<const FWeaponProfile> UWeaponProfileSubsystem::GetProfile(const AWeapon* Weapon)
+{
+	check(Weapon);
+
+	const UWorld* World = Weapon->GetWorld();
+	UWeaponProfileSubsystem* ProfileSubsystem = (World && World->GetGameInstance()) ? World->GetGameInstance()->GetSubsystem<UWeaponProfileSubsystem>() : nullptr;
+
+	//Without a game instance (i.e. editor preview worlds) there is nothing to share with, so just compile a profile for this weapon
+	if (!ProfileSubsystem)
+	{
+		return FWeaponProfile::Create(Weapon);
+	}
+
+	if (const TSharedRef<const FWeaponProfile>* ExistingProfile = ProfileSubsystem->Profiles.Find(Weapon->GetClass()))
+	{
+		return *ExistingProfile;
+	}
+
+	return ProfileSubsystem->Profiles.Add(Weapon->GetClass(), FWeaponProfile::Create(Weapon));
+}
+
+void UWeaponProfileSubsystem::FlushProfiles()
+{
+	//Weapons keep the profile they already have until they ask again
+	Profiles.Empty();
+}
+
+void UWeaponProfileSubsystem::OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacedObjects)
+{
+	FlushProfiles();
+}
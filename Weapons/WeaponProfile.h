@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Weapon.h"
+#include "WeaponProfile.generated.h"
+
+class USkinnedMeshComponent;
+
+/**
+ * The tuning for a weapon class, compiled once from the class defaults and shared (read only) by every weapon of that class.
+ * The recoil curve is baked into a fixed size table so recoil can be looked up from a seed and a shot index, making it
+ * reproducible on the server.
+ */
+struct SURVIVALGAME_API FWeaponProfile
+{
+public:
+
+	//The number of samples we bake the recoil curve into
+	static constexpr int32 RecoilTableSize = 64;
+
+	/* Compile a new profile from a weapon.  Use UWeaponProfileSubsystem::GetProfile() instead, which shares profiles between instances. */
+	static TSharedRef<const FWeaponProfile> Create(const AWeapon* Weapon);
+
+	const FWeaponData WeaponConfig;
+	const FHitScanConfiguration HitScanConfig;
+	const float RecoilSpeed;
+	const float RecoilResetSpeed;
+	const bool bAllowAutomaticCatchup;
+
+	/* The damage multiplier for hitting a bone, taken from the first modifier that is the bone or one of its parents */
+	float GetBoneDamageMultiplier(const USkinnedMeshComponent* HitMesh, const FName& HitBone) const;
+
+	/* The recoil to apply for a shot.  The same seed and shot index always give the same recoil */
+	FVector2D GetRecoil(const int32 Seed, const int32 ShotIndex) const;
+
+	/* The direction a shot aimed along AimDirection goes in, after spread.  The same seed and shot index always give the same spread */
+	FVector GetShotDirection(const int32 Seed, const int32 ShotIndex, const FVector& AimDirection) const;
+
+	FORCEINLINE bool HasRecoil() const { return bHasRecoil; }
+
+	/* The most shots a second the weapon can fire */
+	float GetShotsPerSecond() const;
+
+	/* How much to shorten the refire timer by, for a refire that came TimeSinceLastShot after the last shot.  With automatic
+	catchup, the time lost to timers only firing once a frame is made up on the next shot */
+	float GetRefireAdjustment(const float TimeSinceLastShot) const;
+
+	/* The delay of the refire timer, after the adjustments built up since the last shot */
+	float GetRefireDelay(const float TimerIntervalAdjustment) const;
+
+private:
+
+	explicit FWeaponProfile(const AWeapon* Weapon);
+
+	FVector2D RecoilTable[RecoilTableSize];
+	bool bHasRecoil;
+};
+
+/**
+ * Caches the compiled profile of every weapon class used by the game instance.
+ */
+UCLASS()
+class SURVIVALGAME_API UWeaponProfileSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/* Get the shared profile for a weapons class, compiling it from the class defaults the first time the class is used */
+	static TSharedRef<const FWeaponProfile> GetProfile(const AWeapon* Weapon);
+
+private:
+
+	/* Drop every profile, so they are compiled again from the new class defaults.  Called when classes are recompiled or replaced */
+	void FlushProfiles();
+	void OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacedObjects);
+
+	//Weak so a class that is unloaded or garbage collected doesn't keep a dangling key
+	TMap<TWeakObjectPtr<const UClass>, TSharedRef<const FWeaponProfile>> Profiles;
+
+	FDelegateHandle ObjectsReplacedHandle;
+	FDelegateHandle BlueprintCompiledHandle;
+};
@@ -1,22 +1,22 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "Blueprint/UserWidget.h"
-#include "InventoryItemWidget.generated.h"
-
-/**
- * 
- */
-UCLASS()
-class SURVIVALGAME_API UInventoryItemWidget : public UUserWidget
-{
-	GENERATED_BODY()
-
-public:
-
-	UPROPERTY(BlueprintReadOnly, Category = "Inventory Item Widget", meta = (ExposeOnSpawn = true))
-	class UItem* Item;
-	
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "InventoryItemWidget.generated.h"
+
+/**
+ * 
+ */
+UCLASS()
+class SURVIVALGAME_API UInventoryItemWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintReadOnly, Category = "Inventory Item Widget", meta = (ExposeOnSpawn = true))
+	class UItem* Item;
+	
+};
@@ -1,159 +1,159 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "PickUp.h"
-#include "../Items/Item.h"
-#include "Net/UnrealNetwork.h"
-#include "../Player/SurvivalCharacter.h"
-#include "Components/StaticMeshComponent.h"
-#include "../Components/InteractionComponent.h"
-#include "../Components/InventoryComponent.h"
-#include "Engine/ActorChannel.h"
-
-// Sets default values
-APickUp::APickUp()
-{
-	PickupMesh = CreateDefaultSubobject<UStaticMeshComponent>("PickupMesh");
-	PickupMesh->SetCollisionResponseToChannel(ECC_Pawn, ECR_Ignore);
-
-	SetRootComponent(PickupMesh);
-
-	InteractionComponent = CreateDefaultSubobject<UInteractionComponent>("PickupInteractionComponent");
-	InteractionComponent->InteractionTime = 0.5f;
-	InteractionComponent->InteractionDistance = 200.0f;
-	InteractionComponent->InteractableNameText = FText::FromString("Pickup");
-	InteractionComponent->InteractableActionText = FText::FromString("Take");
-	InteractionComponent->OnInteract.AddDynamic(this, &APickUp::OnTakePickup);
-	InteractionComponent->SetupAttachment(PickupMesh);
-
-	SetReplicates(true);
-}
-
-void APickUp::InitializePickup(const TSubclassOf<class UItem> ItemClass, const int32 Quantity)
-{
-	UE_LOG(LogTemp, Warning, TEXT("Pickup dropped with %d quantity"), Quantity);
-
-	if (HasAuthority() && ItemClass && Quantity > 0)
-	{
-		//UE_LOG(LogTemp, Warning, TEXT("Pickup should be Initialized"));
-		Item = NewObject<UItem>(this, ItemClass);
-		Item->SetQuantity(Quantity);
-
-		OnRep_Item();
-		Item->MarkDirtyForReplication();
-	}
-}
-
-void APickUp::OnRep_Item()
-{
-	if (Item)
-	{
-		PickupMesh->SetStaticMesh(Item->PickupMesh);
-		InteractionComponent->InteractableNameText = Item->ItemDisplayName;
-
-		//Clients bind to this delegate in order to refresh the interaction widget if item quantity changes
-		Item->OnItemModified.AddDynamic(this, &APickUp::OnItemModified);
-	}
-
-	//If any replicated properties on the item are changed, we refresh the widget
-	InteractionComponent->RefreshWidget();
-}
-
-void APickUp::OnItemModified()
-{
-	if (InteractionComponent)
-	{
-		InteractionComponent->RefreshWidget();
-	}
-}
-
-// Called when the game starts or when spawned
-void APickUp::BeginPlay()
-{
-	Super::BeginPlay();
-	
-	if (HasAuthority() && ItemTemplate && bNetStartup)
-	{
-		InitializePickup(ItemTemplate->GetClass(), ItemTemplate->GetQuantity());
-	}
-
-	/*If pickup was spawned in at runtime, ensure that it matches the rotation of the ground that it was dropped on
-	If we dropped a pickup on a 20 degree slop, the pickup would also be spawned at a 20 degree angle*/
-	if (!bNetStartup)
-	{
-		AlignWithGround();
-	}
-
-	if (Item)
-	{
-		Item->MarkDirtyForReplication();
-	}
-}
-
-void APickUp::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
-{
-	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-
-	DOREPLIFETIME(APickUp, Item);
-}
-
-bool APickUp::ReplicateSubobjects(class UActorChannel* Channel, class FOutBunch* Bunch, FReplicationFlags* RepFlags)
-{
-	bool bWroteSomething = Super::ReplicateSubobjects(Channel, Bunch, RepFlags);
-
-	if (Item && Channel->KeyNeedsToReplicate(Item->GetUniqueID(), Item->RepKey))
-	{
-		bWroteSomething |= Channel->ReplicateSubobject(Item, *Bunch, *RepFlags);
-	}
-
-	return bWroteSomething;
-}
-
-#if WITH_EDITOR
-void APickUp::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
-{
-	Super::PostEditChangeProperty(PropertyChangedEvent);
-
-	FName PropertyName = (PropertyChangedEvent.Property != NULL) ? PropertyChangedEvent.Property->GetFName() : NAME_None;
-
-	//If a new pickup is selected in the property editor, change the mesh to reflect the new item being selected
-	if (PropertyName == GET_MEMBER_NAME_CHECKED(APickUp, ItemTemplate))
-	{
-		if (ItemTemplate)
-		{
-			PickupMesh->SetStaticMesh(ItemTemplate->PickupMesh);
-		}
-	}
-}
-#endif
-
-void APickUp::OnTakePickup(class ASurvivalCharacter* Taker)
-{
-	if (!Taker)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("Pickup was taken but player was not valid. "));
-		return;
-	}
-
-	//Not 100% sure Pending kill check is needed but should prevent player from taking a pickup another player has already tried taking
-	if (HasAuthority() && !IsPendingKillPending() && Item)
-	{
-		if (UInventoryComponent* PlayerInventory = Taker->PlayerInventory)
-		{
-			const FItemAddResult AddResult = PlayerInventory->TryAddItem(Item);
-
-			if (AddResult.ActualAmountGiven < Item->GetQuantity())
-			{
-				Item->SetQuantity(Item->GetQuantity() - AddResult.ActualAmountGiven);
-			}
-			else if (AddResult.ActualAmountGiven >= Item->GetQuantity())
-			{
-				Destroy();
-			}
-		}
-	}
-}
-
-
-
-
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PickUp.h"
+#include "../Items/Item.h"
+#include "Net/UnrealNetwork.h"
+#include "../Player/SurvivalCharacter.h"
+#include "Components/StaticMeshComponent.h"
+#include "../Components/InteractionComponent.h"
+#include "../Components/InventoryComponent.h"
+#include "Engine/ActorChannel.h"
+
+// Sets default values
+APickUp::APickUp()
+{
+	PickupMesh = CreateDefaultSubobject<UStaticMeshComponent>("PickupMesh");
+	PickupMesh->SetCollisionResponseToChannel(ECC_Pawn, ECR_Ignore);
+
+	SetRootComponent(PickupMesh);
+
+	InteractionComponent = CreateDefaultSubobject<UInteractionComponent>("PickupInteractionComponent");
+	InteractionComponent->InteractionTime = 0.5f;
+	InteractionComponent->InteractionDistance = 200.0f;
+	InteractionComponent->InteractableNameText = FText::FromString("Pickup");
+	InteractionComponent->InteractableActionText = FText::FromString("Take");
+	InteractionComponent->OnInteract.AddDynamic(this, &APickUp::OnTakePickup);
+	InteractionComponent->SetupAttachment(PickupMesh);
+
+	SetReplicates(true);
+}
+
+void APickUp::InitializePickup(const TSubclassOf<class UItem> ItemClass, const int32 Quantity)
+{
+	UE_LOG(LogTemp, Warning, TEXT("Pickup dropped with %d quantity"), Quantity);
+
+	if (HasAuthority() && ItemClass && Quantity > 0)
+	{
+		//UE_LOG(LogTemp, Warning, TEXT("Pickup should be Initialized"));
+		Item = NewObject<UItem>(this, ItemClass);
+		Item->SetQuantity(Quantity);
+
+		OnRep_Item();
+		Item->MarkDirtyForReplication();
+	}
+}
+
+void APickUp::OnRep_Item()
+{
+	if (Item)
+	{
+		PickupMesh->SetStaticMesh(Item->PickupMesh);
+		InteractionComponent->InteractableNameText = Item->ItemDisplayName;
+
+		//Clients bind to this delegate in order to refresh the interaction widget if item quantity changes
+		Item->OnItemModified.AddDynamic(this, &APickUp::OnItemModified);
+	}
+
+	//If any replicated properties on the item are changed, we refresh the widget
+	InteractionComponent->RefreshWidget();
+}
+
+void APickUp::OnItemModified()
+{
+	if (InteractionComponent)
+	{
+		InteractionComponent->RefreshWidget();
+	}
+}
+
+// Called when the game starts or when spawned
+void APickUp::BeginPlay()
+{
+	Super::BeginPlay();
+	
+	if (HasAuthority() && ItemTemplate && bNetStartup)
+	{
+		InitializePickup(ItemTemplate->GetClass(), ItemTemplate->GetQuantity());
+	}
+
+	/*If pickup was spawned in at runtime, ensure that it matches the rotation of the ground that it was dropped on
+	If we dropped a pickup on a 20 degree slop, the pickup would also be spawned at a 20 degree angle*/
+	if (!bNetStartup)
+	{
+		AlignWithGround();
+	}
+
+	if (Item)
+	{
+		Item->MarkDirtyForReplication();
+	}
+}
+
+void APickUp::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(APickUp, Item);
+}
+
+bool APickUp::ReplicateSubobjects(class UActorChannel* Channel, class FOutBunch* Bunch, FReplicationFlags* RepFlags)
+{
+	bool bWroteSomething = Super::ReplicateSubobjects(Channel, Bunch, RepFlags);
+
+	if (Item && Channel->KeyNeedsToReplicate(Item->GetUniqueID(), Item->RepKey))
+	{
+		bWroteSomething |= Channel->ReplicateSubobject(Item, *Bunch, *RepFlags);
+	}
+
+	return bWroteSomething;
+}
+
+#if WITH_EDITOR
+void APickUp::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	FName PropertyName = (PropertyChangedEvent.Property != NULL) ? PropertyChangedEvent.Property->GetFName() : NAME_None;
+
+	//If a new pickup is selected in the property editor, change the mesh to reflect the new item being selected
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(APickUp, ItemTemplate))
+	{
+		if (ItemTemplate)
+		{
+			PickupMesh->SetStaticMesh(ItemTemplate->PickupMesh);
+		}
+	}
+}
+#endif
+
+void APickUp::OnTakePickup(class ASurvivalCharacter* Taker)
+{
+	if (!Taker)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Pickup was taken but player was not valid. "));
+		return;
+	}
+
+	//Not 100% sure Pending kill check is needed but should prevent player from taking a pickup another player has already tried taking
+	if (HasAuthority() && !IsPendingKillPending() && Item)
+	{
+		if (UInventoryComponent* PlayerInventory = Taker->PlayerInventory)
+		{
+			const FItemAddResult AddResult = PlayerInventory->TryAddItem(Item);
+
+			if (AddResult.ActualAmountGiven < Item->GetQuantity())
+			{
+				Item->SetQuantity(Item->GetQuantity() - AddResult.ActualAmountGiven);
+			}
+			else if (AddResult.ActualAmountGiven >= Item->GetQuantity())
+			{
+				Destroy();
+			}
+		}
+	}
+}
+
+
+
+
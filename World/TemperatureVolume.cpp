@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TemperatureVolume.h"
+#include "../Components/SurvivalNeedsComponent.h"
+#include "Components/BrushComponent.h"
+
+ATemperatureVolume::ATemperatureVolume()
+{
+	GetBrushComponent()->SetCollisionProfileName(TEXT("Trigger"));
+	GetBrushComponent()->SetGenerateOverlapEvents(true);
+
+	Temperature = 50.f;
+}
+
+void ATemperatureVolume::NotifyActorBeginOverlap(AActor* OtherActor)
+{
+	Super::NotifyActorBeginOverlap(OtherActor);
+
+	if (HasAuthority() && OtherActor)
+	{
+		if (USurvivalNeedsComponent* Needs = OtherActor->FindComponentByClass<USurvivalNeedsComponent>())
+		{
+			Needs->SetEnvironmentTemperature(Temperature);
+		}
+	}
+}
+
+void ATemperatureVolume::NotifyActorEndOverlap(AActor* OtherActor)
+{
+	Super::NotifyActorEndOverlap(OtherActor);
+
+	if (!HasAuthority() || !OtherActor)
+	{
+		return;
+	}
+
+	USurvivalNeedsComponent* Needs = OtherActor->FindComponentByClass<USurvivalNeedsComponent>();
+
+	if (!Needs)
+	{
+		return;
+	}
+
+	//Go back to whatever other volume we're still in, or the ambient temperature if there isn't one
+	TArray<AActor*> OverlappingVolumes;
+	OtherActor->GetOverlappingActors(OverlappingVolumes, ATemperatureVolume::StaticClass());
+	OverlappingVolumes.Remove(this);
+
+	if (OverlappingVolumes.Num())
+	{
+		Needs->SetEnvironmentTemperature(CastChecked<ATemperatureVolume>(OverlappingVolumes.Last())->Temperature);
+	}
+	else
+	{
+		Needs->ResetEnvironmentTemperature();
+	}
+}
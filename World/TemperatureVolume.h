@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Volume.h"
+#include "TemperatureVolume.generated.h"
+
+/**
+ * Warms or cools the characters inside it, i.e. a campfire, a snowy peak or a desert.  Characters outside every temperature
+ * volume are exposed to Survival.Needs.AmbientTemperature.  Where volumes overlap, the one entered last wins.
+ */
+UCLASS()
+class SURVIVALGAME_API ATemperatureVolume : public AVolume
+{
+	GENERATED_BODY()
+
+public:
+
+	ATemperatureVolume();
+
+	virtual void NotifyActorBeginOverlap(AActor* OtherActor) override;
+	virtual void NotifyActorEndOverlap(AActor* OtherActor) override;
+
+	//The temperature characters inside are exposed to.  50 is comfortable, 0 is freezing and 100 is overheating
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Temperature", meta = (ClampMin = 0, ClampMax = 100))
+	float Temperature;
+};